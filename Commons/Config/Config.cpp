@@ -55,6 +55,18 @@ bool Config::Load(const std::wstring& path)
     overlayPosition_ = GetPrivateProfileInt(L"Recording", L"overlayPosition", overlayPosition_, fileName.c_str());
     disableOverlayDuringCapture_ = ReadBoolFromIni(L"Recording", L"disableOverlayDuringCapture",
                                                    disableOverlayDuringCapture_, fileName.c_str());
+    overlayUpdateRate_ = GetPrivateProfileInt(L"Recording", L"overlayUpdateRate",
+                                              overlayUpdateRate_, fileName.c_str());
+    softwareOverlayRasterizer_ = ReadBoolFromIni(L"Recording", L"softwareOverlayRasterizer",
+                                                 softwareOverlayRasterizer_, fileName.c_str());
+    overlayCostBudget_ = GetPrivateProfileInt(L"Recording", L"overlayCostBudget",
+                                              overlayCostBudget_, fileName.c_str());
+    showOverlayCost_ = ReadBoolFromIni(L"Recording", L"showOverlayCost", showOverlayCost_,
+                                       fileName.c_str());
+    showFrameTimeLows_ = ReadBoolFromIni(L"Recording", L"showFrameTimeLows", showFrameTimeLows_,
+                                         fileName.c_str());
+    overlayGpuTimestamps_ = ReadBoolFromIni(L"Recording", L"overlayGpuTimestamps",
+                                            overlayGpuTimestamps_, fileName.c_str());
 
     g_messageLog.LogInfo("Config", "file loaded");
     return true;
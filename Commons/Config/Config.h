@@ -42,6 +42,18 @@ struct Config {
   bool recordAllProcesses_ = true;
   unsigned int overlayPosition_ = 2;
   bool disableOverlayDuringCapture_ = true;
+  // Rasterization rate of the overlay in Hz, 0 draws the overlay with every present
+  unsigned int overlayUpdateRate_ = 30;
+  // Draws the overlay with the CPU rasterizer instead of Direct2D
+  bool softwareOverlayRasterizer_ = false;
+  // Average overlay cost per present in microseconds before the overlay degrades, 0 disables it
+  unsigned int overlayCostBudget_ = 0;
+  // Shows the measured overlay cost below the frame statistics
+  bool showOverlayCost_ = false;
+  // Shows the 1% and 0.1% low FPS of the recent frames below the frame statistics
+  bool showFrameTimeLows_ = false;
+  // Measures the GPU time of the overlay pass with timestamp queries (Vulkan and D3D12)
+  bool overlayGpuTimestamps_ = false;
 
   float startDisplayTime_ = 1.0f;
   float endDisplayTime_ = 10.0f;
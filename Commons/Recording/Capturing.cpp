@@ -25,6 +25,7 @@
 #include <tlhelp32.h>
 #include <thread>
 #include "../Utility/Constants.h"
+#include "InputSampler.h"
 #include "OverlayThread.h"
 #include "../Logging/MessageLog.h"
 #include "../Utility/ProcessHelper.h"
@@ -36,6 +37,7 @@
 namespace GameOverlay {
   Config g_config;
   OverlayThread g_overlayThread;
+  InputSampler g_inputSampler;
 
 #if _WIN64
   const std::wstring g_overlayLibName = L"GameOverlay64.dll";
@@ -57,6 +59,13 @@ namespace GameOverlay {
       RecordingState::GetInstance().SetDisplayTimes(g_config.startDisplayTime_,
         g_config.endDisplayTime_);
       RecordingState::GetInstance().SetRecordingTime(static_cast<float>(g_config.recordingTime_));
+      RecordingState::GetInstance().SetOverlayUpdateRate(g_config.overlayUpdateRate_);
+      RecordingState::GetInstance().SetSoftwareOverlayRasterizer(
+        g_config.softwareOverlayRasterizer_);
+      RecordingState::GetInstance().SetOverlayCostBudget(g_config.overlayCostBudget_);
+      RecordingState::GetInstance().SetShowOverlayCost(g_config.showOverlayCost_);
+      RecordingState::GetInstance().SetShowFrameTimeLows(g_config.showFrameTimeLows_);
+      RecordingState::GetInstance().SetOverlayGpuTimestamps(g_config.overlayGpuTimestamps_);
       const auto overlayPosition = GetOverlayPositionFromUint(g_config.overlayPosition_);
       RecordingState::GetInstance().SetOverlayPosition(overlayPosition);
       if (g_config.disableOverlayDuringCapture_)
@@ -67,6 +76,7 @@ namespace GameOverlay {
 		RecordingState::GetInstance().ShowOverlayDuringCapture();
 	  }
       g_overlayThread.Start();
+      g_inputSampler.Start();
       initialized = true;
     }
   }
@@ -0,0 +1,98 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "FrameTimeHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace GameOverlay {
+// the buckets cover 0.05 ms to 3.2 s
+const double FrameTimeHistogram::minFrameTime_ = 0.05;
+
+FrameTimeHistogram::FrameTimeHistogram(std::size_t windowSize)
+{
+  window_.reserve(windowSize);
+}
+
+void FrameTimeHistogram::Add(double frameTime)
+{
+  const int bucket = GetBucket(frameTime);
+  counts_[bucket]++;
+
+  if (window_.capacity() == 0) {
+    count_++;
+    return;
+  }
+
+  if (window_.size() < window_.capacity()) {
+    window_.push_back(static_cast<std::uint16_t>(bucket));
+    count_++;
+    return;
+  }
+
+  counts_[window_[windowPosition_]]--;
+  window_[windowPosition_] = static_cast<std::uint16_t>(bucket);
+  windowPosition_ = (windowPosition_ + 1) % window_.size();
+}
+
+void FrameTimeHistogram::Clear()
+{
+  std::fill(std::begin(counts_), std::end(counts_), 0);
+  count_ = 0;
+  window_.clear();
+  windowPosition_ = 0;
+}
+
+std::uint32_t FrameTimeHistogram::GetCount() const { return count_; }
+
+double FrameTimeHistogram::GetPercentile(double percentile) const
+{
+  if (count_ == 0) {
+    return 0.0;
+  }
+
+  const auto rank = std::max(static_cast<std::uint32_t>(std::ceil(percentile * count_)), 1u);
+  std::uint32_t frames = 0;
+  for (int i = 0; i < bucketCount_; i++) {
+    frames += counts_[i];
+    if (frames >= rank) {
+      return GetBucketCenter(i);
+    }
+  }
+  return GetBucketCenter(bucketCount_ - 1);
+}
+
+int FrameTimeHistogram::GetBucket(double frameTime)
+{
+  if (!(frameTime > minFrameTime_)) {
+    return 0;
+  }
+  const auto bucket = static_cast<int>(std::log2(frameTime / minFrameTime_) * bucketsPerOctave_);
+  return std::min(bucket, bucketCount_ - 1);
+}
+
+double FrameTimeHistogram::GetBucketCenter(int bucket)
+{
+  return minFrameTime_ * std::exp2((bucket + 0.5) / bucketsPerOctave_);
+}
+}
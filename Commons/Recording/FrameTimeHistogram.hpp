@@ -0,0 +1,59 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GameOverlay {
+// Fixed-memory histogram of frame times with logarithmic buckets, percentiles are accurate to
+// the bucket width of about 2%. With a window size only the most recent frames are counted,
+// the oldest frame is removed whenever a new one arrives.
+class FrameTimeHistogram {
+ public:
+  // A window size of 0 counts all frames since the last Clear.
+  explicit FrameTimeHistogram(std::size_t windowSize = 0);
+
+  void Add(double frameTime);
+  void Clear();
+  std::uint32_t GetCount() const;
+  // Frame time in ms that the given fraction of the counted frames does not exceed,
+  // 0 without frames.
+  double GetPercentile(double percentile) const;
+
+ private:
+  static int GetBucket(double frameTime);
+  static double GetBucketCenter(int bucket);
+
+  static const int bucketsPerOctave_ = 32;
+  static const int bucketCount_ = bucketsPerOctave_ * 16;
+  static const double minFrameTime_;
+
+  std::uint32_t counts_[bucketCount_] = {};
+  std::uint32_t count_ = 0;
+  // bucket of each frame in the window, the oldest one at windowPosition_ once it is full
+  std::vector<std::uint16_t> window_;
+  std::size_t windowPosition_ = 0;
+};
+}
@@ -0,0 +1,117 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "InputSampler.h"
+
+#include <string>
+#include "../Logging/MessageLog.h"
+#include "RecordingState.h"
+
+// Windows 10 1803 and later, older SDKs do not define it.
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace GameOverlay {
+const std::chrono::milliseconds InputSampler::pollInterval_{4};
+
+InputSampler::~InputSampler() { Stop(); }
+
+void InputSampler::Start()
+{
+  if (samplerThread_.joinable()) {
+    return;
+  }
+
+  LARGE_INTEGER frequency;
+  QueryPerformanceFrequency(&frequency);
+  frequency_ = frequency.QuadPart;
+
+  quit_ = false;
+  samplerThread_ = std::thread(&InputSampler::ThreadProc, this);
+}
+
+void InputSampler::Stop()
+{
+  quit_ = true;
+  if (samplerThread_.joinable()) {
+    samplerThread_.join();
+  }
+}
+
+bool InputSampler::GetLagIndicatorState()
+{
+  const bool keyDown = lagIndicatorKeyDown_.load(std::memory_order_acquire);
+  if (presentedLagIndicatorState_.exchange(keyDown, std::memory_order_relaxed) != keyDown) {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    const auto ticks = now.QuadPart - lagIndicatorTransitionTime_.load(std::memory_order_relaxed);
+    const double milliSeconds = static_cast<double>(ticks) * 1000.0 / frequency_;
+    g_messageLog.LogVerbose("InputSampler", std::string("Lag indicator ") +
+                                                (keyDown ? "press" : "release") +
+                                                " presented after " +
+                                                std::to_string(milliSeconds) + " ms");
+  }
+  return keyDown;
+}
+
+void InputSampler::ThreadProc()
+{
+  // Regular timers wait for the next system timer tick, 15.6 ms by default. The high resolution
+  // timer is not available before Windows 10 1803, key transitions are timestamped later there.
+  HANDLE timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                        TIMER_ALL_ACCESS);
+  if (!timer) {
+    timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+  }
+
+  // relative due time in 100 ns units, then periodic
+  using TimerTicks = std::chrono::duration<LONGLONG, std::ratio<1, 10000000>>;
+  LARGE_INTEGER dueTime;
+  dueTime.QuadPart = -std::chrono::duration_cast<TimerTicks>(pollInterval_).count();
+  const bool periodic =
+      timer && SetWaitableTimer(timer, &dueTime, static_cast<LONG>(pollInterval_.count()),
+                                nullptr, nullptr, FALSE);
+
+  while (!quit_) {
+    // the hotkey can be changed by the frontend at any time
+    const int hotkey = RecordingState::GetInstance().GetLagIndicatorHotkey();
+    const bool keyDown = hotkey >= 0 && (GetAsyncKeyState(hotkey) & 0x8000) != 0;
+    if (keyDown != lagIndicatorKeyDown_.load(std::memory_order_relaxed)) {
+      LARGE_INTEGER now;
+      QueryPerformanceCounter(&now);
+      lagIndicatorTransitionTime_.store(now.QuadPart, std::memory_order_relaxed);
+      lagIndicatorKeyDown_.store(keyDown, std::memory_order_release);
+    }
+    if (periodic) {
+      WaitForSingleObject(timer, INFINITE);
+    }
+    else {
+      std::this_thread::sleep_for(pollInterval_);
+    }
+  }
+
+  if (timer) {
+    CloseHandle(timer);
+  }
+}
+}  // namespace GameOverlay
@@ -0,0 +1,62 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace GameOverlay {
+// Samples the overlay hotkeys on its own thread, so the present hooks read the key state
+// without a lock or a GetAsyncKeyState call per present.
+class InputSampler {
+ public:
+  ~InputSampler();
+
+  void Start();
+  void Stop();
+
+  // Lock-free, may be called from any present thread. Logs the delay from a key transition
+  // to the first present which shows it.
+  bool GetLagIndicatorState();
+
+ private:
+  void ThreadProc();
+
+  // Key transitions are timestamped with at most this delay, or one system timer tick before
+  // Windows 10 1803.
+  static const std::chrono::milliseconds pollInterval_;
+
+  std::thread samplerThread_;
+  std::atomic<bool> quit_{false};
+
+  std::atomic<bool> lagIndicatorKeyDown_{false};
+  // QueryPerformanceCounter time of the last press or release of the lag indicator hotkey
+  std::atomic<LONGLONG> lagIndicatorTransitionTime_{0};
+  std::atomic<bool> presentedLagIndicatorState_{false};
+  LONGLONG frequency_ = 1;
+};
+
+extern InputSampler g_inputSampler;
+}
@@ -25,6 +25,7 @@
 #include "../Overlay/OverlayMessage.h"
 #include "../Utility/Constants.h"
 #include "../Utility/ProcessHelper.h"
+#include "InputSampler.h"
 #include "RecordingState.h"
 
 namespace GameOverlay {
@@ -147,6 +148,7 @@ void OverlayThread::DisableOverlay()
   RecordingState::GetInstance().HideGraphOverlay();
   RecordingState::GetInstance().HideBarOverlay();
   RecordingState::GetInstance().HideLagIndicatorOverlay();
+  g_inputSampler.Stop();
   FreeLibraryAndExitThread(dll, 0);
 }
 
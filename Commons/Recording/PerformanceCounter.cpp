@@ -22,11 +22,8 @@
 
 #include "PerformanceCounter.hpp"
 
-#include "../Logging/MessageLog.h"
-
-#include <algorithm>
-
-constexpr float percentile = 0.99f;
+constexpr double percentile = 0.99;
+constexpr double lowPercentile = 0.999;
 
 namespace GameOverlay {
 using Clock = std::chrono::high_resolution_clock;
@@ -34,8 +31,9 @@ using MilliSeconds = std::chrono::duration<double, std::milli>;
 using Seconds = std::chrono::duration<double>;
 
 const MilliSeconds PerformanceCounter::refreshRate_{1000.0};
+const std::size_t PerformanceCounter::recentFrameCount_ = 4096;
 
-PerformanceCounter::PerformanceCounter() : frameTimes_(1024)
+PerformanceCounter::PerformanceCounter() : recentFrameTimes_(recentFrameCount_)
 {
   lastFrame_ = Clock::now();
   recordingStart_ = Clock::now();
@@ -44,10 +42,15 @@ PerformanceCounter::PerformanceCounter() : frameTimes_(1024)
 
 const PerformanceCounter::FrameInfo& PerformanceCounter::NextFrame()
 {
-  const auto currFrame = Clock::now();
+  return NextFrame(Clock::now());
+}
+
+const PerformanceCounter::FrameInfo& PerformanceCounter::NextFrame(Clock::time_point currFrame)
+{
   const MilliSeconds frameDelta = currFrame - lastFrame_;
   deltaTime_ += frameDelta;
-  frameTimes_.push_back(static_cast<float>(frameDelta.count()));
+  recentFrameTimes_.Add(frameDelta.count());
+  captureFrameTimes_.Add(frameDelta.count());
   currentFrameInfo_.frameTime = static_cast<float>(frameDelta.count());
 
   currentFrameCount_++;
@@ -55,6 +58,7 @@ const PerformanceCounter::FrameInfo& PerformanceCounter::NextFrame()
   if (deltaTime_ >= refreshRate_) {
     currentFrameInfo_.fps = static_cast<int32_t>(currentFrameCount_);
     currentFrameInfo_.ms = static_cast<float>(deltaTime_.count() / currentFrameCount_);
+    UpdateLows();
 
     currentFrameCount_ = 0;
     deltaTime_ -= refreshRate_;
@@ -65,6 +69,27 @@ const PerformanceCounter::FrameInfo& PerformanceCounter::NextFrame()
   return currentFrameInfo_;
 }
 
+void PerformanceCounter::UpdateLows()
+{
+  // a percentile needs at least one frame beyond it, 100 frames for the 1% low
+  const auto frameCount = recentFrameTimes_.GetCount();
+  const auto toFPS = [](double frameTime) { return static_cast<float>(1000.0 / frameTime); };
+
+  currentFrameInfo_.frameTimePercentile = 0.0f;
+  currentFrameInfo_.onePercentLowFPS = 0.0f;
+  if (frameCount >= 100) {
+    const auto frameTime = recentFrameTimes_.GetPercentile(percentile);
+    currentFrameInfo_.frameTimePercentile = static_cast<float>(frameTime);
+    currentFrameInfo_.onePercentLowFPS = toFPS(frameTime);
+  }
+
+  currentFrameInfo_.pointOnePercentLowFPS = 0.0f;
+  if (frameCount >= 1000) {
+    currentFrameInfo_.pointOnePercentLowFPS =
+        toFPS(recentFrameTimes_.GetPercentile(lowPercentile));
+  }
+}
+
 const PerformanceCounter::CaptureResults& PerformanceCounter::GetLastCaptureResults() const
 {
   return prevCaptureResults_;
@@ -74,7 +99,7 @@ void PerformanceCounter::Start()
 {
   recordingStart_ = Clock::now();
   totalFrameCount_ = 0;
-  frameTimes_.clear();
+  captureFrameTimes_.Clear();
 }
 
 void PerformanceCounter::Stop()
@@ -84,8 +109,7 @@ void PerformanceCounter::Stop()
       static_cast<float>(totalFrameCount_ / (durationMS.count() / 1000.0f));
   prevCaptureResults_.averageMS = static_cast<float>(durationMS.count() / totalFrameCount_);
 
-  std::sort(frameTimes_.begin(), frameTimes_.end(), std::less<double>());
-  const auto rank = static_cast<int>(percentile * frameTimes_.size());
-  prevCaptureResults_.frameTimePercentile = static_cast<float>(frameTimes_[rank]);
+  prevCaptureResults_.frameTimePercentile =
+      static_cast<float>(captureFrameTimes_.GetPercentile(percentile));
 }
 }
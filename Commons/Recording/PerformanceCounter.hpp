@@ -24,7 +24,8 @@
 
 #include <chrono>
 #include <cstdint>
-#include <vector>
+
+#include "FrameTimeHistogram.hpp"
 
 namespace GameOverlay {
 class PerformanceCounter {
@@ -33,6 +34,11 @@ class PerformanceCounter {
     std::int32_t fps = 0;
     float ms = 0.0f;
     float frameTime = 0.0f;
+    // Lows of the recent frames, refreshed together with fps. 0 while the window holds too
+    // few frames for the percentile.
+    float onePercentLowFPS = 0.0f;
+    float pointOnePercentLowFPS = 0.0f;
+    float frameTimePercentile = 0.0f;
   };
 
   struct CaptureResults {
@@ -44,12 +50,17 @@ class PerformanceCounter {
   PerformanceCounter();
 
   const FrameInfo& NextFrame();
+  // Presented at the given time instead of now.
+  const FrameInfo& NextFrame(std::chrono::high_resolution_clock::time_point currFrame);
   const CaptureResults& GetLastCaptureResults() const;
   void Start();
   void Stop();
 
  private:
+  void UpdateLows();
+
   const static std::chrono::duration<double, std::milli> refreshRate_;
+  const static std::size_t recentFrameCount_;
 
   std::chrono::high_resolution_clock::time_point lastFrame_;
   std::chrono::high_resolution_clock::time_point recordingStart_;
@@ -60,6 +71,7 @@ class PerformanceCounter {
   std::int64_t currentFrameCount_ = 0;
   std::int64_t totalFrameCount_ = 0;
 
-  std::vector<double> frameTimes_;
+  FrameTimeHistogram recentFrameTimes_;
+  FrameTimeHistogram captureFrameTimes_;
 };
 }
@@ -136,6 +136,66 @@ void RecordingState::UpdateLagIndicatorHotkey()
   SetLagIndicatorHotkey(static_cast<int>(config.lagIndicatorHotkey_));
 }
 
+void RecordingState::SetOverlayUpdateRate(unsigned int rate)
+{
+  overlayUpdateRate_ = rate;
+}
+
+unsigned int RecordingState::GetOverlayUpdateRate()
+{
+  return overlayUpdateRate_;
+}
+
+void RecordingState::SetSoftwareOverlayRasterizer(bool enabled)
+{
+  softwareOverlayRasterizer_ = enabled;
+}
+
+bool RecordingState::IsSoftwareOverlayRasterizerEnabled()
+{
+  return softwareOverlayRasterizer_;
+}
+
+void RecordingState::SetOverlayCostBudget(unsigned int microseconds)
+{
+  overlayCostBudget_ = microseconds;
+}
+
+unsigned int RecordingState::GetOverlayCostBudget()
+{
+  return overlayCostBudget_;
+}
+
+void RecordingState::SetShowOverlayCost(bool show)
+{
+  showOverlayCost_ = show;
+}
+
+bool RecordingState::IsOverlayCostShowing()
+{
+  return showOverlayCost_;
+}
+
+void RecordingState::SetShowFrameTimeLows(bool show)
+{
+  showFrameTimeLows_ = show;
+}
+
+bool RecordingState::IsFrameTimeLowsShowing()
+{
+  return showFrameTimeLows_;
+}
+
+void RecordingState::SetOverlayGpuTimestamps(bool enabled)
+{
+  overlayGpuTimestamps_ = enabled;
+}
+
+bool RecordingState::IsOverlayGpuTimestampsEnabled()
+{
+  return overlayGpuTimestamps_;
+}
+
 void RecordingState::ShowOverlay() 
 {
   showOverlay_ = true; 
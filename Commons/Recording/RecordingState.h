@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include "../Overlay/OverlayPosition.h"
 
@@ -68,6 +69,18 @@ class RecordingState final {
   void UpdateLagIndicatorHotkey();
   void SetLagIndicatorHotkey(int lagIndicator);
   int GetLagIndicatorHotkey();
+  void SetOverlayUpdateRate(unsigned int rate);
+  unsigned int GetOverlayUpdateRate();
+  void SetSoftwareOverlayRasterizer(bool enabled);
+  bool IsSoftwareOverlayRasterizerEnabled();
+  void SetOverlayCostBudget(unsigned int microseconds);
+  unsigned int GetOverlayCostBudget();
+  void SetShowOverlayCost(bool show);
+  bool IsOverlayCostShowing();
+  void SetShowFrameTimeLows(bool show);
+  bool IsFrameTimeLowsShowing();
+  void SetOverlayGpuTimestamps(bool enabled);
+  bool IsOverlayGpuTimestampsEnabled();
 
   bool IsOverlayDuringCaptureHidden();
   bool IsRecording();
@@ -85,7 +98,14 @@ class RecordingState final {
   float startDisplayTime_ = 1.0f;
   float endDisplayTime_ = 1.0f;
   float recordingTime_ = 0.0f;
-  int lagIndicator_ = 0x74;  // 0x91; // SCROLL_LOCK
+  // read by the input sampler thread
+  std::atomic<int> lagIndicator_{0x74};  // 0x91; // SCROLL_LOCK
+  unsigned int overlayUpdateRate_ = 0;
+  bool softwareOverlayRasterizer_ = false;
+  unsigned int overlayCostBudget_ = 0;
+  bool showOverlayCost_ = false;
+  bool showFrameTimeLows_ = false;
+  bool overlayGpuTimestamps_ = false;
 
   OverlayPosition overlayPosition_ = OverlayPosition::UpperRight;
   TextureState currentTextureState_ = TextureState::Default;
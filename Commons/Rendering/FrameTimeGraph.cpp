@@ -0,0 +1,90 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "FrameTimeGraph.h"
+
+#include <algorithm>
+#include <utility>
+
+FrameTimeGraph::FrameTimeGraph(float scale, size_t chunkSize)
+    : scale_(scale), chunkSize_(std::max<size_t>(chunkSize, 2))
+{
+  // Empty
+}
+
+void FrameTimeGraph::Clear()
+{
+  chunks_.clear();
+  newestPosition_ = 0.0;
+}
+
+void FrameTimeGraph::Add(float frameTime)
+{
+  if (!(frameTime > 0.0f)) {
+    Clear();
+    return;
+  }
+
+  if (chunks_.empty()) {
+    Chunk chunk;
+    chunk.id = nextId_++;
+    chunk.points.reserve(chunkSize_);
+    chunk.points.push_back({0.0f, frameTime});
+    chunks_.push_back(std::move(chunk));
+    return;
+  }
+
+  const Point newest = chunks_.back().points.back();
+  const double position = newestPosition_ + newest.y * scale_;
+  if (chunks_.back().points.size() == chunkSize_) {
+    Chunk chunk;
+    chunk.id = nextId_++;
+    chunk.position = newestPosition_;
+    chunk.points.reserve(chunkSize_);
+    chunk.points.push_back({0.0f, newest.y});
+    chunks_.push_back(std::move(chunk));
+  }
+
+  auto& chunk = chunks_.back();
+  chunk.points.push_back({static_cast<float>(position - chunk.position), frameTime});
+  newestPosition_ = position;
+}
+
+void FrameTimeGraph::Trim(float width)
+{
+  while (!chunks_.empty()) {
+    const auto& chunk = chunks_.front();
+    if (newestPosition_ - (chunk.position + chunk.points.back().x) <= width) {
+      break;
+    }
+    chunks_.pop_front();
+  }
+}
+
+const std::deque<FrameTimeGraph::Chunk>& FrameTimeGraph::GetChunks() const { return chunks_; }
+
+float FrameTimeGraph::GetOffset(const Chunk& chunk) const
+{
+  return static_cast<float>(newestPosition_ - chunk.position);
+}
+
+size_t FrameTimeGraph::GetChunkSize() const { return chunkSize_; }
@@ -0,0 +1,73 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Scrolling polyline of the frame time graph, the newest sample is drawn on the left.
+// Samples are appended as they arrive and kept in chunks of a fixed number of points. Points
+// are stored relative to their chunk, so the geometry of a full chunk never changes and only
+// the newest chunk has to be rebuilt when the graph scrolls.
+class FrameTimeGraph final {
+ public:
+  // x is the distance to the chunk origin towards newer samples, y the frame time in ms.
+  struct Point {
+    float x;
+    float y;
+  };
+
+  struct Chunk {
+    // unique for the lifetime of the graph, identifies cached geometry
+    uint64_t id = 0;
+    // graph position of the chunk origin
+    double position = 0.0;
+    // starts with the last point of the previous chunk to continue its line
+    std::vector<Point> points;
+  };
+
+  // Samples are spaced by the frame time of the older sample times scale.
+  FrameTimeGraph(float scale, size_t chunkSize);
+
+  void Clear();
+  // Appends the newest frame time in ms. Zero or negative samples are not filled, the line
+  // restarts with the next valid sample.
+  void Add(float frameTime);
+  // Drops the chunks which are completely further than width from the newest sample.
+  void Trim(float width);
+
+  const std::deque<Chunk>& GetChunks() const;
+  // Horizontal distance of the chunk origin to the newest sample. A point is drawn at
+  // left + GetOffset(chunk) - point.x and bottom - point.y.
+  float GetOffset(const Chunk& chunk) const;
+  size_t GetChunkSize() const;
+
+ private:
+  std::deque<Chunk> chunks_;
+  double newestPosition_ = 0.0;
+  uint64_t nextId_ = 0;
+  float scale_;
+  size_t chunkSize_;
+};
@@ -0,0 +1,327 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "GlyphAtlas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+GlyphAtlas::GlyphAtlas(int width, int height, float lineHeight, int padding)
+    : pixels_(static_cast<size_t>(width) * height, 0),
+      width_(width),
+      height_(height),
+      lineHeight_(lineHeight),
+      padding_(padding)
+{
+  // Empty
+}
+
+bool GlyphAtlas::AddGlyph(wchar_t character, Style style, int width, int height, float advance,
+                          const uint8_t* coverage, int stride)
+{
+  if (width > width_ || height > height_) {
+    return false;
+  }
+
+  // start a new shelf if the glyph does not fit into the current one, keep one pixel
+  // between the cells so sampling never reads a neighbouring glyph
+  if (cursorX_ + width > width_) {
+    cursorX_ = 0;
+    cursorY_ += shelfHeight_ + 1;
+    shelfHeight_ = 0;
+  }
+  if (cursorY_ + height > height_) {
+    return false;
+  }
+
+  Glyph glyph;
+  glyph.x = cursorX_;
+  glyph.y = cursorY_;
+  glyph.width = width;
+  glyph.height = height;
+  glyph.advance = advance;
+
+  for (int y = 0; y < height; ++y) {
+    memcpy(&pixels_[static_cast<size_t>(glyph.y + y) * width_ + glyph.x], coverage + y * stride,
+           width);
+  }
+
+  cursorX_ += width + 1;
+  shelfHeight_ = std::max(shelfHeight_, height);
+  glyphs_[static_cast<int>(style)][character] = glyph;
+  return true;
+}
+
+const GlyphAtlas::Glyph* GlyphAtlas::FindGlyph(wchar_t character, Style style) const
+{
+  const auto& glyphs = glyphs_[static_cast<int>(style)];
+  const auto it = glyphs.find(character);
+  return it != glyphs.end() ? &it->second : nullptr;
+}
+
+bool GlyphAtlas::HasGlyphs(const std::wstring& text) const
+{
+  for (const auto character : text) {
+    if (character == L'\n' || character == L'\t') {
+      continue;
+    }
+    if (!FindGlyph(character, Style::Regular) || !FindGlyph(character, Style::Bold)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void GlyphAtlas::Layout(const std::wstring& text, const std::vector<Range>& highlights,
+                        const Rect& area, TextAlignment textAlignment,
+                        ParagraphAlignment paragraphAlignment, float tabStop,
+                        std::vector<Quad>& quads) const
+{
+  quads.clear();
+
+  const auto lineCount = std::count(text.begin(), text.end(), L'\n') + 1;
+  const float textHeight = lineCount * lineHeight_;
+  float lineTop = area.top;
+  switch (paragraphAlignment) {
+    case ParagraphAlignment::Center:
+      lineTop += (area.bottom - area.top - textHeight) * 0.5f;
+      break;
+    case ParagraphAlignment::Far:
+      lineTop += area.bottom - area.top - textHeight;
+      break;
+    default:
+      break;
+  }
+
+  size_t begin = 0;
+  while (begin <= text.size()) {
+    size_t end = text.find(L'\n', begin);
+    if (end == std::wstring::npos) {
+      end = text.size();
+    }
+
+    float lineLeft = area.left;
+    if (textAlignment != TextAlignment::Leading) {
+      const float freeSpace = area.right - area.left - MeasureLine(text, begin, end, highlights,
+                                                                   tabStop);
+      lineLeft += textAlignment == TextAlignment::Center ? freeSpace * 0.5f : freeSpace;
+    }
+
+    // glyphs are placed on whole pixels to keep them sharp
+    const float top = std::round(lineTop) - padding_;
+    float x = 0.0f;
+    for (size_t i = begin; i < end; ++i) {
+      if (text[i] == L'\t') {
+        x = NextTabStop(x, tabStop);
+        continue;
+      }
+
+      const bool highlight = IsHighlighted(highlights, i);
+      const auto glyph = FindGlyph(text[i], highlight ? Style::Bold : Style::Regular);
+      if (!glyph) {
+        continue;
+      }
+
+      Quad quad;
+      quad.source = {static_cast<float>(glyph->x), static_cast<float>(glyph->y),
+                     static_cast<float>(glyph->x + glyph->width),
+                     static_cast<float>(glyph->y + glyph->height)};
+      const float left = std::round(lineLeft + x) - padding_;
+      quad.dest = {left, top, left + glyph->width, top + glyph->height};
+      quad.highlight = highlight;
+      quads.push_back(quad);
+
+      x += glyph->advance;
+    }
+
+    lineTop += lineHeight_;
+    begin = end + 1;
+  }
+}
+
+void GlyphAtlas::Compose(const std::vector<Quad>& quads, const Rect& clip, uint32_t textColor,
+                         uint32_t highlightColor, uint8_t* image, int imageStride,
+                         int imageWidth, int imageHeight) const
+{
+  const Bounds bounds = {std::max(0, PixelEdge(clip.left)), std::max(0, PixelEdge(clip.top)),
+                         std::min(imageWidth, PixelEdge(clip.right)),
+                         std::min(imageHeight, PixelEdge(clip.bottom))};
+  for (const auto& quad : quads) {
+    BlendGlyph(quad, quad.highlight ? highlightColor : textColor, 0, 0, bounds, image,
+               imageStride);
+  }
+}
+
+void GlyphAtlas::ComposeRuns(const std::vector<Quad>& quads, const Rect& clip,
+                             RunMask& mask) const
+{
+  mask.runs.clear();
+  mask.width = 0;
+  mask.height = 0;
+
+  // quads of the runs, composed once the size of the mask is known
+  std::vector<std::pair<size_t, size_t>> runQuads;
+  const Bounds bounds = {PixelEdge(clip.left), PixelEdge(clip.top), PixelEdge(clip.right),
+                         PixelEdge(clip.bottom)};
+  size_t begin = 0;
+  while (begin < quads.size()) {
+    Bounds runBounds = {static_cast<int>(quads[begin].dest.left),
+                        static_cast<int>(quads[begin].dest.top),
+                        static_cast<int>(quads[begin].dest.right),
+                        static_cast<int>(quads[begin].dest.bottom)};
+    size_t end = begin + 1;
+    while (end < quads.size() && quads[end].highlight == quads[begin].highlight &&
+           quads[end].dest.top == quads[begin].dest.top) {
+      runBounds.left = std::min(runBounds.left, static_cast<int>(quads[end].dest.left));
+      runBounds.right = std::max(runBounds.right, static_cast<int>(quads[end].dest.right));
+      ++end;
+    }
+
+    runBounds.left = std::max(runBounds.left, bounds.left);
+    runBounds.top = std::max(runBounds.top, bounds.top);
+    runBounds.right = std::min(runBounds.right, bounds.right);
+    runBounds.bottom = std::min(runBounds.bottom, bounds.bottom);
+    if (runBounds.left < runBounds.right && runBounds.top < runBounds.bottom) {
+      const int width = runBounds.right - runBounds.left;
+      const int height = runBounds.bottom - runBounds.top;
+      Run run;
+      run.source = {0.0f, static_cast<float>(mask.height), static_cast<float>(width),
+                    static_cast<float>(mask.height + height)};
+      run.dest = {static_cast<float>(runBounds.left), static_cast<float>(runBounds.top),
+                  static_cast<float>(runBounds.right), static_cast<float>(runBounds.bottom)};
+      run.highlight = quads[begin].highlight;
+      mask.runs.push_back(run);
+      runQuads.push_back({begin, end});
+      mask.width = std::max(mask.width, width);
+      mask.height += height;
+    }
+    begin = end;
+  }
+
+  mask.pixels.assign(static_cast<size_t>(mask.width) * mask.height, 0);
+  auto image = reinterpret_cast<uint8_t*>(mask.pixels.data());
+  for (size_t i = 0; i < mask.runs.size(); ++i) {
+    const auto& run = mask.runs[i];
+    const Bounds runBounds = {0, static_cast<int>(run.source.top),
+                              static_cast<int>(run.source.right),
+                              static_cast<int>(run.source.bottom)};
+    const int offsetX = -static_cast<int>(run.dest.left);
+    const int offsetY = static_cast<int>(run.source.top - run.dest.top);
+    for (size_t quad = runQuads[i].first; quad < runQuads[i].second; ++quad) {
+      BlendGlyph(quads[quad], 0xFFFFFFFF, offsetX, offsetY, runBounds, image, mask.width * 4);
+    }
+  }
+}
+
+int GlyphAtlas::GetWidth() const { return width_; }
+
+int GlyphAtlas::GetHeight() const { return height_; }
+
+float GlyphAtlas::GetLineHeight() const { return lineHeight_; }
+
+int GlyphAtlas::GetPadding() const { return padding_; }
+
+const std::vector<uint8_t>& GlyphAtlas::GetPixels() const { return pixels_; }
+
+float GlyphAtlas::MeasureLine(const std::wstring& text, size_t begin, size_t end,
+                              const std::vector<Range>& highlights, float tabStop) const
+{
+  float x = 0.0f;
+  for (size_t i = begin; i < end; ++i) {
+    if (text[i] == L'\t') {
+      x = NextTabStop(x, tabStop);
+      continue;
+    }
+
+    const auto glyph =
+        FindGlyph(text[i], IsHighlighted(highlights, i) ? Style::Bold : Style::Regular);
+    if (glyph) {
+      x += glyph->advance;
+    }
+  }
+  return x;
+}
+
+bool GlyphAtlas::IsHighlighted(const std::vector<Range>& highlights, size_t index)
+{
+  for (const auto& range : highlights) {
+    if (index >= range.start && index < range.start + range.length) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int GlyphAtlas::PixelEdge(float coordinate)
+{
+  // first pixel whose center is at or behind the coordinate
+  return static_cast<int>(std::ceil(coordinate - 0.5f));
+}
+
+void GlyphAtlas::BlendGlyph(const Quad& quad, uint32_t color, int offsetX, int offsetY,
+                            const Bounds& bounds, uint8_t* image, int imageStride) const
+{
+  const uint32_t channels[4] = {color & 0xFF, (color >> 8) & 0xFF, (color >> 16) & 0xFF,
+                                color >> 24};
+
+  const int sourceX = static_cast<int>(quad.source.left);
+  const int sourceY = static_cast<int>(quad.source.top);
+  const int destX = static_cast<int>(quad.dest.left) + offsetX;
+  const int destY = static_cast<int>(quad.dest.top) + offsetY;
+  const int width = static_cast<int>(quad.source.right - quad.source.left);
+  const int height = static_cast<int>(quad.source.bottom - quad.source.top);
+
+  const int left = std::max(bounds.left, destX);
+  const int top = std::max(bounds.top, destY);
+  const int right = std::min(bounds.right, destX + width);
+  const int bottom = std::min(bounds.bottom, destY + height);
+  for (int y = top; y < bottom; ++y) {
+    const ptrdiff_t coverage =
+        static_cast<ptrdiff_t>(sourceY + y - destY) * width_ + sourceX - destX;
+    uint8_t* pixel = image + static_cast<size_t>(y) * imageStride;
+    for (int x = left; x < right; ++x) {
+      const uint32_t alpha = pixels_[coverage + x];
+      if (alpha == 0) {
+        continue;
+      }
+
+      // premultiplied source over destination
+      const uint32_t sourceAlpha = channels[3] * alpha / 255;
+      for (int c = 0; c < 4; ++c) {
+        const uint32_t source = channels[c] * alpha / 255;
+        pixel[x * 4 + c] =
+            static_cast<uint8_t>(source + pixel[x * 4 + c] * (255 - sourceAlpha) / 255);
+      }
+    }
+  }
+}
+
+float GlyphAtlas::NextTabStop(float x, float tabStop)
+{
+  if (tabStop <= 0.0f) {
+    return x;
+  }
+  return (std::floor(x / tabStop) + 1.0f) * tabStop;
+}
@@ -0,0 +1,147 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Cache of rasterized glyphs for the overlay text.
+// The coverage of every glyph is packed into a single 8 bit atlas once, strings are then
+// composed from glyph quads without creating a text layout. The atlas does not depend on
+// DirectWrite, glyphs are rasterized and added by the text renderer.
+class GlyphAtlas final {
+ public:
+  enum class Style { Regular, Bold };
+  enum class TextAlignment { Leading, Center, Trailing };
+  enum class ParagraphAlignment { Near, Center, Far };
+
+  struct Rect {
+    float left;
+    float top;
+    float right;
+    float bottom;
+  };
+
+  // Cell of a glyph in the atlas, covering the advance and line height plus padding.
+  struct Glyph {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    float advance = 0.0f;
+  };
+
+  // Part of a string drawn with the bold style and the highlight color.
+  struct Range {
+    uint32_t start;
+    uint32_t length;
+  };
+
+  struct Quad {
+    Rect source;
+    Rect dest;
+    bool highlight;
+  };
+
+  // Consecutive glyphs of one line with the same style, source is the run's rect in the mask.
+  struct Run {
+    Rect source;
+    Rect dest;
+    bool highlight;
+  };
+
+  // Coverage of the runs of a text, packed one run below the other. The pixels are white
+  // premultiplied BGRA so the mask can be used as opacity mask without conversion.
+  struct RunMask {
+    std::vector<Run> runs;
+    std::vector<uint32_t> pixels;
+    int width = 0;
+    int height = 0;
+  };
+
+  // padding is the space around the glyph origin for overhanging glyph parts
+  GlyphAtlas(int width, int height, float lineHeight, int padding);
+
+  // Reserves a cell of the given size and copies the coverage of the glyph into it.
+  // Returns false if the atlas is full.
+  bool AddGlyph(wchar_t character, Style style, int width, int height, float advance,
+                const uint8_t* coverage, int stride);
+  const Glyph* FindGlyph(wchar_t character, Style style) const;
+  // True if all characters of the text are in the atlas for both styles.
+  bool HasGlyphs(const std::wstring& text) const;
+
+  // Lays out the text in the area. Lines are separated by '\n' and tabs advance to the next
+  // multiple of tabStop. Text which does not fit is not wrapped, it has to be clipped.
+  void Layout(const std::wstring& text, const std::vector<Range>& highlights, const Rect& area,
+              TextAlignment textAlignment, ParagraphAlignment paragraphAlignment, float tabStop,
+              std::vector<Quad>& quads) const;
+
+  // Blends the quads into a premultiplied BGRA image, colors are premultiplied BGRA as well.
+  // Only pixels whose centers are inside the clip rect and the image are written.
+  void Compose(const std::vector<Quad>& quads, const Rect& clip, uint32_t textColor,
+               uint32_t highlightColor, uint8_t* image, int imageStride, int imageWidth,
+               int imageHeight) const;
+  // Splits the quads into runs clipped to the clip rect and composes their coverage into mask.
+  void ComposeRuns(const std::vector<Quad>& quads, const Rect& clip, RunMask& mask) const;
+
+  int GetWidth() const;
+  int GetHeight() const;
+  float GetLineHeight() const;
+  int GetPadding() const;
+  // 8 bit coverage, the stride is the atlas width
+  const std::vector<uint8_t>& GetPixels() const;
+
+ private:
+  static const int styleCount_ = 2;
+
+  // pixel bounds, right and bottom are exclusive
+  struct Bounds {
+    int left;
+    int top;
+    int right;
+    int bottom;
+  };
+
+  static int PixelEdge(float coordinate);
+  void BlendGlyph(const Quad& quad, uint32_t color, int offsetX, int offsetY,
+                  const Bounds& bounds, uint8_t* image, int imageStride) const;
+
+  float MeasureLine(const std::wstring& text, size_t begin, size_t end,
+                    const std::vector<Range>& highlights, float tabStop) const;
+  static bool IsHighlighted(const std::vector<Range>& highlights, size_t index);
+  static float NextTabStop(float x, float tabStop);
+
+  std::vector<uint8_t> pixels_;
+  std::unordered_map<wchar_t, Glyph> glyphs_[styleCount_];
+  int width_;
+  int height_;
+  float lineHeight_;
+  int padding_;
+
+  // shelf packing of the glyph cells
+  int cursorX_ = 0;
+  int cursorY_ = 0;
+  int shelfHeight_ = 0;
+};
@@ -0,0 +1,267 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "GlyphTextRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../Logging/MessageLog.h"
+
+using Microsoft::WRL::ComPtr;
+
+// printable ASCII and the bullet used for the recording indicator
+const wchar_t* GlyphTextRenderer::characters_ =
+    L" !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`"
+    L"abcdefghijklmnopqrstuvwxyz{|}~\x2022";
+const float GlyphTextRenderer::tabStop_ = 50.0f;
+const int GlyphTextRenderer::atlasSize_ = 512;
+const int GlyphTextRenderer::padding_ = 2;
+
+bool GlyphTextRenderer::Init(IDWriteFactory* writeFactory, IWICImagingFactory* wicFactory,
+                             ID2D1Factory* d2dFactory, IDWriteTextFormat* textFormat)
+{
+  switch (textFormat->GetTextAlignment()) {
+    case DWRITE_TEXT_ALIGNMENT_CENTER:
+      textAlignment_ = GlyphAtlas::TextAlignment::Center;
+      break;
+    case DWRITE_TEXT_ALIGNMENT_TRAILING:
+      textAlignment_ = GlyphAtlas::TextAlignment::Trailing;
+      break;
+    default:
+      textAlignment_ = GlyphAtlas::TextAlignment::Leading;
+  }
+
+  switch (textFormat->GetParagraphAlignment()) {
+    case DWRITE_PARAGRAPH_ALIGNMENT_CENTER:
+      paragraphAlignment_ = GlyphAtlas::ParagraphAlignment::Center;
+      break;
+    case DWRITE_PARAGRAPH_ALIGNMENT_FAR:
+      paragraphAlignment_ = GlyphAtlas::ParagraphAlignment::Far;
+      break;
+    default:
+      paragraphAlignment_ = GlyphAtlas::ParagraphAlignment::Near;
+  }
+
+  ComPtr<IDWriteTextLayout> lineLayout;
+  HRESULT hr = writeFactory->CreateTextLayout(L"0", 1, textFormat, 1000.0f, 1000.0f, &lineLayout);
+  if (FAILED(hr)) {
+    g_messageLog.LogError("GlyphTextRenderer", "CreateTextLayout failed, HRESULT", hr);
+    return false;
+  }
+  DWRITE_TEXT_METRICS lineMetrics;
+  hr = lineLayout->GetMetrics(&lineMetrics);
+  if (FAILED(hr)) {
+    g_messageLog.LogError("GlyphTextRenderer", "GetMetrics failed, HRESULT", hr);
+    return false;
+  }
+  const float lineHeight = lineMetrics.height;
+
+  // every glyph is rendered into a cell of the full line height
+  const int cellHeight = static_cast<int>(std::ceil(lineHeight)) + 2 * padding_;
+  const int maxCellWidth =
+      static_cast<int>(std::ceil(textFormat->GetFontSize() * 2.0f)) + 2 * padding_;
+
+  ComPtr<IWICBitmap> glyphBitmap;
+  hr = wicFactory->CreateBitmap(maxCellWidth, cellHeight, GUID_WICPixelFormat32bppPBGRA,
+                                WICBitmapCacheOnLoad, &glyphBitmap);
+  if (FAILED(hr)) {
+    g_messageLog.LogError("GlyphTextRenderer", "CreateBitmap failed, HRESULT", hr);
+    return false;
+  }
+
+  const auto rtProperties = D2D1::RenderTargetProperties(
+      D2D1_RENDER_TARGET_TYPE_DEFAULT,
+      D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED));
+  ComPtr<ID2D1RenderTarget> glyphTarget;
+  hr = d2dFactory->CreateWicBitmapRenderTarget(glyphBitmap.Get(), rtProperties, &glyphTarget);
+  if (FAILED(hr)) {
+    g_messageLog.LogError("GlyphTextRenderer", "CreateWicBitmapRenderTarget failed, HRESULT",
+                          hr);
+    return false;
+  }
+  // the alpha channel is used as coverage, ClearType would need the color channels
+  glyphTarget->SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE);
+
+  ComPtr<ID2D1SolidColorBrush> glyphBrush;
+  hr = glyphTarget->CreateSolidColorBrush(D2D1::ColorF(1.0f, 1.0f, 1.0f, 1.0f), &glyphBrush);
+  if (FAILED(hr)) {
+    g_messageLog.LogError("GlyphTextRenderer", "CreateSolidColorBrush failed, HRESULT", hr);
+    return false;
+  }
+
+  atlas_.reset(new GlyphAtlas(atlasSize_, atlasSize_, lineHeight, padding_));
+  std::vector<uint8_t> coverage(static_cast<size_t>(maxCellWidth) * cellHeight);
+  for (const wchar_t* character = characters_; *character; ++character) {
+    for (const auto style : {GlyphAtlas::Style::Regular, GlyphAtlas::Style::Bold}) {
+      ComPtr<IDWriteTextLayout> layout;
+      hr = writeFactory->CreateTextLayout(character, 1, textFormat, 1000.0f, lineHeight, &layout);
+      if (FAILED(hr)) {
+        g_messageLog.LogError("GlyphTextRenderer", "CreateTextLayout failed, HRESULT", hr);
+        atlas_.reset();
+        return false;
+      }
+      layout->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_LEADING);
+      layout->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR);
+      layout->SetWordWrapping(DWRITE_WORD_WRAPPING_NO_WRAP);
+      if (style == GlyphAtlas::Style::Bold) {
+        layout->SetFontWeight(DWRITE_FONT_WEIGHT_BOLD, {0, 1});
+      }
+
+      DWRITE_TEXT_METRICS metrics;
+      hr = layout->GetMetrics(&metrics);
+      if (FAILED(hr)) {
+        g_messageLog.LogError("GlyphTextRenderer", "GetMetrics failed, HRESULT", hr);
+        atlas_.reset();
+        return false;
+      }
+      const float advance = metrics.widthIncludingTrailingWhitespace;
+      const int cellWidth =
+          std::min(maxCellWidth, static_cast<int>(std::ceil(advance)) + 2 * padding_);
+
+      glyphTarget->BeginDraw();
+      glyphTarget->Clear(D2D1::ColorF(0.0f, 0.0f, 0.0f, 0.0f));
+      glyphTarget->DrawTextLayout(
+          D2D1::Point2F(static_cast<float>(padding_), static_cast<float>(padding_)),
+          layout.Get(), glyphBrush.Get());
+      hr = glyphTarget->EndDraw();
+      if (FAILED(hr)) {
+        g_messageLog.LogError("GlyphTextRenderer", "EndDraw failed, HRESULT", hr);
+        atlas_.reset();
+        return false;
+      }
+
+      {
+        const WICRect cell = {0, 0, cellWidth, cellHeight};
+        ComPtr<IWICBitmapLock> lock;
+        UINT stride = 0;
+        UINT size = 0;
+        BYTE* data = nullptr;
+        hr = glyphBitmap->Lock(&cell, WICBitmapLockRead, &lock);
+        if (SUCCEEDED(hr)) {
+          hr = lock->GetStride(&stride);
+        }
+        if (SUCCEEDED(hr)) {
+          hr = lock->GetDataPointer(&size, &data);
+        }
+        if (FAILED(hr)) {
+          g_messageLog.LogError("GlyphTextRenderer", "Glyph bitmap lock failed, HRESULT", hr);
+          atlas_.reset();
+          return false;
+        }
+
+        for (int y = 0; y < cellHeight; ++y) {
+          for (int x = 0; x < cellWidth; ++x) {
+            coverage[y * cellWidth + x] = data[y * stride + x * 4 + 3];
+          }
+        }
+      }
+
+      if (!atlas_->AddGlyph(*character, style, cellWidth, cellHeight, advance, coverage.data(),
+                            cellWidth)) {
+        g_messageLog.LogWarning("GlyphTextRenderer", "Glyph atlas is full");
+        atlas_.reset();
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool GlyphTextRenderer::CanRender(const std::wstring& text) const
+{
+  return atlas_ && atlas_->HasGlyphs(text);
+}
+
+const GlyphAtlas* GlyphTextRenderer::GetAtlas() const { return atlas_.get(); }
+
+void GlyphTextRenderer::Layout(const std::wstring& text,
+                               const std::vector<GlyphAtlas::Range>& highlights,
+                               const D2D1_RECT_F& area, std::vector<GlyphAtlas::Quad>& quads) const
+{
+  const GlyphAtlas::Rect layoutArea = {area.left, area.top, area.right, area.bottom};
+  atlas_->Layout(text, highlights, layoutArea, textAlignment_, paragraphAlignment_, tabStop_,
+                 quads);
+}
+
+bool GlyphTextRenderer::UpdateRuns(ID2D1RenderTarget* renderTarget,
+                                   const std::vector<GlyphAtlas::Quad>& quads,
+                                   const D2D1_RECT_F& area, Runs& runs) const
+{
+  const GlyphAtlas::Rect clip = {area.left, area.top, area.right, area.bottom};
+  atlas_->ComposeRuns(quads, clip, runs.mask);
+  if (runs.mask.runs.empty()) {
+    return true;
+  }
+
+  const auto width = static_cast<UINT32>(runs.mask.width);
+  const auto height = static_cast<UINT32>(runs.mask.height);
+  if (runs.bitmap) {
+    const auto size = runs.bitmap->GetPixelSize();
+    if (size.width < width || size.height < height) {
+      runs.bitmap.Reset();
+    }
+  }
+  if (!runs.bitmap) {
+    const auto bitmapProperties = D2D1::BitmapProperties(
+        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED));
+    const HRESULT hr =
+        renderTarget->CreateBitmap(D2D1::SizeU(width, height), runs.mask.pixels.data(),
+                                   width * 4, bitmapProperties, &runs.bitmap);
+    if (FAILED(hr)) {
+      g_messageLog.LogError("GlyphTextRenderer", "CreateBitmap failed, HRESULT", hr);
+      return false;
+    }
+    return true;
+  }
+
+  const auto rect = D2D1::RectU(0, 0, width, height);
+  const HRESULT hr = runs.bitmap->CopyFromMemory(&rect, runs.mask.pixels.data(), width * 4);
+  if (FAILED(hr)) {
+    g_messageLog.LogError("GlyphTextRenderer", "CopyFromMemory failed, HRESULT", hr);
+    return false;
+  }
+  return true;
+}
+
+void GlyphTextRenderer::Draw(ID2D1RenderTarget* renderTarget, const Runs& runs,
+                             ID2D1Brush* textBrush, ID2D1Brush* highlightBrush) const
+{
+  if (!runs.bitmap) {
+    return;
+  }
+
+  // FillOpacityMask requires aliased rendering
+  const auto antialiasMode = renderTarget->GetAntialiasMode();
+  renderTarget->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+
+  for (const auto& run : runs.mask.runs) {
+    const auto dest = D2D1::RectF(run.dest.left, run.dest.top, run.dest.right, run.dest.bottom);
+    const auto source =
+        D2D1::RectF(run.source.left, run.source.top, run.source.right, run.source.bottom);
+    renderTarget->FillOpacityMask(runs.bitmap.Get(), run.highlight ? highlightBrush : textBrush,
+                                  D2D1_OPACITY_MASK_CONTENT_TEXT_GRAYSCALE, &dest, &source);
+  }
+
+  renderTarget->SetAntialiasMode(antialiasMode);
+}
@@ -0,0 +1,77 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <d2d1.h>
+#include <dwrite.h>
+#include <wincodec.h>
+#include <wrl.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GlyphAtlas.h"
+
+// Draws the overlay text of one text format from a glyph atlas.
+// The glyphs of the character set are rasterized with DirectWrite once in Init, text is then
+// composed from the cached glyphs into one mask per run and drawn by masking the text brushes
+// with it, without per frame text layouts.
+class GlyphTextRenderer final {
+ public:
+  // Opacity mask of laid out text, only updated when the layout changes.
+  struct Runs {
+    GlyphAtlas::RunMask mask;
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;
+  };
+
+  GlyphTextRenderer() = default;
+  GlyphTextRenderer(const GlyphTextRenderer&) = delete;
+  GlyphTextRenderer& operator=(const GlyphTextRenderer&) = delete;
+
+  bool Init(IDWriteFactory* writeFactory, IWICImagingFactory* wicFactory,
+            ID2D1Factory* d2dFactory, IDWriteTextFormat* textFormat);
+
+  // False if the renderer is not initialized or a character is missing in the atlas.
+  bool CanRender(const std::wstring& text) const;
+  // Null if Init failed.
+  const GlyphAtlas* GetAtlas() const;
+  void Layout(const std::wstring& text, const std::vector<GlyphAtlas::Range>& highlights,
+              const D2D1_RECT_F& area, std::vector<GlyphAtlas::Quad>& quads) const;
+  // Composes the quads clipped to the area into the mask of runs, the bitmap of runs is reused
+  // if it is large enough.
+  bool UpdateRuns(ID2D1RenderTarget* renderTarget, const std::vector<GlyphAtlas::Quad>& quads,
+                  const D2D1_RECT_F& area, Runs& runs) const;
+  // One FillOpacityMask per run of glyphs with the same style on a line.
+  void Draw(ID2D1RenderTarget* renderTarget, const Runs& runs, ID2D1Brush* textBrush,
+            ID2D1Brush* highlightBrush) const;
+
+ private:
+  static const wchar_t* characters_;
+  static const float tabStop_;
+  static const int atlasSize_;
+  static const int padding_;
+
+  std::unique_ptr<GlyphAtlas> atlas_;
+  GlyphAtlas::TextAlignment textAlignment_ = GlyphAtlas::TextAlignment::Leading;
+  GlyphAtlas::ParagraphAlignment paragraphAlignment_ = GlyphAtlas::ParagraphAlignment::Near;
+};
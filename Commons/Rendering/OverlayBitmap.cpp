@@ -26,7 +26,8 @@
 #include "../Recording/PerformanceCounter.hpp"
 #include "../Recording/RecordingState.h"
 
-#include <sstream>
+#include <algorithm>
+#include <cmath>
 
 using namespace Microsoft::WRL;
 
@@ -58,6 +59,8 @@ const D2D1_COLOR_F OverlayBitmap::colorBarSequence_[] = {
     {1.0f, 153.0f / 255.0f, 0.0f, 1.0f},                        // Orange
 };
 
+const unsigned int OverlayBitmap::reducedUpdateRate_ = 30;
+
 OverlayBitmap::RawData::RawData() : dataPtr{nullptr}, size{0}
 {
   // Empty
@@ -100,11 +103,39 @@ bool OverlayBitmap::Init(int screenWidth, int screenHeight, API api)
 
   RecordingState::GetInstance().UpdateLagIndicatorHotkey();
 
+  if (RecordingState::GetInstance().IsSoftwareOverlayRasterizerEnabled()) {
+    // text can only be drawn from the glyph atlases
+    useSoftwareRasterizer_ = textGlyphs_.GetAtlas() && messageGlyphs_.GetAtlas() &&
+                             stopValueGlyphs_.GetAtlas() && stopMessageGlyphs_.GetAtlas() &&
+                             graphLabelGlyphs_.GetAtlas();
+    if (useSoftwareRasterizer_) {
+      g_messageLog.LogInfo("OverlayBitmap", "Using the software rasterizer");
+    }
+    else {
+      g_messageLog.LogWarning("OverlayBitmap",
+                              "Glyph atlases missing, software rasterizer not available");
+    }
+  }
+
+  costBudget_.SetBudget(RecordingState::GetInstance().GetOverlayCostBudget());
+  showOverlayCost_ = RecordingState::GetInstance().IsOverlayCostShowing();
+  showOverlayGpuCost_ =
+      showOverlayCost_ && RecordingState::GetInstance().IsOverlayGpuTimestampsEnabled();
+  showFrameTimeLows_ = RecordingState::GetInstance().IsFrameTimeLowsShowing();
+
+  updateRate_ = RecordingState::GetInstance().GetOverlayUpdateRate();
+  if (updateRate_ > 0) {
+    StartRenderThread(updateRate_);
+  }
+
   return true;
 }
 
 OverlayBitmap::~OverlayBitmap()
 {
+  StopRenderThread();
+  costBudget_.LogSummary();
+
   for (int i = 0; i < alignmentCount_; ++i) {
     fpsMessage_[i].reset();
     msMessage_[i].reset();
@@ -119,6 +150,8 @@ OverlayBitmap::~OverlayBitmap()
   renderTarget_.Reset();
   textBrush_.Reset();
   helperLineBrush_.Reset();
+  graphStrokeStyle_.Reset();
+  graphGeometries_.clear();
   textFormat_.Reset();
   messageFormat_.Reset();
   stopValueFormat_.Reset();
@@ -291,9 +324,11 @@ void OverlayBitmap::CalcSize(int screenWidth, int screenHeight)
 
 void OverlayBitmap::Resize(int screenWidth, int screenHeight)
 {
+  std::lock_guard<std::mutex> lock(renderMutex_);
   screenWidth_ = screenWidth;
   screenHeight_ = screenHeight;
   UpdateScreenPosition();
+  fullRedraw_ = true;
 }
 
 void OverlayBitmap::UpdateScreenPosition()
@@ -327,18 +362,49 @@ void OverlayBitmap::UpdateScreenPosition()
 
 void OverlayBitmap::DrawOverlay()
 {
-  StartRendering();
-  Update();
-  FinishRendering();
-}
+  ApplyCostLevel();
+  NextFrame();
+
+  if (!asyncRendering_) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - lastRender_ >= std::chrono::steady_clock::duration(updateInterval_)) {
+      lastRender_ = now;
+      Render(frameData_);
+    }
+    else {
+      RenderBar();
+    }
+    NextDirtyRects() = dirtyRects_;
+    presentedPosition_ = screenPosition_;
+    return;
+  }
 
-void OverlayBitmap::StartRendering()
-{
-  renderTarget_->BeginDraw();
-  renderTarget_->SetTransform(D2D1::IdentityMatrix());
+  // pick up the latest frame of the render thread, the color bar changes with every present
+  const bool newFrame = AcquireFrame();
+  auto& frame = frames_[readFrame_];
+  const bool drawBar = RecordingState::GetInstance().IsBarOverlayShowing() && !frame.data.empty();
+  if (!newFrame && !drawBar) {
+    return;
+  }
+
+  auto& dirtyRects = NextDirtyRects();
+  if (newFrame) {
+    if (frame.renderCount == presentedRenderCount_ + 1) {
+      dirtyRects = frame.dirtyRects;
+    }
+    else {
+      dirtyRects.push_back(fullArea_.wic);
+    }
+    presentedRenderCount_ = frame.renderCount;
+    presentedPosition_ = frame.screenPosition;
+  }
+
+  if (drawBar) {
+    FillBar(frame);
+  }
 }
 
-void OverlayBitmap::Update()
+void OverlayBitmap::NextFrame()
 {
   const auto textureState = RecordingState::GetInstance().Update();
   if (RecordingState::GetInstance().Started()) {
@@ -349,67 +415,339 @@ void OverlayBitmap::Update()
     performanceCounter_.Stop();
   }
 
-  frameTimes_[currentFrame_] = frameInfo.frameTime;
+  std::lock_guard<std::mutex> lock(frameDataMutex_);
+  frameData_.frameInfo = frameInfo;
+  frameData_.captureResults = performanceCounter_.GetLastCaptureResults();
+  frameData_.textureState = textureState;
+  frameData_.currentFrame = (frameData_.currentFrame + 1) % frameTimeHistorySize_;
+  frameData_.frameTimes[frameData_.currentFrame] = frameInfo.frameTime;
+  frameData_.frameCount++;
+  frameData_.overlayCost = costBudget_.GetAverageCost();
+  frameData_.overlayGpuCost = costBudget_.GetAverageGpuCost();
+}
+
+void OverlayBitmap::ApplyCostLevel()
+{
+  const auto level = costBudget_.GetLevel();
+  if (level == appliedCostLevel_) {
+    return;
+  }
+  appliedCostLevel_ = level;
+
+  // the render thread keeps running, only its interval changes
+  if (level == OverlayCostBudget::Level::Full) {
+    SetUpdateRate(updateRate_);
+  }
+  else {
+    SetUpdateRate(updateRate_ > 0 ? std::max(updateRate_ / 2, 1u) : reducedUpdateRate_);
+  }
+  graphSuppressed_ = level == OverlayCostBudget::Level::NoGraph;
+}
+
+void OverlayBitmap::SetUpdateRate(unsigned int updateRate)
+{
+  if (updateRate == 0) {
+    updateInterval_ = 0;
+    return;
+  }
+  updateInterval_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(1.0 / updateRate))
+                        .count();
+}
+
+void OverlayBitmap::Render(const FrameData& frameData)
+{
+  StartRendering();
+  Update(frameData);
+  FinishRendering();
+}
+
+void OverlayBitmap::RenderBar()
+{
+  dirtyRects_.clear();
+  if (!barShowing_ || !RecordingState::GetInstance().IsBarOverlayShowing()) {
+    return;
+  }
+
+  StartRendering();
+  DrawBar();
+  FinishRendering();
+}
+
+void OverlayBitmap::StartRendering()
+{
+  if (!useSoftwareRasterizer_) {
+    renderTarget_->BeginDraw();
+    renderTarget_->SetTransform(D2D1::IdentityMatrix());
+    return;
+  }
+
+  // the rasterizer draws directly into the locked bitmap memory
+  UINT width = 0;
+  UINT height = 0;
+  HRESULT hr = bitmap_->GetSize(&width, &height);
+  const WICRect bitmapArea = {0, 0, static_cast<INT>(width), static_cast<INT>(height)};
+  if (SUCCEEDED(hr)) {
+    hr = bitmap_->Lock(&bitmapArea, WICBitmapLockWrite, &drawLock_);
+  }
+  UINT stride = 0;
+  UINT size = 0;
+  BYTE* data = nullptr;
+  if (SUCCEEDED(hr)) {
+    hr = drawLock_->GetStride(&stride);
+  }
+  if (SUCCEEDED(hr)) {
+    hr = drawLock_->GetDataPointer(&size, &data);
+  }
+  if (FAILED(hr)) {
+    g_messageLog.LogWarning("OverlayBitmap", "Bitmap lock for drawing failed, HRESULT", hr);
+    drawLock_.Reset();
+    rasterizer_.ResetTarget();
+    return;
+  }
+  rasterizer_.SetTarget(data, static_cast<int>(stride), bitmapArea.Width, bitmapArea.Height);
+}
 
+void OverlayBitmap::Update(const FrameData& frameData)
+{
   UpdateScreenPosition();
-  renderTarget_->Clear(clearColor_);  // clear full bitmap
-  if (RecordingState::GetInstance().IsOverlayShowing()) {
-    DrawFrameInfo(frameInfo);
-    DrawMessages(textureState);
+
+  // Hidden elements and a changed layout require clearing the full bitmap.
+  const bool overlayShowing = RecordingState::GetInstance().IsOverlayShowing();
+  const bool graphShowing =
+      RecordingState::GetInstance().IsGraphOverlayShowing() && !graphSuppressed_;
+  const bool barShowing = RecordingState::GetInstance().IsBarOverlayShowing();
+  if (overlayShowing != overlayShowing_ || graphShowing != graphShowing_ ||
+      barShowing != barShowing_ || currentAlignment_ != drawnAlignment_) {
+    fullRedraw_ = true;
+  }
+  overlayShowing_ = overlayShowing;
+  graphShowing_ = graphShowing;
+  barShowing_ = barShowing;
+  drawnAlignment_ = currentAlignment_;
+
+  dirtyRects_.clear();
+  if (fullRedraw_) {
+    // clear full bitmap
+    if (useSoftwareRasterizer_) {
+      rasterizer_.Clear(ToPixel(clearColor_));
+    }
+    else {
+      renderTarget_->Clear(clearColor_);
+    }
+    dirtyRects_.push_back(fullArea_.wic);
   }
-  if (RecordingState::GetInstance().IsGraphOverlayShowing()) {
-    DrawGraph();
+
+  if (overlayShowing) {
+    DrawFrameInfo(frameData.frameInfo);
+    DrawMessages(frameData);
   }
-  if (RecordingState::GetInstance().IsBarOverlayShowing()) {
+  if (graphShowing) {
+    DrawGraph(frameData);
+  }
+  // with a render thread the color bar is filled on present, as it has to change every frame
+  if (barShowing && !asyncRendering_) {
     DrawBar();
   }
 
-  currentFrame_ = (currentFrame_ + 1) % 512;
+  fullRedraw_ = false;
+  renderCount_++;
+}
+
+void OverlayBitmap::AddDirtyRect(const D2D1_RECT_F& area)
+{
+  if (fullRedraw_) {
+    // full area is already marked
+    return;
+  }
+
+  const auto& fullArea = fullArea_.wic;
+  const int left = std::max(fullArea.X, static_cast<int>(std::floor(area.left)));
+  const int top = std::max(fullArea.Y, static_cast<int>(std::floor(area.top)));
+  const int right = std::min(fullArea.X + fullArea.Width, static_cast<int>(std::ceil(area.right)));
+  const int bottom =
+      std::min(fullArea.Y + fullArea.Height, static_cast<int>(std::ceil(area.bottom)));
+  if (right > left && bottom > top) {
+    dirtyRects_.push_back({left, top, right - left, bottom - top});
+  }
+}
+
+std::vector<WICRect>& OverlayBitmap::NextDirtyRects()
+{
+  drawCount_++;
+  auto& dirtyRects = dirtyHistory_[drawCount_ % dirtyHistorySize_];
+  dirtyRects.clear();
+  return dirtyRects;
+}
+
+void OverlayBitmap::StartRenderThread(unsigned int updateRate)
+{
+  SetUpdateRate(updateRate);
+  renderThreadQuit_ = false;
+  asyncRendering_ = true;
+  renderThread_ = std::thread(&OverlayBitmap::RenderThreadProc, this);
+  g_messageLog.LogInfo("OverlayBitmap",
+                       "Render thread started, update rate " + std::to_string(updateRate) + " Hz");
+}
+
+void OverlayBitmap::StopRenderThread()
+{
+  if (!renderThread_.joinable()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(renderMutex_);
+    renderThreadQuit_ = true;
+  }
+  renderCondition_.notify_one();
+  renderThread_.join();
+}
+
+void OverlayBitmap::RenderThreadProc()
+{
+  std::unique_lock<std::mutex> lock(renderMutex_);
+  auto nextUpdate = std::chrono::steady_clock::now();
+  while (!renderThreadQuit_) {
+    {
+      std::lock_guard<std::mutex> frameDataLock(frameDataMutex_);
+      renderFrameData_ = frameData_;
+    }
+
+    Render(renderFrameData_);
+    PublishFrame();
+
+    // do not try to catch up if rasterization took longer than the interval
+    nextUpdate = std::max(nextUpdate + std::chrono::steady_clock::duration(updateInterval_),
+                          std::chrono::steady_clock::now());
+    renderCondition_.wait_until(lock, nextUpdate, [this]() { return renderThreadQuit_; });
+  }
+}
+
+void OverlayBitmap::PublishFrame()
+{
+  auto& frame = frames_[writeFrame_];
+  WICRect bitmapArea = fullArea_.wic;
+  {
+    ComPtr<IWICBitmapLock> lock;
+    HRESULT hr = bitmap_->Lock(&bitmapArea, WICBitmapLockRead, &lock);
+    if (FAILED(hr)) {
+      g_messageLog.LogWarning("OverlayBitmap", "Bitmap lock failed, HRESULT", hr);
+      return;
+    }
+
+    UINT size = 0;
+    BYTE* data = nullptr;
+    hr = lock->GetDataPointer(&size, &data);
+    if (SUCCEEDED(hr)) {
+      hr = lock->GetStride(&frame.stride);
+    }
+    if (FAILED(hr)) {
+      g_messageLog.LogWarning("OverlayBitmap", "Bitmap lock data access failed, HRESULT", hr);
+      return;
+    }
+    frame.data.assign(data, data + size);
+  }
+
+  frame.renderCount = renderCount_;
+  frame.dirtyRects = dirtyRects_;
+  frame.screenPosition = screenPosition_;
+  frame.alignment = currentAlignment_;
+
+  const int previousFrame = readyFrame_.exchange(writeFrame_ | freshFrameBit_);
+  writeFrame_ = previousFrame & ~freshFrameBit_;
+}
+
+bool OverlayBitmap::AcquireFrame()
+{
+  if ((readyFrame_.load() & freshFrameBit_) == 0) {
+    return false;
+  }
+
+  const int frame = readyFrame_.exchange(readFrame_);
+  readFrame_ = frame & ~freshFrameBit_;
+  return true;
+}
+
+void OverlayBitmap::FillBar(Frame& frame)
+{
+  // premultiplied BGRA, the colors of the sequence are opaque
+  const auto& color = colorBarSequence_[colorSequenceIndex_];
+  const UINT32 pixel = (static_cast<UINT32>(color.a * 255.0f) << 24) |
+                       (static_cast<UINT32>(color.r * 255.0f) << 16) |
+                       (static_cast<UINT32>(color.g * 255.0f) << 8) |
+                       static_cast<UINT32>(color.b * 255.0f);
+  colorSequenceIndex_ = (colorSequenceIndex_ + 1) % 16;
+
+  const auto& area = colorBarArea_[static_cast<int>(frame.alignment)];
+  const int left = static_cast<int>(area.left);
+  const int right = static_cast<int>(area.right);
+  const int bottom = std::min(static_cast<int>(area.bottom), fullArea_.wic.Height);
+  // the last row of the locked area is not padded to the stride
+  const size_t rows =
+      frame.stride > 0 ? (frame.data.size() + frame.stride - 1) / frame.stride : 0;
+  for (int y = static_cast<int>(area.top); y < bottom && y < static_cast<int>(rows); ++y) {
+    auto row = reinterpret_cast<UINT32*>(frame.data.data() + y * frame.stride);
+    std::fill(row + left, row + right, pixel);
+  }
+
+  dirtyHistory_[drawCount_ % dirtyHistorySize_].push_back(
+      {left, static_cast<int>(area.top), right - left, bottom - static_cast<int>(area.top)});
 }
 
 void OverlayBitmap::DrawFrameInfo(const GameOverlay::PerformanceCounter::FrameInfo& frameInfo)
 {
   const int alignment = static_cast<int>(currentAlignment_);
   // api
-  renderTarget_->PushAxisAlignedClip(apiArea_[alignment], D2D1_ANTIALIAS_MODE_ALIASED);
-  renderTarget_->Clear(messageBackgroundColor_);
-  apiMessage_[alignment]->WriteMessage(api_, L" API");
-  apiMessage_[alignment]->SetText(writeFactory_.Get(), textFormat_.Get());
-  apiMessage_[alignment]->Draw(renderTarget_.Get());
+  if (fullRedraw_) {
+    BeginArea(apiArea_[alignment], messageBackgroundColor_);
+    apiMessage_[alignment]->WriteMessage(api_.c_str(), L" API");
+    apiMessage_[alignment]->SetText(writeFactory_.Get(), textFormat_.Get(), &textGlyphs_);
+    DrawTextMessage(*apiMessage_[alignment]);
 
-  renderTarget_->PopAxisAlignedClip();
+    EndArea();
+  }
 
   // recording dot
-  renderTarget_->PushAxisAlignedClip(recordingArea_[alignment], D2D1_ANTIALIAS_MODE_ALIASED);
-  renderTarget_->Clear(fpsBackgroundColor_);
-  if (recording_) {
-    recordingMessage_[alignment]->WriteMessage(L"\x2022");
-  }
-  else {
-    recordingMessage_[alignment]->WriteMessage(L" ");
-  }
-  recordingMessage_[alignment]->SetText(writeFactory_.Get(), textFormat_.Get());
-  recordingMessage_[alignment]->Draw(renderTarget_.Get());
+  if (fullRedraw_ || recording_ != drawnRecording_) {
+    BeginArea(recordingArea_[alignment], fpsBackgroundColor_);
+    if (recording_) {
+      recordingMessage_[alignment]->WriteMessage(L"\x2022");
+    }
+    else {
+      recordingMessage_[alignment]->WriteMessage(L" ");
+    }
+    recordingMessage_[alignment]->SetText(writeFactory_.Get(), textFormat_.Get(), &textGlyphs_);
+    DrawTextMessage(*recordingMessage_[alignment]);
 
-  renderTarget_->PopAxisAlignedClip();
+    EndArea();
+    AddDirtyRect(recordingArea_[alignment]);
+    drawnRecording_ = recording_;
+  }
 
-  // fps counter
-  renderTarget_->PushAxisAlignedClip(fpsArea_[alignment], D2D1_ANTIALIAS_MODE_ALIASED);
-  renderTarget_->Clear(fpsBackgroundColor_);
-  fpsMessage_[alignment]->WriteMessage(frameInfo.fps, L" FPS");
-  fpsMessage_[alignment]->SetText(writeFactory_.Get(), textFormat_.Get());
-  fpsMessage_[alignment]->Draw(renderTarget_.Get());
+  // fps counter, only changes once per refresh interval of the performance counter
+  if (fullRedraw_ || frameInfo.fps != drawnFps_) {
+    BeginArea(fpsArea_[alignment], fpsBackgroundColor_);
+    fpsMessage_[alignment]->WriteMessage(frameInfo.fps, L" FPS");
+    fpsMessage_[alignment]->SetText(writeFactory_.Get(), textFormat_.Get(), &textGlyphs_);
+    DrawTextMessage(*fpsMessage_[alignment]);
 
-  renderTarget_->PopAxisAlignedClip();
+    EndArea();
+    AddDirtyRect(fpsArea_[alignment]);
+    drawnFps_ = frameInfo.fps;
+  }
 
   // ms counter
-  renderTarget_->PushAxisAlignedClip(msArea_[alignment], D2D1_ANTIALIAS_MODE_ALIASED);
-  renderTarget_->Clear(msBackgroundColor_);
-  msMessage_[alignment]->WriteMessage(frameInfo.ms, L" ms", precision_);
-  msMessage_[alignment]->SetText(writeFactory_.Get(), textFormat_.Get());
-  msMessage_[alignment]->Draw(renderTarget_.Get());
-
-  renderTarget_->PopAxisAlignedClip();
+  if (fullRedraw_ || frameInfo.ms != drawnMs_) {
+    BeginArea(msArea_[alignment], msBackgroundColor_);
+    msMessage_[alignment]->WriteMessage(frameInfo.ms, L" ms", precision_);
+    msMessage_[alignment]->SetText(writeFactory_.Get(), textFormat_.Get(), &textGlyphs_);
+    DrawTextMessage(*msMessage_[alignment]);
+
+    EndArea();
+    AddDirtyRect(msArea_[alignment]);
+    drawnMs_ = frameInfo.ms;
+  }
 }
 
 bool OverlayBitmap::HideOverlay()
@@ -418,94 +756,176 @@ bool OverlayBitmap::HideOverlay()
           RecordingState::GetInstance().IsOverlayDuringCaptureHidden());
 }
 
-void OverlayBitmap::DrawMessages(TextureState textureState)
+OverlayCostBudget& OverlayBitmap::GetCostBudget()
+{
+  return costBudget_;
+}
+
+void OverlayBitmap::DrawMessages(const FrameData& frameData)
 {
+  const auto textureState = frameData.textureState;
+  const bool messagesHidden = RecordingState::GetInstance().IsOverlayDuringCaptureHidden();
+  const bool liveStatistics =
+      textureState == TextureState::Default && (showFrameTimeLows_ || showOverlayCost_);
+  // the live statistics only change once per refresh interval of the performance counter
+  const auto& frameInfo = frameData.frameInfo;
+  const bool liveStatisticsChanged =
+      liveStatistics && (frameData.overlayCost != drawnOverlayCost_ ||
+                         frameData.overlayGpuCost != drawnOverlayGpuCost_ ||
+                         frameInfo.onePercentLowFPS != drawnOnePercentLowFPS_ ||
+                         frameInfo.pointOnePercentLowFPS != drawnPointOnePercentLowFPS_ ||
+                         frameInfo.frameTimePercentile != drawnFrameTimePercentile_);
+  if (!fullRedraw_ && textureState == drawnTextureState_ &&
+      messagesHidden == drawnMessagesHidden_ && !liveStatisticsChanged) {
+    return;
+  }
+  drawnTextureState_ = textureState;
+  drawnMessagesHidden_ = messagesHidden;
+  AddDirtyRect(messageArea_[static_cast<int>(currentAlignment_)]);
+
+  if (liveStatistics) {
+    DrawLiveStatistics(frameData);
+    return;
+  }
+
   if (textureState == TextureState::Default ||
       RecordingState::GetInstance().IsOverlayDuringCaptureHidden()) {
     const int alignment = static_cast<int>(currentAlignment_);
-    renderTarget_->PushAxisAlignedClip(messageArea_[alignment], D2D1_ANTIALIAS_MODE_ALIASED);
-    renderTarget_->Clear(clearColor_);
-    renderTarget_->PopAxisAlignedClip();
+    BeginArea(messageArea_[alignment], clearColor_);
+    EndArea();
     return;
   }
 
   const int alignment = static_cast<int>(currentAlignment_);
-  renderTarget_->PushAxisAlignedClip(messageArea_[alignment], D2D1_ANTIALIAS_MODE_ALIASED);
-  renderTarget_->Clear(messageBackgroundColor_);
+  BeginArea(messageArea_[alignment], messageBackgroundColor_);
   if (textureState == TextureState::Start &&
       !RecordingState::GetInstance().IsOverlayDuringCaptureHidden()) {
     stateMessage_[alignment]->WriteMessage(L"Capture Started");
-    stateMessage_[alignment]->SetText(writeFactory_.Get(), messageFormat_.Get());
-    stateMessage_[alignment]->Draw(renderTarget_.Get());
+    stateMessage_[alignment]->SetText(writeFactory_.Get(), messageFormat_.Get(), &messageGlyphs_);
+    DrawTextMessage(*stateMessage_[alignment]);
     recording_ = true;
   }
   else if (textureState == TextureState::Stop &&
            !RecordingState::GetInstance().IsOverlayDuringCaptureHidden()) {
-    const auto capture = performanceCounter_.GetLastCaptureResults();
+    const auto& capture = frameData.captureResults;
     stateMessage_[alignment]->WriteMessage(L"Capture Ended\n");
-    stateMessage_[alignment]->SetText(writeFactory_.Get(), messageFormat_.Get());
-    stateMessage_[alignment]->Draw(renderTarget_.Get());
+    stateMessage_[alignment]->SetText(writeFactory_.Get(), messageFormat_.Get(), &messageGlyphs_);
+    DrawTextMessage(*stateMessage_[alignment]);
 
     stopValueMessage_[alignment]->WriteMessage(capture.averageFPS, L"\n", precision_);
     stopValueMessage_[alignment]->WriteMessage(capture.averageMS, L"\n", precision_);
     stopValueMessage_[alignment]->WriteMessage(capture.frameTimePercentile, L"", precision_);
-    stopValueMessage_[alignment]->SetText(writeFactory_.Get(), stopValueFormat_.Get());
-    stopValueMessage_[alignment]->Draw(renderTarget_.Get());
+    stopValueMessage_[alignment]->SetText(writeFactory_.Get(), stopValueFormat_.Get(),
+                                          &stopValueGlyphs_);
+    DrawTextMessage(*stopValueMessage_[alignment]);
 
     stopMessage_[alignment]->WriteMessage(L"FPS Average\n");
     stopMessage_[alignment]->WriteMessage(L"ms  Average\n");
     stopMessage_[alignment]->WriteMessage(L"99th Percentile");
-    stopMessage_[alignment]->SetText(writeFactory_.Get(), stopMessageFormat_.Get());
-    stopMessage_[alignment]->Draw(renderTarget_.Get());
+    stopMessage_[alignment]->SetText(writeFactory_.Get(), stopMessageFormat_.Get(),
+                                     &stopMessageGlyphs_);
+    DrawTextMessage(*stopMessage_[alignment]);
     recording_ = false;
   }
-  renderTarget_->PopAxisAlignedClip();
+  EndArea();
 }
 
-void OverlayBitmap::DrawGraph()
+void OverlayBitmap::DrawLiveStatistics(const FrameData& frameData)
 {
+  const auto& frameInfo = frameData.frameInfo;
+  drawnOverlayCost_ = frameData.overlayCost;
+  drawnOverlayGpuCost_ = frameData.overlayGpuCost;
+  drawnOnePercentLowFPS_ = frameInfo.onePercentLowFPS;
+  drawnPointOnePercentLowFPS_ = frameInfo.pointOnePercentLowFPS;
+  drawnFrameTimePercentile_ = frameInfo.frameTimePercentile;
+
   const int alignment = static_cast<int>(currentAlignment_);
+  auto& values = *stopValueMessage_[alignment];
+  auto& labels = *stopMessage_[alignment];
+  // lows are 0 until the performance counter saw enough frames, the GPU time until the first
+  // timestamps were read back
+  const auto writeValue = [this, &values](float value, const wchar_t* separator) {
+    if (value > 0.0f) {
+      values.WriteMessage(value, separator, precision_);
+    }
+    else {
+      values.WriteMessage(L"-", separator);
+    }
+  };
+
+  BeginArea(messageArea_[alignment], messageBackgroundColor_);
+  if (showFrameTimeLows_) {
+    const wchar_t* lastSeparator = showOverlayCost_ ? L"\n" : L"";
+    writeValue(frameInfo.onePercentLowFPS, L"\n");
+    writeValue(frameInfo.pointOnePercentLowFPS, L"\n");
+    writeValue(frameInfo.frameTimePercentile, lastSeparator);
+    labels.WriteMessage(L"1% Low FPS\n");
+    labels.WriteMessage(L"0.1% Low FPS\n");
+    labels.WriteMessage(L"99th Percentile");
+    labels.WriteMessage(lastSeparator);
+  }
+  if (showOverlayCost_) {
+    const wchar_t* separator = showOverlayGpuCost_ ? L"\n" : L"";
+    values.WriteMessage(frameData.overlayCost, separator, precision_);
+    labels.WriteMessage(L"us  Overlay Cost");
+    labels.WriteMessage(separator);
+  }
+  if (showOverlayGpuCost_) {
+    writeValue(frameData.overlayGpuCost, L"");
+    labels.WriteMessage(L"us  Overlay GPU");
+  }
+  values.SetText(writeFactory_.Get(), stopValueFormat_.Get(), &stopValueGlyphs_);
+  DrawTextMessage(values);
+  labels.SetText(writeFactory_.Get(), stopMessageFormat_.Get(), &stopMessageGlyphs_);
+  DrawTextMessage(labels);
+  EndArea();
+}
 
-  renderTarget_->PushAxisAlignedClip(graphArea_[alignment], D2D1_ANTIALIAS_MODE_ALIASED);
-  renderTarget_->Clear(graphBackgroundColor_);
+void OverlayBitmap::DrawGraph(const FrameData& frameData)
+{
+  // the graph only scrolls when new frame times arrived
+  const UINT64 newFrames = frameData.frameCount - drawnFrameCount_;
+  if (!fullRedraw_ && newFrames == 0) {
+    return;
+  }
+  drawnFrameCount_ = frameData.frameCount;
 
-  renderTarget_->DrawLine(D2D1::Point2F(graphArea_[alignment].left, graphArea_[alignment].bottom),
-                          D2D1::Point2F(graphArea_[alignment].right, graphArea_[alignment].bottom),
-                          helperLineBrush_.Get());
-  renderTarget_->DrawLine(
-      D2D1::Point2F(graphArea_[alignment].left, graphArea_[alignment].bottom - 33.33f),
-      D2D1::Point2F(graphArea_[alignment].right, graphArea_[alignment].bottom - 33.33f),
-      helperLineBrush_.Get());
-  renderTarget_->DrawLine(
-      D2D1::Point2F(graphArea_[alignment].left, graphArea_[alignment].bottom - 66.66f),
-      D2D1::Point2F(graphArea_[alignment].right, graphArea_[alignment].bottom - 66.66f),
-      helperLineBrush_.Get());
-  renderTarget_->DrawLine(
-      D2D1::Point2F(graphArea_[alignment].left, graphArea_[alignment].bottom - 99.99f),
-      D2D1::Point2F(graphArea_[alignment].right, graphArea_[alignment].bottom - 99.99f),
-      helperLineBrush_.Get());
+  const int alignment = static_cast<int>(currentAlignment_);
+  const auto& graphArea = graphArea_[alignment];
 
-  points_[0] = D2D1::Point2F(graphArea_[alignment].left,
-                             graphArea_[alignment].bottom - frameTimes_[currentFrame_ % 512]);
-  float time = frameTimes_[((currentFrame_ + 512) - 1) % 512] * 0.2f;
+  // only the frame times since the last draw are appended, the history is added again if
+  // frames were missed
+  if (newFrames > static_cast<UINT64>(frameTimeHistorySize_)) {
+    graph_.Clear();
+  }
+  const int addedFrames = static_cast<int>(std::min<UINT64>(newFrames, frameTimeHistorySize_));
+  for (int i = addedFrames - 1; i >= 0; i--) {
+    graph_.Add(frameData.frameTimes[(frameData.currentFrame + frameTimeHistorySize_ - i) %
+                                    frameTimeHistorySize_]);
+  }
+  graph_.Trim(graphArea.right - graphArea.left);
 
-  for (int i = 1; i < 512; i++) {
-    points_[i] = D2D1::Point2F(
-        graphArea_[alignment].left + time,
-        graphArea_[alignment].bottom - frameTimes_[((currentFrame_ + 512) - i) % 512]);
-    time = time + frameTimes_[((currentFrame_ + 512) - i - 1) % 512] * 0.2f;
+  BeginArea(graphArea, graphBackgroundColor_);
 
-    renderTarget_->DrawLine(points_[i - 1], points_[i], textBrush_.Get());
-  }
+  DrawHelperLine(graphArea, graphArea.bottom);
+  DrawHelperLine(graphArea, graphArea.bottom - 33.33f);
+  DrawHelperLine(graphArea, graphArea.bottom - 66.66f);
+  DrawHelperLine(graphArea, graphArea.bottom - 99.99f);
 
-  renderTarget_->PopAxisAlignedClip();
+  DrawGraphLine(graphArea);
 
-  renderTarget_->PushAxisAlignedClip(graphLabelArea_[alignment], D2D1_ANTIALIAS_MODE_ALIASED);
-  renderTarget_->Clear(graphBackgroundColor_);
-  graphLabelMessage_[alignment]->WriteMessage(L"ms\n\n\n100\n\n\n66\n\n\n33\n\n\n0");
-  graphLabelMessage_[alignment]->SetText(writeFactory_.Get(), graphLabelMessagFormat_.Get());
-  graphLabelMessage_[alignment]->Draw(renderTarget_.Get());
-  renderTarget_->PopAxisAlignedClip();
+  EndArea();
+  AddDirtyRect(graphArea);
+
+  // the label is static, it is only cleared together with the full bitmap
+  if (fullRedraw_) {
+    BeginArea(graphLabelArea_[alignment], graphBackgroundColor_);
+    graphLabelMessage_[alignment]->WriteMessage(L"ms\n\n\n100\n\n\n66\n\n\n33\n\n\n0");
+    graphLabelMessage_[alignment]->SetText(writeFactory_.Get(), graphLabelMessagFormat_.Get(),
+                                           &graphLabelGlyphs_);
+    DrawTextMessage(*graphLabelMessage_[alignment]);
+    EndArea();
+  }
 }
 
 void OverlayBitmap::DrawBar()
@@ -513,17 +933,141 @@ void OverlayBitmap::DrawBar()
   const int alignment = static_cast<int>(currentAlignment_);
 
   // colored bar
-  renderTarget_->PushAxisAlignedClip(colorBarArea_[alignment], D2D1_ANTIALIAS_MODE_ALIASED);
-  renderTarget_->Clear(colorBarSequence_[colorSequenceIndex_]);
+  BeginArea(colorBarArea_[alignment], colorBarSequence_[colorSequenceIndex_]);
 
   colorSequenceIndex_ = (colorSequenceIndex_ + 1) % 16;
 
-  renderTarget_->PopAxisAlignedClip();
+  EndArea();
+  AddDirtyRect(colorBarArea_[alignment]);
+}
+
+void OverlayBitmap::BeginArea(const D2D1_RECT_F& area, const D2D1_COLOR_F& color)
+{
+  if (useSoftwareRasterizer_) {
+    rasterizer_.PushClip({area.left, area.top, area.right, area.bottom});
+    rasterizer_.Clear(ToPixel(color));
+  }
+  else {
+    renderTarget_->PushAxisAlignedClip(area, D2D1_ANTIALIAS_MODE_ALIASED);
+    renderTarget_->Clear(color);
+  }
+}
+
+void OverlayBitmap::EndArea()
+{
+  if (useSoftwareRasterizer_) {
+    rasterizer_.PopClip();
+  }
+  else {
+    renderTarget_->PopAxisAlignedClip();
+  }
+}
+
+void OverlayBitmap::DrawTextMessage(TextMessage& message)
+{
+  if (useSoftwareRasterizer_) {
+    message.Draw(rasterizer_);
+  }
+  else {
+    message.Draw(renderTarget_.Get());
+  }
+}
+
+void OverlayBitmap::DrawHelperLine(const D2D1_RECT_F& area, float y)
+{
+  const auto start = D2D1::Point2F(area.left, y);
+  const auto end = D2D1::Point2F(area.right, y);
+  if (useSoftwareRasterizer_) {
+    rasterizer_.DrawLine({start.x, start.y}, {end.x, end.y}, ToPixel(numberColor_));
+  }
+  else {
+    renderTarget_->DrawLine(start, end, helperLineBrush_.Get());
+  }
 }
 
-int OverlayBitmap::GetLagIndicatorHotkey()
+void OverlayBitmap::DrawGraphLine(const D2D1_RECT_F& area)
 {
-  return RecordingState::GetInstance().GetLagIndicatorHotkey();
+  const auto& chunks = graph_.GetChunks();
+  if (useSoftwareRasterizer_) {
+    for (const auto& chunk : chunks) {
+      const float left = area.left + graph_.GetOffset(chunk);
+      graphPoints_.clear();
+      for (const auto& point : chunk.points) {
+        graphPoints_.push_back(D2D1::Point2F(left - point.x, area.bottom - point.y));
+      }
+      rasterizer_.DrawPolyline(graphPoints_.data(), graphPoints_.size(), ToPixel(fontColor_));
+    }
+    return;
+  }
+
+  // release the geometry of chunks which scrolled out, ids of new chunks are always larger
+  while (!graphGeometries_.empty() &&
+         (chunks.empty() || graphGeometries_.front().id < chunks.front().id)) {
+    graphGeometries_.pop_front();
+  }
+
+  D2D1_MATRIX_3X2_F transform;
+  renderTarget_->GetTransform(&transform);
+  for (size_t i = 0; i < chunks.size(); i++) {
+    const auto& chunk = chunks[i];
+    if (i == graphGeometries_.size()) {
+      graphGeometries_.emplace_back();
+    }
+
+    // full chunks keep their geometry, only the newest one is rebuilt while it grows
+    auto& cached = graphGeometries_[i];
+    if (cached.id != chunk.id || cached.pointCount != chunk.points.size()) {
+      cached.id = chunk.id;
+      cached.geometry = CreateGraphGeometry(chunk);
+      cached.pointCount = cached.geometry ? chunk.points.size() : 0;
+    }
+    if (!cached.geometry) {
+      continue;
+    }
+
+    // chunk coordinates grow towards newer samples and larger frame times
+    const auto chunkTransform = D2D1::Matrix3x2F(-1.0f, 0.0f, 0.0f, -1.0f,
+                                                 area.left + graph_.GetOffset(chunk), area.bottom);
+    renderTarget_->SetTransform(chunkTransform *
+                                *D2D1::Matrix3x2F::ReinterpretBaseType(&transform));
+    renderTarget_->DrawGeometry(cached.geometry.Get(), textBrush_.Get(), 1.0f,
+                                graphStrokeStyle_.Get());
+  }
+  renderTarget_->SetTransform(transform);
+}
+
+Microsoft::WRL::ComPtr<ID2D1PathGeometry> OverlayBitmap::CreateGraphGeometry(
+    const FrameTimeGraph::Chunk& chunk)
+{
+  if (chunk.points.size() < 2) {
+    return nullptr;
+  }
+
+  Microsoft::WRL::ComPtr<ID2D1PathGeometry> graphGeometry;
+  Microsoft::WRL::ComPtr<ID2D1GeometrySink> graphSink;
+  HRESULT hr = d2dFactory_->CreatePathGeometry(&graphGeometry);
+  if (SUCCEEDED(hr)) {
+    hr = graphGeometry->Open(&graphSink);
+  }
+  if (SUCCEEDED(hr)) {
+    const auto& points = chunk.points;
+    graphSink->BeginFigure(D2D1::Point2F(points[0].x, points[0].y), D2D1_FIGURE_BEGIN_HOLLOW);
+    for (size_t i = 1; i < points.size(); i++) {
+      graphSink->AddLine(D2D1::Point2F(points[i].x, points[i].y));
+    }
+    graphSink->EndFigure(D2D1_FIGURE_END_OPEN);
+    hr = graphSink->Close();
+  }
+  if (FAILED(hr)) {
+    g_messageLog.LogWarning("OverlayBitmap", "Graph geometry creation failed, HRESULT", hr);
+    return nullptr;
+  }
+  return graphGeometry;
+}
+
+UINT32 OverlayBitmap::ToPixel(const D2D1_COLOR_F& color)
+{
+  return SoftwareRasterizer::ToPixel(color.r, color.g, color.b, color.a);
 }
 
 bool OverlayBitmap::GetLagIndicatorVisibility()
@@ -533,6 +1077,12 @@ bool OverlayBitmap::GetLagIndicatorVisibility()
 
 void OverlayBitmap::FinishRendering()
 {
+  if (useSoftwareRasterizer_) {
+    rasterizer_.ResetTarget();
+    drawLock_.Reset();
+    return;
+  }
+
   HRESULT hr = renderTarget_->EndDraw();
   if (FAILED(hr)) {
     g_messageLog.LogWarning("OverlayBitmap", "EndDraw failed, HRESULT", hr);
@@ -541,6 +1091,18 @@ void OverlayBitmap::FinishRendering()
 
 OverlayBitmap::RawData OverlayBitmap::GetBitmapDataRead()
 {
+  if (asyncRendering_) {
+    // the frame acquired last is owned by the present thread until the next DrawOverlay
+    auto& frame = frames_[readFrame_];
+    RawData rawData = {};
+    if (!frame.data.empty()) {
+      rawData.dataPtr = frame.data.data();
+      rawData.size = static_cast<UINT>(frame.data.size());
+      rawData.stride = frame.stride;
+    }
+    return rawData;
+  }
+
   if (bitmapLock_) {
     g_messageLog.LogWarning("OverlayBitmap", "Bitmap lock was not released");
   }
@@ -557,6 +1119,12 @@ OverlayBitmap::RawData OverlayBitmap::GetBitmapDataRead()
   hr = bitmapLock_->GetDataPointer(&rawData.size, &rawData.dataPtr);
   if (FAILED(hr)) {
     g_messageLog.LogWarning("OverlayBitmap", "Bitmap lock GetDataPointer failed, HRESULT", hr);
+    return {};
+  }
+
+  hr = bitmapLock_->GetStride(&rawData.stride);
+  if (FAILED(hr)) {
+    g_messageLog.LogWarning("OverlayBitmap", "Bitmap lock GetStride failed, HRESULT", hr);
     rawData = {};
   }
   return rawData;
@@ -568,10 +1136,30 @@ int OverlayBitmap::GetFullWidth() const { return fullWidth_ * 2; }
 
 int OverlayBitmap::GetFullHeight() const { return screenHeight_; }
 
-OverlayBitmap::Position OverlayBitmap::GetScreenPos() const { return screenPosition_; }
+OverlayBitmap::Position OverlayBitmap::GetScreenPos() const { return presentedPosition_; }
 
 const D2D1_RECT_F& OverlayBitmap::GetCopyArea() const { return fullArea_.d2d1; }
 
+void OverlayBitmap::GetDirtyRects(UINT64 drawCount, std::vector<WICRect>& rects) const
+{
+  rects.clear();
+  if (drawCount == drawCount_) {
+    return;
+  }
+
+  if (drawCount == 0 || drawCount > drawCount_ || drawCount_ - drawCount > dirtyHistorySize_) {
+    rects.push_back(fullArea_.wic);
+    return;
+  }
+
+  for (UINT64 i = drawCount + 1; i <= drawCount_; ++i) {
+    const auto& dirtyRects = dirtyHistory_[i % dirtyHistorySize_];
+    rects.insert(rects.end(), dirtyRects.begin(), dirtyRects.end());
+  }
+}
+
+UINT64 OverlayBitmap::GetDrawCount() const { return drawCount_; }
+
 VkFormat OverlayBitmap::GetVKFormat() const { return VK_FORMAT_B8G8R8A8_UNORM; }
 
 bool OverlayBitmap::InitFactories()
@@ -638,6 +1226,16 @@ bool OverlayBitmap::InitBitmap()
     return false;
   }
 
+  // bevel joins keep the spikes of the graph polyline as sharp as separate lines
+  hr = d2dFactory_->CreateStrokeStyle(
+      D2D1::StrokeStyleProperties(D2D1_CAP_STYLE_FLAT, D2D1_CAP_STYLE_FLAT, D2D1_CAP_STYLE_FLAT,
+                                  D2D1_LINE_JOIN_BEVEL),
+      nullptr, 0, &graphStrokeStyle_);
+  if (FAILED(hr)) {
+    g_messageLog.LogError("OverlayBitmap", "CreateStrokeStyle failed, HRESULT", hr);
+    return false;
+  }
+
   return true;
 }
 
@@ -656,6 +1254,19 @@ bool OverlayBitmap::InitText()
   graphLabelMessagFormat_ =
       CreateTextFormat(8.0f, DWRITE_TEXT_ALIGNMENT_CENTER, DWRITE_PARAGRAPH_ALIGNMENT_FAR);
 
+  const auto initGlyphs = [this](GlyphTextRenderer& glyphs, IDWriteTextFormat* format) {
+    if (format &&
+        !glyphs.Init(writeFactory_.Get(), iwicFactory_.Get(), d2dFactory_.Get(), format)) {
+      g_messageLog.LogWarning("OverlayBitmap",
+                              "Glyph atlas creation failed, falling back to DirectWrite");
+    }
+  };
+  initGlyphs(textGlyphs_, textFormat_.Get());
+  initGlyphs(messageGlyphs_, messageFormat_.Get());
+  initGlyphs(stopValueGlyphs_, stopValueFormat_.Get());
+  initGlyphs(stopMessageGlyphs_, stopMessageFormat_.Get());
+  initGlyphs(graphLabelGlyphs_, graphLabelMessagFormat_.Get());
+
   InitTextForAlignment(Alignment::LowerLeft);
   InitTextForAlignment(Alignment::LowerRight);
   InitTextForAlignment(Alignment::UpperLeft);
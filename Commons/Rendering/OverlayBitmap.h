@@ -27,10 +27,21 @@
 #include <vulkan/vulkan.h>
 #include <wincodec.h>
 #include <wrl.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "../Recording/PerformanceCounter.hpp"
 #include "../Recording/RecordingState.h"
+#include "FrameTimeGraph.h"
+#include "GlyphTextRenderer.h"
+#include "OverlayCostBudget.h"
+#include "SoftwareRasterizer.h"
 #include "TextMessage.h"
 
 // Render overlay text with background into a bitmap.
@@ -44,6 +55,7 @@ public:
   {
     unsigned char* dataPtr = nullptr;
     UINT size = 0;
+    UINT stride = 0;
     
     RawData();
   };
@@ -66,6 +78,8 @@ public:
 
   bool Init(int screenWidth, int screenHeight, API api);
   void Resize(int screenWidth, int screenHeight);
+  // Called once per presented frame. Updates the frame statistics and rasterizes the overlay,
+  // or picks up the latest bitmap of the render thread if an update rate is configured.
   void DrawOverlay();
 
   // Locks the bitmap data and returns a pointer to it, UnlockBitmapData needs to be called
@@ -77,13 +91,20 @@ public:
   int GetFullHeight() const;
   Position GetScreenPos() const;
   const D2D1_RECT_F& GetCopyArea() const;
+  // Regions of the copy area which changed since the given draw count, in pixels.
+  // Empty if the bitmap did not change, the full area if the draw count is 0 or too old.
+  void GetDirtyRects(UINT64 drawCount, std::vector<WICRect>& rects) const;
+  // Incremented whenever the bitmap changes, consumers remember it after uploading.
+  UINT64 GetDrawCount() const;
   VkFormat GetVKFormat() const;
 
-  int GetLagIndicatorHotkey();
   bool GetLagIndicatorVisibility();
 
   bool HideOverlay();
 
+  // Measured around the present hooks of the backends, see OverlayCostScope.
+  OverlayCostBudget& GetCostBudget();
+
 private:
   struct Area 
   {
@@ -99,6 +120,33 @@ private:
     LowerRight // = 3
   };
 
+  // Frame times kept for the graph, enough to fill its width at very high frame rates.
+  static const int frameTimeHistorySize_ = 2048;
+
+  // Frame statistics of the present thread used for rasterization.
+  struct FrameData
+  {
+    GameOverlay::PerformanceCounter::FrameInfo frameInfo;
+    GameOverlay::PerformanceCounter::CaptureResults captureResults;
+    TextureState textureState = TextureState::Default;
+    float frameTimes[frameTimeHistorySize_] = {};
+    int currentFrame = 0;
+    UINT64 frameCount = 0;
+    float overlayCost = 0.0f;
+    float overlayGpuCost = 0.0f;
+  };
+
+  // CPU copy of a rasterized bitmap, triple buffered between render and present thread.
+  struct Frame
+  {
+    std::vector<unsigned char> data;
+    UINT stride = 0;
+    UINT64 renderCount = 0;
+    std::vector<WICRect> dirtyRects;
+    Position screenPosition = {};
+    Alignment alignment = Alignment::UpperLeft;
+  };
+
   void CalcSize(int screenWidth, int screenHeight);
   bool InitFactories();
   bool InitBitmap();
@@ -106,14 +154,40 @@ private:
   void UpdateScreenPosition();
   void InitTextForAlignment(Alignment alignment);
 
-  void Update();
+  void NextFrame();
+  void Render(const FrameData& frameData);
+  // Only the color bar changes on presents skipped by a reduced update rate.
+  void RenderBar();
+  void ApplyCostLevel();
+  void SetUpdateRate(unsigned int updateRate);
+  void Update(const FrameData& frameData);
   void StartRendering();
   void DrawFrameInfo(const GameOverlay::PerformanceCounter::FrameInfo& frameInfo);
-  void DrawMessages(TextureState textureState);
-  void DrawGraph();
+  void DrawMessages(const FrameData& frameData);
+  // Optional lows and overlay cost, shown in the message area while there is no capture message.
+  void DrawLiveStatistics(const FrameData& frameData);
+  void DrawGraph(const FrameData& frameData);
   void DrawBar();
   //void DrawLagIndicator(bool lagIndicatorState);
   void FinishRendering();
+  // Drawing primitives of the overlay, either with Direct2D or the software rasterizer.
+  void BeginArea(const D2D1_RECT_F& area, const D2D1_COLOR_F& color);
+  void EndArea();
+  void DrawTextMessage(TextMessage& message);
+  void DrawHelperLine(const D2D1_RECT_F& area, float y);
+  void DrawGraphLine(const D2D1_RECT_F& area);
+  Microsoft::WRL::ComPtr<ID2D1PathGeometry> CreateGraphGeometry(
+      const FrameTimeGraph::Chunk& chunk);
+  static UINT32 ToPixel(const D2D1_COLOR_F& color);
+  void AddDirtyRect(const D2D1_RECT_F& area);
+  std::vector<WICRect>& NextDirtyRects();
+
+  void StartRenderThread(unsigned int updateRate);
+  void StopRenderThread();
+  void RenderThreadProc();
+  void PublishFrame();
+  bool AcquireFrame();
+  void FillBar(Frame& frame);
 
   IDWriteTextFormat* CreateTextFormat(float size, DWRITE_TEXT_ALIGNMENT textAlignment,
                                       DWRITE_PARAGRAPH_ALIGNMENT paragraphAlignment);
@@ -127,13 +201,26 @@ private:
   static const D2D1_COLOR_F numberColor_;
   static const D2D1_COLOR_F recordingColor_;
   static const D2D1_COLOR_F colorBarSequence_[];
+  // Update rate without render thread once the cost budget is exceeded.
+  static const unsigned int reducedUpdateRate_;
 
   GameOverlay::PerformanceCounter performanceCounter_;
 
+  OverlayCostBudget costBudget_;
+  OverlayCostBudget::Level appliedCostLevel_ = OverlayCostBudget::Level::Full;
+  // configured overlayUpdateRate, 0 renders with every present
+  unsigned int updateRate_ = 0;
+  std::atomic<bool> graphSuppressed_{false};
+  bool showOverlayCost_ = false;
+  // GPU time of the overlay pass, reported by the backends through the cost budget
+  bool showOverlayGpuCost_ = false;
+  bool showFrameTimeLows_ = false;
+
   Microsoft::WRL::ComPtr<ID2D1Factory> d2dFactory_;
   Microsoft::WRL::ComPtr<ID2D1RenderTarget> renderTarget_;
   Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> textBrush_;
   Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> helperLineBrush_;
+  Microsoft::WRL::ComPtr<ID2D1StrokeStyle> graphStrokeStyle_;
 
   Microsoft::WRL::ComPtr<IDWriteFactory> writeFactory_;
   Microsoft::WRL::ComPtr<IDWriteTextFormat> textFormat_;
@@ -143,10 +230,23 @@ private:
   Microsoft::WRL::ComPtr<IDWriteTextFormat> recordingMessageFormat_;
   Microsoft::WRL::ComPtr<IDWriteTextFormat> graphLabelMessagFormat_;
 
+  // glyph atlases of the text formats, the messages fall back to DirectWrite without them
+  GlyphTextRenderer textGlyphs_;
+  GlyphTextRenderer messageGlyphs_;
+  GlyphTextRenderer stopValueGlyphs_;
+  GlyphTextRenderer stopMessageGlyphs_;
+  GlyphTextRenderer graphLabelGlyphs_;
+
   Microsoft::WRL::ComPtr<IWICImagingFactory> iwicFactory_;
   Microsoft::WRL::ComPtr<IWICBitmap> bitmap_;
   Microsoft::WRL::ComPtr<IWICBitmapLock> bitmapLock_;
 
+  // Alternative to Direct2D selected with softwareOverlayRasterizer, draws while the bitmap
+  // is locked with drawLock_.
+  SoftwareRasterizer rasterizer_;
+  Microsoft::WRL::ComPtr<IWICBitmapLock> drawLock_;
+  bool useSoftwareRasterizer_ = false;
+
   static const int alignmentCount_ = 4;
   std::unique_ptr<TextMessage> fpsMessage_[alignmentCount_];
   std::unique_ptr<TextMessage> msMessage_[alignmentCount_];
@@ -184,13 +284,74 @@ private:
 
   int colorSequenceIndex_ = 0;
 
-  D2D1_POINT_2F points_[512];
-  float frameTimes_[512] = {};
-  int currentFrame_ = 0;
+  // Geometry of a graph chunk, kept until the chunk scrolls out of the graph.
+  struct GraphGeometry
+  {
+    UINT64 id = 0;
+    size_t pointCount = 0;
+    Microsoft::WRL::ComPtr<ID2D1PathGeometry> geometry;
+  };
+
+  // visible part of the frame time graph, one pixel per 5 ms, in chunks of 64 points
+  FrameTimeGraph graph_{0.2f, 64};
+  // in the order of the graph chunks
+  std::deque<GraphGeometry> graphGeometries_;
+  // screen points of a chunk for the software rasterizer
+  std::vector<D2D1_POINT_2F> graphPoints_;
 
   bool coInitialized_ = false;
   Alignment currentAlignment_ = Alignment::UpperLeft;
 
   bool recording_ = false;
   std::wstring api_;
+
+  // Dirty region tracking, elements are only redrawn if their content changed.
+  // The regions of the last draws are kept for consumers which skipped updates.
+  static const int dirtyHistorySize_ = 4;
+  std::vector<WICRect> dirtyRects_;
+  std::vector<WICRect> dirtyHistory_[dirtyHistorySize_];
+  UINT64 drawCount_ = 0;
+  Position presentedPosition_ = {};
+  bool fullRedraw_ = true;
+  bool overlayShowing_ = false;
+  bool graphShowing_ = false;
+  bool barShowing_ = false;
+  Alignment drawnAlignment_ = Alignment::UpperLeft;
+  bool drawnRecording_ = false;
+  std::int32_t drawnFps_ = 0;
+  float drawnMs_ = 0.0f;
+  TextureState drawnTextureState_ = TextureState::Default;
+  bool drawnMessagesHidden_ = false;
+  float drawnOverlayCost_ = 0.0f;
+  float drawnOverlayGpuCost_ = 0.0f;
+  float drawnOnePercentLowFPS_ = 0.0f;
+  float drawnPointOnePercentLowFPS_ = 0.0f;
+  float drawnFrameTimePercentile_ = 0.0f;
+  UINT64 drawnFrameCount_ = 0;
+
+  // Frame statistics written by the present thread, guarded by frameDataMutex_.
+  FrameData frameData_;
+  std::mutex frameDataMutex_;
+
+  // Optional render thread rasterizing the overlay at a fixed rate, renderMutex_ guards
+  // the rasterization state against Resize.
+  std::thread renderThread_;
+  std::mutex renderMutex_;
+  std::condition_variable renderCondition_;
+  // Interval between rasterizations in steady_clock ticks, lowered by the present thread
+  // when the cost budget is exceeded. Without render thread 0 renders with every present.
+  std::atomic<std::chrono::steady_clock::rep> updateInterval_{0};
+  std::chrono::steady_clock::time_point lastRender_;
+  FrameData renderFrameData_;
+  bool renderThreadQuit_ = false;
+  bool asyncRendering_ = false;
+  UINT64 renderCount_ = 0;
+
+  // Frames are exchanged through readyFrame_, the fresh bit marks an unread frame.
+  static const int freshFrameBit_ = 4;
+  Frame frames_[3];
+  std::atomic<int> readyFrame_{1};
+  int writeFrame_ = 0;
+  int readFrame_ = 2;
+  UINT64 presentedRenderCount_ = 0;
 };
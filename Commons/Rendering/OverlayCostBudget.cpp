@@ -0,0 +1,169 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "OverlayCostBudget.h"
+
+#include <string>
+
+#include "../Logging/MessageLog.h"
+
+const float OverlayCostBudget::windowSeconds_ = 1.0f;
+const float OverlayCostBudget::recoveryFactor_ = 0.5f;
+const int OverlayCostBudget::recoveryWindows_ = 5;
+
+namespace {
+const char* GetLevelName(OverlayCostBudget::Level level)
+{
+  switch (level) {
+    case OverlayCostBudget::Level::Full:
+      return "full";
+    case OverlayCostBudget::Level::ReducedUpdateRate:
+      return "reduced update rate";
+    case OverlayCostBudget::Level::NoGraph:
+      return "reduced update rate without graph";
+    default:
+      return "unknown";
+  }
+}
+}  // namespace
+
+OverlayCostBudget::OverlayCostBudget()
+{
+  LARGE_INTEGER frequency;
+  QueryPerformanceFrequency(&frequency);
+  frequency_ = frequency.QuadPart;
+}
+
+void OverlayCostBudget::SetBudget(unsigned int microseconds)
+{
+  budget_ = static_cast<float>(microseconds);
+  if (microseconds > 0) {
+    g_messageLog.LogInfo("OverlayCostBudget",
+                         "Budget " + std::to_string(microseconds) + " us per present");
+  }
+}
+
+void OverlayCostBudget::BeginPresent()
+{
+  LARGE_INTEGER now;
+  QueryPerformanceCounter(&now);
+  presentStart_ = now.QuadPart;
+  if (windowStart_ == 0) {
+    windowStart_ = presentStart_;
+  }
+}
+
+void OverlayCostBudget::EndPresent()
+{
+  LARGE_INTEGER now;
+  QueryPerformanceCounter(&now);
+  const LONGLONG ticks = now.QuadPart - presentStart_;
+  windowTicks_ += ticks;
+  windowPresents_++;
+  totalTicks_ += ticks;
+  totalPresents_++;
+  if (ticks > maxTicks_) {
+    maxTicks_ = ticks;
+  }
+
+  if (now.QuadPart - windowStart_ >= static_cast<LONGLONG>(windowSeconds_ * frequency_)) {
+    EvaluateWindow(now.QuadPart);
+  }
+}
+
+void OverlayCostBudget::AddGpuCost(float microseconds)
+{
+  windowGpuCost_ += microseconds;
+  windowGpuSamples_++;
+  totalGpuCost_ += microseconds;
+  totalGpuSamples_++;
+  if (microseconds > maxGpuCost_) {
+    maxGpuCost_ = microseconds;
+  }
+}
+
+void OverlayCostBudget::EvaluateWindow(LONGLONG now)
+{
+  averageCost_ = ToMicroseconds(static_cast<double>(windowTicks_) / windowPresents_);
+  windowStart_ = now;
+  windowTicks_ = 0;
+  windowPresents_ = 0;
+  if (windowGpuSamples_ > 0) {
+    averageGpuCost_ = static_cast<float>(windowGpuCost_ / windowGpuSamples_);
+    windowGpuCost_ = 0.0;
+    windowGpuSamples_ = 0;
+  }
+
+  if (budget_ <= 0.0f) {
+    return;
+  }
+
+  const auto previousLevel = level_;
+  if (averageCost_ > budget_) {
+    lowCostWindows_ = 0;
+    if (level_ != Level::NoGraph) {
+      level_ = static_cast<Level>(static_cast<int>(level_) + 1);
+    }
+  }
+  else if (averageCost_ < budget_ * recoveryFactor_) {
+    if (level_ != Level::Full && ++lowCostWindows_ >= recoveryWindows_) {
+      level_ = static_cast<Level>(static_cast<int>(level_) - 1);
+      lowCostWindows_ = 0;
+    }
+  }
+  else {
+    lowCostWindows_ = 0;
+  }
+
+  if (level_ != previousLevel) {
+    g_messageLog.LogInfo("OverlayCostBudget",
+                         "Average cost " + std::to_string(averageCost_) + " us, detail level " +
+                             GetLevelName(level_));
+  }
+}
+
+float OverlayCostBudget::ToMicroseconds(double ticks) const
+{
+  return static_cast<float>(ticks * 1000000.0 / frequency_);
+}
+
+void OverlayCostBudget::LogSummary() const
+{
+  if (totalPresents_ == 0) {
+    return;
+  }
+
+  g_messageLog.LogInfo(
+      "OverlayCostBudget",
+      "Cost per present: average " +
+          std::to_string(ToMicroseconds(static_cast<double>(totalTicks_) / totalPresents_)) +
+          " us, max " + std::to_string(ToMicroseconds(static_cast<double>(maxTicks_))) +
+          " us, " + std::to_string(totalPresents_) + " presents");
+
+  if (totalGpuSamples_ > 0) {
+    g_messageLog.LogInfo("OverlayCostBudget",
+                         "GPU time of the overlay pass: average " +
+                             std::to_string(static_cast<float>(totalGpuCost_ / totalGpuSamples_)) +
+                             " us, max " + std::to_string(maxGpuCost_) + " us, " +
+                             std::to_string(totalGpuSamples_) + " samples");
+  }
+}
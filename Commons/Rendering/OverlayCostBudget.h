@@ -0,0 +1,106 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <windows.h>
+
+// Measures the CPU time the overlay adds to each present with QueryPerformanceCounter and
+// decides how much detail the overlay can afford. The average cost is evaluated once per
+// measurement window; above the budget the overlay degrades by one level, it only recovers
+// after several windows well below the budget to avoid oscillating between levels.
+class OverlayCostBudget final {
+ public:
+  enum class Level {
+    Full,
+    ReducedUpdateRate,
+    NoGraph
+  };
+
+  OverlayCostBudget();
+  OverlayCostBudget(const OverlayCostBudget&) = delete;
+  OverlayCostBudget& operator=(const OverlayCostBudget&) = delete;
+
+  // Average cost per present in microseconds, 0 only measures without degrading.
+  void SetBudget(unsigned int microseconds);
+
+  void BeginPresent();
+  void EndPresent();
+
+  // Only changes at the end of a measurement window, read by the present thread.
+  Level GetLevel() const { return level_; }
+  // Average cost per present of the last measurement window in microseconds.
+  float GetAverageCost() const { return averageCost_; }
+
+  // GPU time of the overlay pass read back from timestamp queries, reported by the present
+  // thread once the results are available. Only measured, it does not change the level.
+  void AddGpuCost(float microseconds);
+  // Average GPU time of the last measurement window in microseconds, 0 without timestamps.
+  float GetAverageGpuCost() const { return averageGpuCost_; }
+  void LogSummary() const;
+
+ private:
+  void EvaluateWindow(LONGLONG now);
+  float ToMicroseconds(double ticks) const;
+
+  static const float windowSeconds_;
+  // Fraction of the budget the cost has to stay below for recoveryWindows_ to recover.
+  static const float recoveryFactor_;
+  static const int recoveryWindows_;
+
+  LONGLONG frequency_ = 1;
+  LONGLONG presentStart_ = 0;
+  LONGLONG windowStart_ = 0;
+  LONGLONG windowTicks_ = 0;
+  UINT64 windowPresents_ = 0;
+  LONGLONG totalTicks_ = 0;
+  LONGLONG maxTicks_ = 0;
+  UINT64 totalPresents_ = 0;
+
+  double windowGpuCost_ = 0.0;
+  UINT64 windowGpuSamples_ = 0;
+  double totalGpuCost_ = 0.0;
+  float maxGpuCost_ = 0.0f;
+  UINT64 totalGpuSamples_ = 0;
+
+  float budget_ = 0.0f;
+  float averageCost_ = 0.0f;
+  float averageGpuCost_ = 0.0f;
+  int lowCostWindows_ = 0;
+  Level level_ = Level::Full;
+};
+
+// Measures the enclosing scope of a present hook.
+class OverlayCostScope final {
+ public:
+  explicit OverlayCostScope(OverlayCostBudget& budget) : budget_(budget)
+  {
+    budget_.BeginPresent();
+  }
+  ~OverlayCostScope() { budget_.EndPresent(); }
+
+  OverlayCostScope(const OverlayCostScope&) = delete;
+  OverlayCostScope& operator=(const OverlayCostScope&) = delete;
+
+ private:
+  OverlayCostBudget& budget_;
+};
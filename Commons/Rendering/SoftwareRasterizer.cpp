@@ -0,0 +1,300 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// SOFTWARE_RASTERIZER_SCALAR builds only the scalar path, the tests run both paths
+#if !defined(SOFTWARE_RASTERIZER_SCALAR) && \
+    (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+#define SOFTWARE_RASTERIZER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// a * b / 255, rounded and exact for all 8 bit inputs
+inline uint32_t MulDiv255(uint32_t a, uint32_t b)
+{
+  const uint32_t t = a * b + 128;
+  return (t + (t >> 8)) >> 8;
+}
+
+inline uint32_t ScalePixel(uint32_t color, uint32_t coverage)
+{
+  uint32_t result = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    result |= MulDiv255((color >> shift) & 0xFF, coverage) << shift;
+  }
+  return result;
+}
+
+// premultiplied source over destination
+inline uint32_t BlendPixels(uint32_t destination, uint32_t source)
+{
+  const uint32_t inverseAlpha = 255 - (source >> 24);
+  uint32_t result = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    const uint32_t channel =
+        ((source >> shift) & 0xFF) + MulDiv255((destination >> shift) & 0xFF, inverseAlpha);
+    result |= std::min(channel, 255u) << shift;
+  }
+  return result;
+}
+
+#ifdef SOFTWARE_RASTERIZER_SSE2
+// MulDiv255 of 16 bit lanes holding products of 8 bit values
+inline __m128i Div255(__m128i product)
+{
+  const __m128i t = _mm_add_epi16(product, _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+// the alpha lane of each pixel broadcast to its four channels
+inline __m128i BroadcastAlpha(__m128i pixels)
+{
+  return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)),
+                             _MM_SHUFFLE(3, 3, 3, 3));
+}
+#endif
+
+void BlendSpan(uint32_t* destination, int count, uint32_t color)
+{
+  const uint32_t alpha = color >> 24;
+  if (alpha == 0) {
+    return;
+  }
+  if (alpha == 255) {
+    std::fill(destination, destination + count, color);
+    return;
+  }
+
+  int i = 0;
+#ifdef SOFTWARE_RASTERIZER_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i source = _mm_set1_epi32(static_cast<int>(color));
+  const __m128i inverseAlpha = _mm_set1_epi16(static_cast<short>(255 - alpha));
+  for (; i + 4 <= count; i += 4) {
+    auto pixels = reinterpret_cast<__m128i*>(destination + i);
+    const __m128i value = _mm_loadu_si128(pixels);
+    const __m128i low = Div255(_mm_mullo_epi16(_mm_unpacklo_epi8(value, zero), inverseAlpha));
+    const __m128i high = Div255(_mm_mullo_epi16(_mm_unpackhi_epi8(value, zero), inverseAlpha));
+    _mm_storeu_si128(pixels, _mm_adds_epu8(_mm_packus_epi16(low, high), source));
+  }
+#endif
+  for (; i < count; ++i) {
+    destination[i] = BlendPixels(destination[i], color);
+  }
+}
+
+void BlendMaskSpan(uint32_t* destination, const uint8_t* mask, int count, uint32_t color)
+{
+  int i = 0;
+#ifdef SOFTWARE_RASTERIZER_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i maxValue = _mm_set1_epi16(255);
+  const __m128i color16 = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color)), zero);
+  for (; i + 4 <= count; i += 4) {
+    int maskBits;
+    std::memcpy(&maskBits, mask + i, sizeof(maskBits));
+    if (maskBits == 0) {
+      continue;
+    }
+
+    // coverage of each pixel repeated for its four channels
+    __m128i coverage = _mm_cvtsi32_si128(maskBits);
+    coverage = _mm_unpacklo_epi8(coverage, coverage);
+    coverage = _mm_unpacklo_epi16(coverage, coverage);
+
+    const __m128i sourceLow = Div255(_mm_mullo_epi16(color16, _mm_unpacklo_epi8(coverage, zero)));
+    const __m128i sourceHigh =
+        Div255(_mm_mullo_epi16(color16, _mm_unpackhi_epi8(coverage, zero)));
+    const __m128i inverseLow = _mm_sub_epi16(maxValue, BroadcastAlpha(sourceLow));
+    const __m128i inverseHigh = _mm_sub_epi16(maxValue, BroadcastAlpha(sourceHigh));
+
+    auto pixels = reinterpret_cast<__m128i*>(destination + i);
+    const __m128i value = _mm_loadu_si128(pixels);
+    const __m128i low = _mm_add_epi16(
+        sourceLow, Div255(_mm_mullo_epi16(_mm_unpacklo_epi8(value, zero), inverseLow)));
+    const __m128i high = _mm_add_epi16(
+        sourceHigh, Div255(_mm_mullo_epi16(_mm_unpackhi_epi8(value, zero), inverseHigh)));
+    _mm_storeu_si128(pixels, _mm_packus_epi16(low, high));
+  }
+#endif
+  for (; i < count; ++i) {
+    if (mask[i] != 0) {
+      destination[i] = BlendPixels(destination[i], ScalePixel(color, mask[i]));
+    }
+  }
+}
+
+// first pixel whose center is at or behind the coordinate
+inline int PixelEdge(float coordinate)
+{
+  return static_cast<int>(std::ceil(coordinate - 0.5f));
+}
+
+// pixels whose centers are between start and end, including start and excluding end
+inline void LineRange(float start, float end, int& first, int& last)
+{
+  if (start <= end) {
+    first = PixelEdge(start);
+    last = PixelEdge(end);
+  }
+  else {
+    first = static_cast<int>(std::floor(end - 0.5f)) + 1;
+    last = static_cast<int>(std::floor(start - 0.5f)) + 1;
+  }
+}
+
+}  // namespace
+
+uint32_t SoftwareRasterizer::ToPixel(float r, float g, float b, float a)
+{
+  const auto channel = [](float value) {
+    return static_cast<uint32_t>(std::max(0.0f, std::min(value, 1.0f)) * 255.0f + 0.5f);
+  };
+  return (channel(a) << 24) | (channel(r * a) << 16) | (channel(g * a) << 8) | channel(b * a);
+}
+
+void SoftwareRasterizer::SetTarget(uint8_t* pixels, int stride, int width, int height)
+{
+  pixels_ = pixels;
+  stride_ = stride;
+  target_ = {0, 0, width, height};
+  clip_ = target_;
+}
+
+void SoftwareRasterizer::ResetTarget()
+{
+  SetTarget(nullptr, 0, 0, 0);
+}
+
+void SoftwareRasterizer::PushClip(const GlyphAtlas::Rect& clip)
+{
+  clip_.left = std::max(target_.left, PixelEdge(clip.left));
+  clip_.top = std::max(target_.top, PixelEdge(clip.top));
+  clip_.right = std::min(target_.right, PixelEdge(clip.right));
+  clip_.bottom = std::min(target_.bottom, PixelEdge(clip.bottom));
+}
+
+void SoftwareRasterizer::PopClip()
+{
+  clip_ = target_;
+}
+
+void SoftwareRasterizer::Clear(uint32_t color)
+{
+  for (int y = clip_.top; y < clip_.bottom; ++y) {
+    const auto row = Row(y);
+    std::fill(row + clip_.left, row + std::max(clip_.left, clip_.right), color);
+  }
+}
+
+void SoftwareRasterizer::FillRect(const GlyphAtlas::Rect& rect, uint32_t color)
+{
+  const int left = std::max(clip_.left, PixelEdge(rect.left));
+  const int top = std::max(clip_.top, PixelEdge(rect.top));
+  const int right = std::min(clip_.right, PixelEdge(rect.right));
+  const int bottom = std::min(clip_.bottom, PixelEdge(rect.bottom));
+  for (int y = top; y < bottom && left < right; ++y) {
+    BlendSpan(Row(y) + left, right - left, color);
+  }
+}
+
+void SoftwareRasterizer::DrawLine(const Point& start, const Point& end, uint32_t color)
+{
+  // one pixel per pixel center along the major axis, the end point is excluded so
+  // connected lines do not blend their joints twice
+  const float dx = end.x - start.x;
+  const float dy = end.y - start.y;
+  if (std::fabs(dx) >= std::fabs(dy)) {
+    if (dx == 0.0f) {
+      return;
+    }
+    const float slope = dy / dx;
+    int first;
+    int last;
+    LineRange(start.x, end.x, first, last);
+    for (int x = first; x < last; ++x) {
+      const float y = start.y + (x + 0.5f - start.x) * slope;
+      BlendPixel(x, static_cast<int>(std::ceil(y)) - 1, color);
+    }
+  }
+  else {
+    const float slope = dx / dy;
+    int first;
+    int last;
+    LineRange(start.y, end.y, first, last);
+    for (int y = first; y < last; ++y) {
+      const float x = start.x + (y + 0.5f - start.y) * slope;
+      BlendPixel(static_cast<int>(std::ceil(x)) - 1, y, color);
+    }
+  }
+}
+
+void SoftwareRasterizer::DrawGlyphs(const GlyphAtlas& atlas,
+                                    const std::vector<GlyphAtlas::Quad>& quads,
+                                    uint32_t textColor, uint32_t highlightColor)
+{
+  const auto& coverage = atlas.GetPixels();
+  const int atlasWidth = atlas.GetWidth();
+  for (const auto& quad : quads) {
+    const int sourceX = static_cast<int>(quad.source.left);
+    const int sourceY = static_cast<int>(quad.source.top);
+    const int destX = static_cast<int>(quad.dest.left);
+    const int destY = static_cast<int>(quad.dest.top);
+    const int width = static_cast<int>(quad.source.right - quad.source.left);
+    const int height = static_cast<int>(quad.source.bottom - quad.source.top);
+
+    const int left = std::max(clip_.left, destX);
+    const int top = std::max(clip_.top, destY);
+    const int right = std::min(clip_.right, destX + width);
+    const int bottom = std::min(clip_.bottom, destY + height);
+    if (left >= right) {
+      continue;
+    }
+
+    const uint32_t color = quad.highlight ? highlightColor : textColor;
+    for (int y = top; y < bottom; ++y) {
+      const uint8_t* mask =
+          &coverage[static_cast<size_t>(sourceY + y - destY) * atlasWidth + sourceX + left - destX];
+      BlendMaskSpan(Row(y) + left, mask, right - left, color);
+    }
+  }
+}
+
+uint32_t* SoftwareRasterizer::Row(int y) const
+{
+  return reinterpret_cast<uint32_t*>(pixels_ + static_cast<size_t>(y) * stride_);
+}
+
+void SoftwareRasterizer::BlendPixel(int x, int y, uint32_t color)
+{
+  if (x >= clip_.left && x < clip_.right && y >= clip_.top && y < clip_.bottom) {
+    auto pixel = Row(y) + x;
+    *pixel = BlendPixels(*pixel, color);
+  }
+}
@@ -0,0 +1,81 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GlyphAtlas.h"
+
+// CPU rasterizer for the few primitives of the overlay: cleared areas, aliased one pixel
+// lines and glyphs from a GlyphAtlas. Draws into premultiplied BGRA memory, spans are
+// blended with SSE2 where available.
+class SoftwareRasterizer final {
+ public:
+  struct Point {
+    float x;
+    float y;
+  };
+
+  // Premultiplied BGRA pixel of a straight alpha color.
+  static uint32_t ToPixel(float r, float g, float b, float a);
+
+  void SetTarget(uint8_t* pixels, int stride, int width, int height);
+  void ResetTarget();
+
+  // Like ID2D1RenderTarget::PushAxisAlignedClip with aliased antialiasing, one level only.
+  void PushClip(const GlyphAtlas::Rect& clip);
+  void PopClip();
+
+  // Replaces all pixels inside the clip.
+  void Clear(uint32_t color);
+  void FillRect(const GlyphAtlas::Rect& rect, uint32_t color);
+  void DrawLine(const Point& start, const Point& end, uint32_t color);
+  // Points of any type with float x and y members.
+  template <typename PointType>
+  void DrawPolyline(const PointType* points, size_t count, uint32_t color)
+  {
+    for (size_t i = 1; i < count; ++i) {
+      DrawLine({points[i - 1].x, points[i - 1].y}, {points[i].x, points[i].y}, color);
+    }
+  }
+  void DrawGlyphs(const GlyphAtlas& atlas, const std::vector<GlyphAtlas::Quad>& quads,
+                  uint32_t textColor, uint32_t highlightColor);
+
+ private:
+  struct Bounds {
+    int left;
+    int top;
+    int right;
+    int bottom;
+  };
+
+  uint32_t* Row(int y) const;
+  void BlendPixel(int x, int y, uint32_t color);
+
+  uint8_t* pixels_ = nullptr;
+  int stride_ = 0;
+  Bounds target_ = {};
+  Bounds clip_ = {};
+};
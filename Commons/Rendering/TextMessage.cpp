@@ -22,8 +22,6 @@
 
 #include "TextMessage.h"
 
-#include <iomanip>
-
 TextMessage::~TextMessage()
 {
   textLayout_.Reset();
@@ -33,6 +31,9 @@ TextMessage::~TextMessage()
 
 TextMessage::TextMessage(ID2D1RenderTarget* renderTarget, const D2D1_COLOR_F& textColor,
                          const D2D1_COLOR_F& numberColor)
+    : numberPixel_(SoftwareRasterizer::ToPixel(numberColor.r, numberColor.g, numberColor.b,
+                                               numberColor.a)),
+      textPixel_(SoftwareRasterizer::ToPixel(textColor.r, textColor.g, textColor.b, textColor.a))
 {
   HRESULT hr = renderTarget->CreateSolidColorBrush(textColor, &textBrush_);
   if (FAILED(hr)) 
@@ -47,56 +48,117 @@ TextMessage::TextMessage(ID2D1RenderTarget* renderTarget, const D2D1_COLOR_F& te
   }
 }
 
-void TextMessage::WriteMessage(const std::wstring& msg) 
-{ 
-  message_ << msg; 
+void TextMessage::WriteMessage(const wchar_t* msg)
+{
+  message_.Append(msg);
+}
+
+void TextMessage::WriteMessage(float value, const wchar_t* msg, int precision)
+{
+  const auto start = static_cast<UINT32>(message_.GetSize());
+  message_.Append(value, precision);
+  AddNumberRange(start);
+  message_.Append(msg);
+}
+
+void TextMessage::WriteMessage(int value, const wchar_t* msg)
+{
+  const auto start = static_cast<UINT32>(message_.GetSize());
+  message_.Append(value);
+  AddNumberRange(start);
+  message_.Append(msg);
 }
 
-void TextMessage::WriteMessage(float value, const std::wstring& msg, int precision)
+void TextMessage::WriteMessage(const wchar_t* msgA, const wchar_t* msgB)
 {
-  message_ << std::fixed << std::setprecision(precision);
-  const auto start = static_cast<UINT32>(message_.tellp());
-  message_ << value;
-  numberRanges_.push_back({start, static_cast<UINT32>(message_.tellp()) - start});
-  message_ << msg;
+  const auto start = static_cast<UINT32>(message_.GetSize());
+  message_.Append(msgA);
+  AddNumberRange(start);
+  message_.Append(msgB);
 }
 
-void TextMessage::WriteMessage(int value, const std::wstring& msg)
+void TextMessage::AddNumberRange(UINT32 start)
 {
-  const auto start = static_cast<UINT32>(message_.tellp());
-  message_ << value;
-  numberRanges_.push_back({start, static_cast<UINT32>(message_.tellp()) - start});
-  message_ << msg;
+  numberRanges_.push_back({start, static_cast<UINT32>(message_.GetSize()) - start});
 }
 
-void TextMessage::WriteMessage(const std::wstring& msgA, const std::wstring& msgB)
+void TextMessage::SetText(IDWriteFactory* writeFactory, IDWriteTextFormat* textFormat,
+                          const GlyphTextRenderer* glyphRenderer)
 {
-  const auto start = static_cast<UINT32>(message_.tellp());
-  message_ << msgA;
-  numberRanges_.push_back({start, static_cast<UINT32 > (message_.tellp()) - start});
-  message_ << msgB;
+  if (!IsLayoutCurrent(textFormat, glyphRenderer))
+  {
+    text_.assign(message_.GetData(), message_.GetSize());
+    textRanges_.swap(numberRanges_);
+    layoutFormat_ = textFormat;
+    layoutGlyphRenderer_ = glyphRenderer;
+    UpdateLayout(writeFactory, textFormat, glyphRenderer);
+    layoutValid_ = true;
+  }
+
+  message_.Clear();
+  numberRanges_.clear();
 }
 
-void TextMessage::SetText(IDWriteFactory* writeFactory, IDWriteTextFormat* textFormat)
+bool TextMessage::IsLayoutCurrent(IDWriteTextFormat* textFormat,
+                                  const GlyphTextRenderer* glyphRenderer) const
+{
+  if (!layoutValid_ || textFormat != layoutFormat_ || glyphRenderer != layoutGlyphRenderer_ ||
+      !message_.Equals(text_) || numberRanges_.size() != textRanges_.size())
+  {
+    return false;
+  }
+
+  for (size_t i = 0; i < numberRanges_.size(); ++i)
+  {
+    if (numberRanges_[i].startPosition != textRanges_[i].startPosition ||
+        numberRanges_[i].length != textRanges_[i].length)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TextMessage::UpdateLayout(IDWriteFactory* writeFactory, IDWriteTextFormat* textFormat,
+                               const GlyphTextRenderer* glyphRenderer)
 {
   textLayout_ = nullptr;
-  const auto message = message_.str();
+  glyphRenderer_ = nullptr;
+
+  if (glyphRenderer && glyphRenderer->CanRender(text_))
+  {
+    highlights_.clear();
+    for (const auto& range : textRanges_)
+    {
+      highlights_.push_back({range.startPosition, range.length});
+    }
+    const auto area = D2D1::RectF(screenPos_.x, screenPos_.y, screenPos_.x + maxWidth_,
+                                  screenPos_.y + maxHeight_);
+    glyphRenderer->Layout(text_, highlights_, area, quads_);
+    glyphRenderer_ = glyphRenderer;
+    glyphRunsValid_ = false;
+    return;
+  }
 
-  HRESULT hr = writeFactory->CreateTextLayout(message.c_str(), static_cast<UINT32>(message.size()),
+  HRESULT hr = writeFactory->CreateTextLayout(text_.c_str(), static_cast<UINT32>(text_.size()),
                                               textFormat, maxWidth_, maxHeight_, &textLayout_);
-  if (FAILED(hr)) 
+  if (FAILED(hr))
   {
     g_messageLog.LogError("TextMessage", "CreateTextLayout failed, HRESULT", hr);
     textLayout_ = nullptr;
+    return;
   }
 
-  if (textLayout_) 
+  textLayout_->SetIncrementalTabStop(50.0f);
+  for (const auto& range : textRanges_)
   {
-    textLayout_->SetIncrementalTabStop(50.0f);
+    hr = textLayout_->SetDrawingEffect(numberBrush_.Get(), range);
+    if (FAILED(hr))
+    {
+      g_messageLog.LogError("TextMessage", "SetDrawingEffect failed HRESULT", hr);
+    }
+    textLayout_->SetFontWeight(DWRITE_FONT_WEIGHT_BOLD, range);
   }
-
-  message_.clear();
-  message_.str(std::wstring());
 }
 
 void TextMessage::SetArea(float x, float y, float width, float height)
@@ -105,25 +167,35 @@ void TextMessage::SetArea(float x, float y, float width, float height)
   screenPos_.y = y;
   maxWidth_ = width;
   maxHeight_ = height;
+  layoutValid_ = false;
 }
 
 void TextMessage::Draw(ID2D1RenderTarget* renderTarget)
 {
-  if (textLayout_) 
+  if (glyphRenderer_)
   {
-    for (const auto& range : numberRanges_) 
+    if (!glyphRunsValid_)
     {
-      HRESULT hr = textLayout_->SetDrawingEffect(numberBrush_.Get(), range);
-      if (FAILED(hr)) 
-      {
-        g_messageLog.LogError("TextMessage", 
-          "SetDrawingEffect failed HRESULT", hr);
-      }
-      hr = textLayout_->SetFontWeight(DWRITE_FONT_WEIGHT_BOLD, range);
+      const auto area = D2D1::RectF(screenPos_.x, screenPos_.y, screenPos_.x + maxWidth_,
+                                    screenPos_.y + maxHeight_);
+      glyphRunsValid_ = glyphRenderer_->UpdateRuns(renderTarget, quads_, area, glyphRuns_);
     }
+    if (glyphRunsValid_)
+    {
+      glyphRenderer_->Draw(renderTarget, glyphRuns_, textBrush_.Get(), numberBrush_.Get());
+    }
+  }
+  else if (textLayout_)
+  {
     renderTarget->DrawTextLayout(screenPos_, textLayout_.Get(), textBrush_.Get(),
                                  D2D1_DRAW_TEXT_OPTIONS_CLIP);
+  }
+}
 
-    numberRanges_.clear();
+void TextMessage::Draw(SoftwareRasterizer& rasterizer)
+{
+  if (glyphRenderer_ && glyphRenderer_->GetAtlas())
+  {
+    rasterizer.DrawGlyphs(*glyphRenderer_->GetAtlas(), quads_, textPixel_, numberPixel_);
   }
-}
\ No newline at end of file
+}
@@ -30,6 +30,9 @@
 #include <vector>
 
 #include "../Logging/MessageLog.h"
+#include "../Utility/FixedTextBuffer.h"
+#include "GlyphTextRenderer.h"
+#include "SoftwareRasterizer.h"
 
 class TextMessage final {
  public:
@@ -42,22 +45,51 @@ class TextMessage final {
 
   void SetArea(float x, float y, float width, float height);
 
-  void WriteMessage(const std::wstring& msg);
-  void WriteMessage(float value, const std::wstring& msg, int precision);
-  void WriteMessage(int value, const std::wstring& msg);
-  void WriteMessage(const std::wstring& msgA, const std::wstring& msgB);
+  void WriteMessage(const wchar_t* msg);
+  void WriteMessage(float value, const wchar_t* msg, int precision);
+  void WriteMessage(int value, const wchar_t* msg);
+  void WriteMessage(const wchar_t* msgA, const wchar_t* msgB);
 
-  void SetText(IDWriteFactory* writeFactory, IDWriteTextFormat* textFormat);
+  // Text the glyph renderer can draw is laid out from its atlas, everything else falls back
+  // to a DirectWrite text layout. The previous layout is kept if the written message, its
+  // number ranges and the format are unchanged.
+  void SetText(IDWriteFactory* writeFactory, IDWriteTextFormat* textFormat,
+               const GlyphTextRenderer* glyphRenderer = nullptr);
   void Draw(ID2D1RenderTarget* renderTarget);
+  // Only text laid out from a glyph atlas can be drawn by the software rasterizer.
+  void Draw(SoftwareRasterizer& rasterizer);
 
  private:
   Microsoft::WRL::ComPtr<IDWriteTextLayout> textLayout_;
   Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> numberBrush_;
   Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> textBrush_;
+  uint32_t numberPixel_;
+  uint32_t textPixel_;
 
-  std::wstringstream message_;
+  void UpdateLayout(IDWriteFactory* writeFactory, IDWriteTextFormat* textFormat,
+                    const GlyphTextRenderer* glyphRenderer);
+  void AddNumberRange(UINT32 start);
+  bool IsLayoutCurrent(IDWriteTextFormat* textFormat,
+                       const GlyphTextRenderer* glyphRenderer) const;
+
+  // written since the last SetText
+  FixedTextBuffer message_;
   std::vector<DWRITE_TEXT_RANGE> numberRanges_;
 
+  // text of the current layout
+  std::wstring text_;
+  std::vector<DWRITE_TEXT_RANGE> textRanges_;
+  IDWriteTextFormat* layoutFormat_ = nullptr;
+  const GlyphTextRenderer* layoutGlyphRenderer_ = nullptr;
+  bool layoutValid_ = false;
+
+  const GlyphTextRenderer* glyphRenderer_ = nullptr;
+  std::vector<GlyphAtlas::Range> highlights_;
+  std::vector<GlyphAtlas::Quad> quads_;
+  // composed on the first draw after a layout change
+  GlyphTextRenderer::Runs glyphRuns_;
+  bool glyphRunsValid_ = false;
+
   D2D1_POINT_2F screenPos_;
   float maxWidth_;
   float maxHeight_;
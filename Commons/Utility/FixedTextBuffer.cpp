@@ -0,0 +1,117 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "FixedTextBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cwchar>
+
+const int FixedTextBuffer::maxPrecision_ = 6;
+
+void FixedTextBuffer::Append(const wchar_t* text)
+{
+  for (; *text; ++text) {
+    AppendCharacter(*text);
+  }
+}
+
+void FixedTextBuffer::Append(const std::wstring& text)
+{
+  for (const auto character : text) {
+    AppendCharacter(character);
+  }
+}
+
+void FixedTextBuffer::Append(int value)
+{
+  // widen before negating, -INT_MIN does not fit into an int
+  long long wide = value;
+  if (wide < 0) {
+    AppendCharacter(L'-');
+    wide = -wide;
+  }
+  AppendDigits(static_cast<unsigned long long>(wide), 1);
+}
+
+void FixedTextBuffer::Append(float value, int precision)
+{
+  if (std::isnan(value)) {
+    Append(L"nan");
+    return;
+  }
+  if (std::isinf(value)) {
+    Append(value < 0.0f ? L"-inf" : L"inf");
+    return;
+  }
+
+  precision = std::max(0, std::min(precision, maxPrecision_));
+  unsigned long long scale = 1;
+  for (int i = 0; i < precision; ++i) {
+    scale *= 10;
+  }
+
+  const double scaled = std::fabs(static_cast<double>(value)) * scale + 0.5;
+  if (scaled >= 1e18) {
+    // out of the fixed-point range, the overlay never shows values this large
+    Append(value < 0.0f ? L"-inf" : L"inf");
+    return;
+  }
+
+  const auto rounded = static_cast<unsigned long long>(scaled);
+  if (value < 0.0f && rounded != 0) {
+    AppendCharacter(L'-');
+  }
+  AppendDigits(rounded / scale, 1);
+  if (precision > 0) {
+    AppendCharacter(L'.');
+    AppendDigits(rounded % scale, precision);
+  }
+}
+
+bool FixedTextBuffer::Equals(const std::wstring& text) const
+{
+  return text.size() == size_ && std::wmemcmp(text.data(), data_, size_) == 0;
+}
+
+void FixedTextBuffer::AppendCharacter(wchar_t character)
+{
+  if (size_ < capacity_) {
+    data_[size_++] = character;
+  }
+}
+
+void FixedTextBuffer::AppendDigits(unsigned long long value, int minDigits)
+{
+  wchar_t digits[20];
+  int count = 0;
+  do {
+    digits[count++] = static_cast<wchar_t>(L'0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  for (; count < minDigits; ++count) {
+    digits[count] = L'0';
+  }
+  while (count > 0) {
+    AppendCharacter(digits[--count]);
+  }
+}
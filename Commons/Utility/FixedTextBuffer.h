@@ -0,0 +1,54 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Fixed capacity wide character text, numbers are formatted without locale or allocation.
+// Text beyond the capacity is truncated.
+class FixedTextBuffer final {
+ public:
+  FixedTextBuffer() = default;
+
+  void Append(const wchar_t* text);
+  void Append(const std::wstring& text);
+  void Append(int value);
+  // Fixed-point notation with precision digits after the decimal point, rounded half up.
+  void Append(float value, int precision);
+
+  void Clear() { size_ = 0; }
+  const wchar_t* GetData() const { return data_; }
+  size_t GetSize() const { return size_; }
+  bool Equals(const std::wstring& text) const;
+
+ private:
+  void AppendCharacter(wchar_t character);
+  void AppendDigits(unsigned long long value, int minDigits);
+
+  static const size_t capacity_ = 256;
+  static const int maxPrecision_;
+
+  wchar_t data_[capacity_];
+  size_t size_ = 0;
+};
@@ -47,6 +47,12 @@ namespace Frontend
         public bool altKeyComb;
         public bool disableOverlayDuringCapture;
         public int overlayPosition;
+        public int overlayUpdateRate;
+        public bool softwareOverlayRasterizer;
+        public int overlayCostBudget;
+        public bool showOverlayCost;
+        public bool showFrameTimeLows;
+        public bool overlayGpuTimestamps;
         public string captureOutputFolder;
 
         private const string section = "Recording";
@@ -67,6 +73,12 @@ namespace Frontend
             disableOverlayDuringCapture = true;
             injectOnStart = true;
             overlayPosition = OverlayPosition.UpperRight.ToInt();
+            overlayUpdateRate = 30;
+            softwareOverlayRasterizer = false;
+            overlayCostBudget = 0;
+            showOverlayCost = false;
+            showFrameTimeLows = false;
+            overlayGpuTimestamps = false;
             const string outputFolderPath = ("\\OCAT\\Captures");
             captureOutputFolder = System.Environment.GetFolderPath(Environment.SpecialFolder.MyDocuments) + outputFolderPath;
         }
@@ -83,6 +95,12 @@ namespace Frontend
                 iniFile.WriteLine("toggleLagIndicatorOverlayHotkey=" + toggleLagIndicatorOverlayHotkey);
                 iniFile.WriteLine("lagIndicatorHotkey=" + lagIndicatorHotkey);
                 iniFile.WriteLine("overlayPosition=" + overlayPosition);
+                iniFile.WriteLine("overlayUpdateRate=" + overlayUpdateRate);
+                iniFile.WriteLine("softwareOverlayRasterizer=" + Convert.ToInt32(softwareOverlayRasterizer));
+                iniFile.WriteLine("overlayCostBudget=" + overlayCostBudget);
+                iniFile.WriteLine("showOverlayCost=" + Convert.ToInt32(showOverlayCost));
+                iniFile.WriteLine("showFrameTimeLows=" + Convert.ToInt32(showFrameTimeLows));
+                iniFile.WriteLine("overlayGpuTimestamps=" + Convert.ToInt32(overlayGpuTimestamps));
                 iniFile.WriteLine("captureTime=" + captureTime);
                 iniFile.WriteLine("captureDelay=" + captureDelay);
                 iniFile.WriteLine("captureAllProcesses=" + Convert.ToInt32(captureAll));
@@ -105,6 +123,12 @@ namespace Frontend
                 toggleLagIndicatorOverlayHotkey = ConfigurationFile.ReadInt(section, "toggleLagIndicatorOverlayHotkey", toggleLagIndicatorOverlayHotkey, path);
                 lagIndicatorHotkey = ConfigurationFile.ReadInt(section, "lagIndicatorHotkey", lagIndicatorHotkey, path);
                 overlayPosition = ConfigurationFile.ReadInt(section, "overlayPosition", overlayPosition, path);
+                overlayUpdateRate = ConfigurationFile.ReadInt(section, "overlayUpdateRate", overlayUpdateRate, path);
+                softwareOverlayRasterizer = ConfigurationFile.ReadBool(section, "softwareOverlayRasterizer", path);
+                overlayCostBudget = ConfigurationFile.ReadInt(section, "overlayCostBudget", overlayCostBudget, path);
+                showOverlayCost = ConfigurationFile.ReadBool(section, "showOverlayCost", path);
+                showFrameTimeLows = ConfigurationFile.ReadBool(section, "showFrameTimeLows", path);
+                overlayGpuTimestamps = ConfigurationFile.ReadBool(section, "overlayGpuTimestamps", path);
                 captureTime = ConfigurationFile.ReadInt(section, "captureTime", captureTime, path);
                 captureDelay = ConfigurationFile.ReadInt(section, "captureDelay", captureDelay, path);
                 captureAll = ConfigurationFile.ReadBool(section, "captureAllProcesses", path);
@@ -68,8 +68,9 @@ d3d11_renderer::d3d11_renderer(ID3D11Device* device, IDXGISwapChain* swapchain)
     return;
   }
 
-  if (!RecordOverlayCommandList()) {
+  if (!UseDeferredContext()) {
     status = InitializationStatus::IMMEDIATE_CONTEXT_INITIALIZED;
+    g_messageLog.LogInfo("D3D11", "Overlay initialized for the immediate context.");
     return;
   }
 
@@ -100,8 +101,9 @@ d3d11_renderer::d3d11_renderer(
     return;
   }
 
-  if (!RecordOverlayCommandList()) {
+  if (!UseDeferredContext()) {
     status = InitializationStatus::IMMEDIATE_CONTEXT_INITIALIZED;
+    g_messageLog.LogInfo("D3D11", "Overlay initialized for the immediate context.");
     return;
   }
 
@@ -114,6 +116,21 @@ d3d11_renderer::~d3d11_renderer()
   // Empty
 }
 
+bool d3d11_renderer::UseDeferredContext()
+{
+  // Without driver support the runtime emulates command lists, and ExecuteCommandList then
+  // saves and restores the complete context state. Drawing on the immediate context with
+  // the state block is cheaper in that case.
+  if (!driverCommandListsChecked_) {
+    D3D11_FEATURE_DATA_THREADING threading = {};
+    const HRESULT hr =
+        device_->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading));
+    driverCommandLists_ = SUCCEEDED(hr) && threading.DriverCommandLists;
+    driverCommandListsChecked_ = true;
+  }
+  return driverCommandLists_ && RecordOverlayCommandList();
+}
+
 bool d3d11_renderer::RecordOverlayCommandList()
 {
   ComPtr<ID3D11DeviceContext> overlayContext;
@@ -170,6 +187,8 @@ bool d3d11_renderer::on_present(int backBufferIndex, bool lagIndicatorState)
     return false;
   }
 
+  OverlayCostScope costScope(overlayBitmap_->GetCostBudget());
+
    if (!UpdateLagIndicatorVisibility()) {
     return false;
   }
@@ -206,36 +225,7 @@ bool d3d11_renderer::on_present(int backBufferIndex, bool lagIndicatorState)
       return true;
     }
     case InitializationStatus::IMMEDIATE_CONTEXT_INITIALIZED: {
-      // save current context_ state
-      D3D_PRIMITIVE_TOPOLOGY topology;
-      context_->IAGetPrimitiveTopology(&topology);
-      Microsoft::WRL::ComPtr<ID3D11InputLayout> pInputLayout;
-      context_->IAGetInputLayout(&pInputLayout);
-      Microsoft::WRL::ComPtr<ID3D11VertexShader> pVertexShader;
-      Microsoft::WRL::ComPtr<ID3D11ClassInstance> pVSClassInstances;
-      UINT vsNumClassInstances;
-      context_->VSGetShader(&pVertexShader, &pVSClassInstances, &vsNumClassInstances);
-      Microsoft::WRL::ComPtr<ID3D11PixelShader> pPixelShader;
-      Microsoft::WRL::ComPtr<ID3D11ClassInstance> pPSClassInstances;
-      UINT psNumClassInstances;
-      context_->PSGetShader(&pPixelShader, &pPSClassInstances, &psNumClassInstances);
-      Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> pShaderResourceView;
-      context_->PSGetShaderResources(0, 1, &pShaderResourceView);
-      Microsoft::WRL::ComPtr<ID3D11Buffer> constantBuffers;
-      context_->PSGetConstantBuffers(0, 1, &constantBuffers);
-      Microsoft::WRL::ComPtr<ID3D11RenderTargetView> pRenderTargetView;
-      Microsoft::WRL::ComPtr<ID3D11DepthStencilView> pDepthStencilView;
-      context_->OMGetRenderTargets(1, &pRenderTargetView, &pDepthStencilView);
-      Microsoft::WRL::ComPtr<ID3D11BlendState> pBlendState;
-      FLOAT blendFactor[4];
-      UINT sampleMask;
-      context_->OMGetBlendState(&pBlendState, &blendFactor[0], &sampleMask);
-      Microsoft::WRL::ComPtr<ID3D11RasterizerState> rasterizerState;
-      context_->RSGetState(&rasterizerState);
-      UINT numViewports;
-      context_->RSGetViewports(&numViewports, NULL);
-      std::vector<D3D11_VIEWPORT> viewports(numViewports);
-      context_->RSGetViewports(&numViewports, &viewports[0]);
+      stateBlock_.Capture(context_.Get());
 
       // record overlay commands
       context_->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
@@ -265,22 +255,7 @@ bool d3d11_renderer::on_present(int backBufferIndex, bool lagIndicatorState)
         context_->Draw(3, 0);
       }
 
-      // restore context to previous state
-      context_->IASetPrimitiveTopology(topology);
-      context_->IASetInputLayout(pInputLayout.Get());
-      ID3D11ClassInstance* vsCIs[] = {pVSClassInstances.Get()};
-      context_->VSSetShader(pVertexShader.Get(), vsCIs, vsNumClassInstances);
-      ID3D11ClassInstance* psCIs[] = {pPSClassInstances.Get()};
-      context_->PSSetShader(pPixelShader.Get(), psCIs, psNumClassInstances);
-      ID3D11ShaderResourceView* srvs_prev[] = {pShaderResourceView.Get()};
-      context_->PSSetShaderResources(0, 1, srvs_prev);
-      ID3D11Buffer* cbs_prev[] = {constantBuffers.Get()};
-      context_->PSSetConstantBuffers(0, 1, cbs_prev);
-      ID3D11RenderTargetView* rtv_prev[] = {pRenderTargetView.Get()};
-      context_->OMSetRenderTargets(1, rtv_prev, pDepthStencilView.Get());
-      context_->OMSetBlendState(pBlendState.Get(), blendFactor, sampleMask);
-      context_->RSSetState(rasterizerState.Get());
-      context_->RSSetViewports(numViewports, viewports.data());
+      stateBlock_.Restore(context_.Get());
       return true;
     }
   }
@@ -353,11 +328,15 @@ bool d3d11_renderer::CreateOverlayTexture()
   stagingDesc.Usage = D3D11_USAGE_STAGING;
   stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
   stagingDesc.BindFlags = 0;
-  hr = device_->CreateTexture2D(&stagingDesc, nullptr, &stagingTexture_);
-  if (FAILED(hr)) {
-    g_messageLog.LogError("D3D11", "Overlay Texture - failed creating staging texture.", hr);
-    return false;
+  for (int i = 0; i < stagingTextureCount_; ++i) {
+    hr = device_->CreateTexture2D(&stagingDesc, nullptr, &stagingTextures_[i]);
+    if (FAILED(hr)) {
+      g_messageLog.LogError("D3D11", "Overlay Texture - failed creating staging texture.", hr);
+      return false;
+    }
+    stagingDrawCounts_[i] = 0;
   }
+  uploadedDrawCount_ = 0;
 
   return true;
 }
@@ -492,7 +471,7 @@ bool d3d11_renderer::UpdateOverlayPosition()
 
   // we are forced to record the command list again
   // to apply the changes to the viewport.
-  if (!RecordOverlayCommandList()) {
+  if (!UseDeferredContext()) {
     status = InitializationStatus::IMMEDIATE_CONTEXT_INITIALIZED;
   }
   else {
@@ -504,26 +483,79 @@ bool d3d11_renderer::UpdateOverlayPosition()
 
 void d3d11_renderer::UpdateOverlayTexture()
 {
-  CopyOverlayTexture();
-  const auto copyArea = overlayBitmap_->GetCopyArea();
-  context_->CopyResource(displayTexture_.Get(), stagingTexture_.Get());
+  // only the regions which changed since the last upload are copied
+  overlayBitmap_->GetDirtyRects(uploadedDrawCount_, dirtyRects_);
+  if (dirtyRects_.empty()) {
+    return;
+  }
+
+  const auto stagingTexture = CopyOverlayTexture();
+  if (!stagingTexture) {
+    // retried with the next present, the dirty regions are still pending
+    return;
+  }
+  uploadedDrawCount_ = overlayBitmap_->GetDrawCount();
+
+  for (const auto& rect : dirtyRects_) {
+    D3D11_BOX box{};
+    box.left = static_cast<UINT>(rect.X);
+    box.top = static_cast<UINT>(rect.Y);
+    box.front = 0;
+    box.right = static_cast<UINT>(rect.X + rect.Width);
+    box.bottom = static_cast<UINT>(rect.Y + rect.Height);
+    box.back = 1;
+    context_->CopySubresourceRegion(displayTexture_.Get(), 0, box.left, box.top, 0,
+                                    stagingTexture, 0, &box);
+  }
 }
 
-void d3d11_renderer::CopyOverlayTexture()
+ID3D11Texture2D* d3d11_renderer::CopyOverlayTexture()
 {
   const auto textureData = overlayBitmap_->GetBitmapDataRead();
-  if (textureData.dataPtr != nullptr && textureData.size > 0) {
-    D3D11_MAPPED_SUBRESOURCE mappedResource;
-    HRESULT hr = context_->Map(stagingTexture_.Get(), 0, D3D11_MAP_WRITE, 0, &mappedResource);
+  if (textureData.dataPtr == nullptr || textureData.size == 0) {
+    overlayBitmap_->UnlockBitmapData();
+    return nullptr;
+  }
+
+  // take the first staging texture the GPU is done with
+  int index = -1;
+  D3D11_MAPPED_SUBRESOURCE mappedResource;
+  for (int i = 0; i < stagingTextureCount_ && index < 0; ++i) {
+    const int candidate = (nextStagingTexture_ + i) % stagingTextureCount_;
+    HRESULT hr = context_->Map(stagingTextures_[candidate].Get(), 0, D3D11_MAP_WRITE,
+                               D3D11_MAP_FLAG_DO_NOT_WAIT, &mappedResource);
+    if (hr == DXGI_ERROR_WAS_STILL_DRAWING) {
+      continue;
+    }
     if (FAILED(hr)) {
-      g_messageLog.LogWarning("D3D11", "Mapping of display texture failed, HRESULT", hr);
-      return;
+      g_messageLog.LogWarning("D3D11", "Mapping of staging texture failed, HRESULT", hr);
+      overlayBitmap_->UnlockBitmapData();
+      return nullptr;
+    }
+    index = candidate;
+  }
+  if (index < 0) {
+    overlayBitmap_->UnlockBitmapData();
+    return nullptr;
+  }
+
+  // the staging texture keeps its content, so only the rows which changed since its last
+  // write are copied, the row pitch of the staging texture may differ from the bitmap stride
+  overlayBitmap_->GetDirtyRects(stagingDrawCounts_[index], stagingDirtyRects_);
+  auto dest = static_cast<unsigned char*>(mappedResource.pData);
+  for (const auto& rect : stagingDirtyRects_) {
+    const size_t rowSize = static_cast<size_t>(rect.Width) * 4;
+    for (int y = rect.Y; y < rect.Y + rect.Height; ++y) {
+      memcpy(dest + y * mappedResource.RowPitch + rect.X * 4,
+             textureData.dataPtr + y * textureData.stride + rect.X * 4, rowSize);
     }
-
-    memcpy(mappedResource.pData, textureData.dataPtr, textureData.size);
-    context_->Unmap(stagingTexture_.Get(), 0);
   }
+  context_->Unmap(stagingTextures_[index].Get(), 0);
   overlayBitmap_->UnlockBitmapData();
+
+  stagingDrawCounts_[index] = overlayBitmap_->GetDrawCount();
+  nextStagingTexture_ = (index + 1) % stagingTextureCount_;
+  return stagingTextures_[index].Get();
 }
 
 bool d3d11_renderer::UpdateLagIndicatorVisibility()
@@ -536,7 +568,7 @@ bool d3d11_renderer::UpdateLagIndicatorVisibility()
 
   // we are forced to record the command list again
   // to apply the changes to the viewport.
-  if (!RecordOverlayCommandList()) {
+  if (!UseDeferredContext()) {
     status = InitializationStatus::IMMEDIATE_CONTEXT_INITIALIZED;
   }
   else {
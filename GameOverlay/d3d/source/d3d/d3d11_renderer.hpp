@@ -31,6 +31,7 @@
 
 #include "Recording/PerformanceCounter.hpp"
 #include "Rendering/OverlayBitmap.h"
+#include "d3d11_state_block.hpp"
 
 namespace GameOverlay {
 enum class InitializationStatus {
@@ -52,16 +53,18 @@ class d3d11_renderer final {
 
   D3D11_VIEWPORT GetViewport() { return viewPort_; }
 
-  int GetLagIndicatorHotkey() { return overlayBitmap_->GetLagIndicatorHotkey(); }
   bool HideOverlay() { return overlayBitmap_->HideOverlay(); }
 
  private:
   bool CreateOverlayRenderTarget();
   bool CreateOverlayTexture();
   bool CreateOverlayResources(int backBufferWidth, int backBufferHeight);
+  // Records the overlay command lists if the driver supports them natively.
+  bool UseDeferredContext();
   bool RecordOverlayCommandList();
 
-  void CopyOverlayTexture();
+  // Returns the staging texture holding the current bitmap, null if none was available.
+  ID3D11Texture2D* CopyOverlayTexture();
   bool UpdateOverlayPosition();
   void UpdateOverlayTexture();
   bool UpdateLagIndicatorVisibility();
@@ -75,7 +78,6 @@ class d3d11_renderer final {
 
   Microsoft::WRL::ComPtr<ID3D11PixelShader> lagIndicatorPS_;
 
-  Microsoft::WRL::ComPtr<ID3D11Texture2D> stagingTexture_;
   Microsoft::WRL::ComPtr<ID3D11Texture2D> displayTexture_;
   Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> displaySRV_;
   Microsoft::WRL::ComPtr<ID3D11Buffer> viewportOffsetCB_;
@@ -87,8 +89,21 @@ class d3d11_renderer final {
   D3D11_VIEWPORT viewPort_;
   D3D11_VIEWPORT lagIndicatorViewPort_;
   std::unique_ptr<OverlayBitmap> overlayBitmap_;
+  std::vector<WICRect> dirtyRects_;
+  UINT64 uploadedDrawCount_ = 0;
+
+  // Staging textures are written in turn and mapped without waiting, so the copy of the
+  // previous frames can still be in flight. Each one tracks the bitmap draw it holds.
+  static const int stagingTextureCount_ = 3;
+  Microsoft::WRL::ComPtr<ID3D11Texture2D> stagingTextures_[stagingTextureCount_];
+  UINT64 stagingDrawCounts_[stagingTextureCount_] = {};
+  int nextStagingTexture_ = 0;
+  std::vector<WICRect> stagingDirtyRects_;
 
   bool lagIndicatorVisibility_ = false;
+  bool driverCommandLists_ = false;
+  bool driverCommandListsChecked_ = false;
+  d3d11_state_block stateBlock_;
 
   InitializationStatus status = InitializationStatus::UNINITIALIZED;
 };
@@ -0,0 +1,138 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "d3d11_state_block.hpp"
+
+namespace GameOverlay {
+d3d11_state_block::~d3d11_state_block()
+{
+  ReleaseArrays();
+}
+
+void d3d11_state_block::Capture(ID3D11DeviceContext* context)
+{
+  ReleaseArrays();
+  context->IAGetPrimitiveTopology(&topology_);
+  context->IAGetInputLayout(&inputLayout_);
+
+  vsClassInstanceCount_ = D3D11_SHADER_MAX_INTERFACES;
+  context->VSGetShader(&vertexShader_, vsClassInstances_, &vsClassInstanceCount_);
+  psClassInstanceCount_ = D3D11_SHADER_MAX_INTERFACES;
+  context->PSGetShader(&pixelShader_, psClassInstances_, &psClassInstanceCount_);
+  context->PSGetShaderResources(0, 1, &psShaderResource_);
+  context->PSGetConstantBuffers(0, 1, &psConstantBuffer_);
+
+  context->OMGetRenderTargetsAndUnorderedAccessViews(
+      D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT, renderTargets_, &depthStencil_, 0,
+      D3D11_PS_CS_UAV_REGISTER_COUNT, unorderedAccessViews_);
+  renderTargetCount_ = 0;
+  unorderedAccessViewCount_ = 0;
+  for (UINT i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; ++i) {
+    if (renderTargets_[i]) {
+      renderTargetCount_ = i + 1;
+    }
+  }
+  for (UINT i = 0; i < D3D11_PS_CS_UAV_REGISTER_COUNT; ++i) {
+    if (unorderedAccessViews_[i]) {
+      unorderedAccessViewCount_ = i + 1;
+    }
+  }
+  context->OMGetBlendState(&blendState_, blendFactor_, &sampleMask_);
+
+  context->RSGetState(&rasterizerState_);
+  viewportCount_ = D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE;
+  context->RSGetViewports(&viewportCount_, viewports_);
+}
+
+void d3d11_state_block::Restore(ID3D11DeviceContext* context)
+{
+  context->IASetPrimitiveTopology(topology_);
+  context->IASetInputLayout(inputLayout_.Get());
+
+  context->VSSetShader(vertexShader_.Get(), vsClassInstances_, vsClassInstanceCount_);
+  context->PSSetShader(pixelShader_.Get(), psClassInstances_, psClassInstanceCount_);
+  ID3D11ShaderResourceView* shaderResources[] = {psShaderResource_.Get()};
+  context->PSSetShaderResources(0, 1, shaderResources);
+  ID3D11Buffer* constantBuffers[] = {psConstantBuffer_.Get()};
+  context->PSSetConstantBuffers(0, 1, constantBuffers);
+
+  if (unorderedAccessViewCount_ > renderTargetCount_) {
+    // the UAVs keep their hidden counters
+    const UINT keepCounts[D3D11_PS_CS_UAV_REGISTER_COUNT] = {
+        UINT(-1), UINT(-1), UINT(-1), UINT(-1), UINT(-1), UINT(-1), UINT(-1), UINT(-1)};
+    context->OMSetRenderTargetsAndUnorderedAccessViews(
+        renderTargetCount_, renderTargets_, depthStencil_.Get(), renderTargetCount_,
+        unorderedAccessViewCount_ - renderTargetCount_, unorderedAccessViews_ + renderTargetCount_,
+        keepCounts);
+  }
+  else {
+    context->OMSetRenderTargets(renderTargetCount_, renderTargets_, depthStencil_.Get());
+  }
+  context->OMSetBlendState(blendState_.Get(), blendFactor_, sampleMask_);
+
+  context->RSSetState(rasterizerState_.Get());
+  context->RSSetViewports(viewportCount_, viewports_);
+
+  // do not keep the application's objects alive
+  inputLayout_.Reset();
+  vertexShader_.Reset();
+  pixelShader_.Reset();
+  psShaderResource_.Reset();
+  psConstantBuffer_.Reset();
+  depthStencil_.Reset();
+  blendState_.Reset();
+  rasterizerState_.Reset();
+  ReleaseArrays();
+}
+
+void d3d11_state_block::ReleaseArrays()
+{
+  for (UINT i = 0; i < vsClassInstanceCount_; ++i) {
+    if (vsClassInstances_[i]) {
+      vsClassInstances_[i]->Release();
+      vsClassInstances_[i] = nullptr;
+    }
+  }
+  vsClassInstanceCount_ = 0;
+  for (UINT i = 0; i < psClassInstanceCount_; ++i) {
+    if (psClassInstances_[i]) {
+      psClassInstances_[i]->Release();
+      psClassInstances_[i] = nullptr;
+    }
+  }
+  psClassInstanceCount_ = 0;
+  for (auto& renderTarget : renderTargets_) {
+    if (renderTarget) {
+      renderTarget->Release();
+      renderTarget = nullptr;
+    }
+  }
+  renderTargetCount_ = 0;
+  for (auto& unorderedAccessView : unorderedAccessViews_) {
+    if (unorderedAccessView) {
+      unorderedAccessView->Release();
+      unorderedAccessView = nullptr;
+    }
+  }
+  unorderedAccessViewCount_ = 0;
+}
+}  // namespace GameOverlay
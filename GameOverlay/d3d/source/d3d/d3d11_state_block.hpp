@@ -0,0 +1,77 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <d3d11.h>
+#include <wrl.h>
+
+namespace GameOverlay {
+// Saves the immediate context state the overlay draw changes and restores it afterwards.
+// The object is kept by the renderer so no memory is allocated per frame, references to the
+// application's state objects are released again by Restore.
+class d3d11_state_block final {
+ public:
+  d3d11_state_block() = default;
+  ~d3d11_state_block();
+
+  d3d11_state_block(const d3d11_state_block&) = delete;
+  d3d11_state_block& operator=(const d3d11_state_block&) = delete;
+
+  void Capture(ID3D11DeviceContext* context);
+  void Restore(ID3D11DeviceContext* context);
+
+ private:
+  // releases the references returned in the class instance, render target and UAV arrays
+  void ReleaseArrays();
+
+  D3D11_PRIMITIVE_TOPOLOGY topology_ = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+  Microsoft::WRL::ComPtr<ID3D11InputLayout> inputLayout_;
+
+  Microsoft::WRL::ComPtr<ID3D11VertexShader> vertexShader_;
+  ID3D11ClassInstance* vsClassInstances_[D3D11_SHADER_MAX_INTERFACES] = {};
+  UINT vsClassInstanceCount_ = 0;
+
+  Microsoft::WRL::ComPtr<ID3D11PixelShader> pixelShader_;
+  ID3D11ClassInstance* psClassInstances_[D3D11_SHADER_MAX_INTERFACES] = {};
+  UINT psClassInstanceCount_ = 0;
+  Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> psShaderResource_;
+  Microsoft::WRL::ComPtr<ID3D11Buffer> psConstantBuffer_;
+
+  // OMSetRenderTargets of the overlay unbinds all render targets and the pixel shader UAVs in
+  // its slots. Only the application's render target count is restored, binding more slots
+  // would unbind its UAVs behind the render targets.
+  ID3D11RenderTargetView* renderTargets_[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT] = {};
+  UINT renderTargetCount_ = 0;
+  Microsoft::WRL::ComPtr<ID3D11DepthStencilView> depthStencil_;
+  // slots of the feature level 11.0 pixel shader UAVs, shared with the render targets
+  ID3D11UnorderedAccessView* unorderedAccessViews_[D3D11_PS_CS_UAV_REGISTER_COUNT] = {};
+  UINT unorderedAccessViewCount_ = 0;
+  Microsoft::WRL::ComPtr<ID3D11BlendState> blendState_;
+  FLOAT blendFactor_[4] = {};
+  UINT sampleMask_ = 0;
+
+  Microsoft::WRL::ComPtr<ID3D11RasterizerState> rasterizerState_;
+  D3D11_VIEWPORT viewports_[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE] = {};
+  UINT viewportCount_ = 0;
+};
+}  // namespace GameOverlay
@@ -37,6 +37,8 @@
 using Microsoft::WRL::ComPtr;
 
 namespace GameOverlay {
+const size_t d3d12_renderer::maxCommandAllocators_ = 16;
+
 d3d12_renderer::d3d12_renderer(ID3D12CommandQueue* commandqueue, IDXGISwapChain3* swapchain)
     : queue_(commandqueue), swapchain_(swapchain)
 {
@@ -69,13 +71,14 @@ d3d12_renderer::d3d12_renderer(ID3D12CommandQueue* commandqueue, IDXGISwapChain3
 
   bufferCount_ = swapchain_desc.BufferCount;
 
-  if (!CreateFrameFences()) return;
+  if (!CreateFence()) return;
   if (!CreateCMDList()) return;
   if (!CreateRenderTargets()) return;
   if (!CreateRootSignature()) return;
   if (!CreatePipelineStateObject()) return;
   if (!CreateOverlayTextures()) return;
   if (!CreateConstantBuffer()) return;
+  CreateTimestampQueries();
 
   initSuccessfull_ = true;
   g_messageLog.LogInfo("D3D12", "Overlay successfully initialized.");
@@ -99,12 +102,13 @@ d3d12_renderer::d3d12_renderer(ID3D12CommandQueue* commandqueue,
   }
 
   queue_->GetDevice(IID_PPV_ARGS(&device_));
-  if (!CreateFrameFences()) return;
+  if (!CreateFence()) return;
   if (!CreateCMDList()) return;
   if (!CreateRootSignature()) return;
   if (!CreatePipelineStateObject()) return;
   if (!CreateOverlayTextures()) return;
   if (!CreateConstantBuffer()) return;
+  CreateTimestampQueries();
 
   initSuccessfull_ = true;
   g_messageLog.LogInfo("D3D12", "Overlay successfully initialized.");
@@ -112,20 +116,12 @@ d3d12_renderer::d3d12_renderer(ID3D12CommandQueue* commandqueue,
 
 d3d12_renderer::~d3d12_renderer()
 {
-  for (auto handle : frameFenceEvents_) {
-    CloseHandle(handle);
-  }
-}
-
-namespace {
-void WaitForFence(ID3D12Fence* fence, UINT64 completionValue, HANDLE waitEvent)
-{
-  if (fence->GetCompletedValue() < completionValue) {
-    fence->SetEventOnCompletion(completionValue, waitEvent);
-    WaitForSingleObject(waitEvent, INFINITE);
+  // the upload buffers and allocators must not be released while the GPU still uses them
+  WaitForCompletion();
+  if (fenceEvent_) {
+    CloseHandle(fenceEvent_);
   }
 }
-}  // namespace
 
 bool d3d12_renderer::on_present(bool lagIndicatorState)
 {
@@ -139,27 +135,84 @@ bool d3d12_renderer::on_present(int backBufferIndex, bool lagIndicatorState)
     return false;
   }
 
-  WaitForFence(frameFences_[backBufferIndex].Get(), frameFenceValues_[backBufferIndex],
-               frameFenceEvents_[backBufferIndex]);
+  OverlayCostScope costScope(overlayBitmap_->GetCostBudget());
 
-  HRESULT hr = commandPool_[backBufferIndex]->Reset();
+  ReadOverlayTimestamps(backBufferIndex);
 
-    if (FAILED(hr)) {
-    g_messageLog.LogError("D3D12", "on_present - Reset command allocator failed", hr);
+  // skip the overlay for this frame rather than stalling the present thread on the GPU
+  CommandAllocator* commandAllocator = AcquireCommandAllocator();
+  if (!commandAllocator) {
+    return false;
+  }
+
+  HRESULT hr = commandList_->Reset(commandAllocator->allocator.Get(), nullptr);
+  if (FAILED(hr)) {
+    g_messageLog.LogError("D3D12", "on_present - Failed to reset command list.", hr);
     return false;
   }
 
+  // upload and draw are submitted together and retired by the same fence value
+  const UINT64 frameFenceValue = fenceValue_ + 1;
   if (!overlayBitmap_->GetLagIndicatorVisibility())
   {
     overlayBitmap_->DrawOverlay();
-    UpdateOverlayTexture(backBufferIndex);
+    UpdateOverlayTexture(frameFenceValue);
   }
 
-  DrawOverlay(backBufferIndex, lagIndicatorState);
+  DrawOverlay(backBufferIndex, lagIndicatorState, frameFenceValue);
+
+  hr = commandList_->Close();
+  if (FAILED(hr)) {
+    g_messageLog.LogError("D3D12", "on_present - Failed to close command list.", hr);
+    return false;
+  }
+
+  ID3D12CommandList* commandLists[] = {commandList_.Get()};
+  queue_->ExecuteCommandLists(1, commandLists);
+
+  hr = queue_->Signal(fence_.Get(), frameFenceValue);
+  if (FAILED(hr)) {
+    g_messageLog.LogError("D3D12", "on_present - Signal queue failed", hr);
+    return false;
+  }
+  fenceValue_ = frameFenceValue;
+  commandAllocator->fenceValue = frameFenceValue;
 
   return true;
 }
 
+d3d12_renderer::CommandAllocator* d3d12_renderer::AcquireCommandAllocator()
+{
+  if (!commandAllocators_.empty() &&
+      fence_->GetCompletedValue() >= commandAllocators_.front().fenceValue) {
+    CommandAllocator commandAllocator = std::move(commandAllocators_.front());
+    commandAllocators_.pop_front();
+
+    HRESULT hr = commandAllocator.allocator->Reset();
+    if (FAILED(hr)) {
+      g_messageLog.LogError("D3D12", "AcquireCommandAllocator - Reset command allocator failed",
+                            hr);
+      return nullptr;
+    }
+    commandAllocators_.push_back(std::move(commandAllocator));
+    return &commandAllocators_.back();
+  }
+
+  if (commandAllocators_.size() >= maxCommandAllocators_) {
+    return nullptr;
+  }
+
+  CommandAllocator commandAllocator;
+  HRESULT hr = device_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                               IID_PPV_ARGS(&commandAllocator.allocator));
+  if (FAILED(hr)) {
+    g_messageLog.LogError("D3D12", "CreateCommandAllocator failed", hr);
+    return nullptr;
+  }
+  commandAllocators_.push_back(std::move(commandAllocator));
+  return &commandAllocators_.back();
+}
+
 void d3d12_renderer::UpdateOverlayPosition()
 {
   const auto width = overlayBitmap_->GetFullWidth();
@@ -187,32 +240,20 @@ void d3d12_renderer::UpdateOverlayPosition()
 
 bool d3d12_renderer::CreateCMDList()
 {
-  HRESULT hr; 
-  
-  commandPool_.resize(bufferCount_);
-  for (int32_t i = 0; i < bufferCount_; i++)
-  {
-    hr = commandPool_[i].Reset();
-    if (FAILED(hr)) {
-      g_messageLog.LogError("CreateCMDList", "CommandAllocator reset failed", hr);
-      return false;
-    }
-
-    hr = device_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
-                                         IID_PPV_ARGS(&commandPool_[i]));
-    if (FAILED(hr)) {
-      g_messageLog.LogError("D3D12", "CreateCommandAllocator failed", hr);
-      return false;
-    }
+  // further allocators are created on demand while earlier frames are in flight
+  CommandAllocator* commandAllocator = AcquireCommandAllocator();
+  if (!commandAllocator) {
+    return false;
   }
 
-  hr = commandList_.Reset();
+  HRESULT hr = commandList_.Reset();
   if (FAILED(hr)) {
     g_messageLog.LogError("CreateCMDList", "CommandList reset failed", hr);
     return false;
   }
   
-  hr = device_->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandPool_[0].Get(), nullptr,
+  hr = device_->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                  commandAllocator->allocator.Get(), nullptr,
                                   IID_PPV_ARGS(&commandList_));
   if (FAILED(hr)) {
     g_messageLog.LogError("D3D12", "CreateCommandList failed", hr);
@@ -254,19 +295,20 @@ bool d3d12_renderer::CreateRenderTargets()
   return true;
 }
 
-bool d3d12_renderer::CreateFrameFences()
+bool d3d12_renderer::CreateFence()
 {
-  currFenceValue_ = 0;
+  fenceValue_ = 0;
+  HRESULT hr = device_->CreateFence(fenceValue_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
+  if (FAILED(hr)) {
+    g_messageLog.LogError("D3D12", "Create Fence failed", hr);
+    return false;
+  }
 
-  frameFences_.resize(bufferCount_);
-  for (int i = 0; i < bufferCount_; ++i) {
-    HRESULT hr = device_->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&frameFences_[i]));
-    if (FAILED(hr)) {
-      g_messageLog.LogError("D3D12", "Create Fence failed", hr);
-      return false;
-    }
-    frameFenceEvents_.push_back(CreateEvent(nullptr, FALSE, FALSE, nullptr));
-    frameFenceValues_.push_back(0);
+  fenceEvent_ = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+  if (fenceEvent_ == nullptr) {
+    g_messageLog.LogError("D3D12", "CreateFence - CreateEvent failed",
+                          HRESULT_FROM_WIN32(GetLastError()));
+    return false;
   }
   return true;
 }
@@ -414,14 +456,6 @@ bool d3d12_renderer::CreatePipelineStateObject()
 
 bool d3d12_renderer::CreateOverlayTextures()
 {
-  HRESULT hr = commandList_->Reset(commandPool_[0].Get(), nullptr);
-
-  if (FAILED(hr)) {
-    g_messageLog.LogError("D3D12",
-                          "CreateOverlayTextures - Reset command list failed", hr);
-    return false;
-  }
-
   const auto displayTextureWidth = overlayBitmap_->GetFullWidth();
   const auto displayTextureHeight = overlayBitmap_->GetFullHeight();
   // Create display texture
@@ -447,17 +481,30 @@ bool d3d12_renderer::CreateOverlayTextures()
       return false;
     }
 
-    // Create upload buffer
+    // Create the upload ring, upload heap buffers stay mapped for their whole lifetime
     const auto uploadBufferSize = GetRequiredIntermediateSize(displayTexture_.Get(), 0, 1);
     const auto uploadBufferHeapType = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
     const auto uploadBufferResourceDesc = CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize);
-    hr = device_->CreateCommittedResource(
-      &uploadBufferHeapType, D3D12_HEAP_FLAG_NONE, &uploadBufferResourceDesc,
-      D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadBuffer_));
-    if (FAILED(hr)) {
-      g_messageLog.LogError("D3D12",
-                            "CreateOverlayTextures - CreateCommittedResource uploadTexture", hr);
-      return false;
+    uploadSlots_.resize(bufferCount_);
+    for (auto& slot : uploadSlots_) {
+      hr = device_->CreateCommittedResource(
+        &uploadBufferHeapType, D3D12_HEAP_FLAG_NONE, &uploadBufferResourceDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&slot.buffer));
+      if (FAILED(hr)) {
+        g_messageLog.LogError("D3D12",
+                              "CreateOverlayTextures - CreateCommittedResource uploadTexture", hr);
+        return false;
+      }
+
+      CD3DX12_RANGE readRange(0, 0);
+      void* mappedMemory;
+      hr = slot.buffer->Map(0, &readRange, &mappedMemory);
+      if (FAILED(hr)) {
+        g_messageLog.LogError("D3D12", "CreateOverlayTextures - Mapping upload buffer failed.",
+                              hr);
+        return false;
+      }
+      slot.data = static_cast<unsigned char*>(mappedMemory);
     }
 
     device_->GetCopyableFootprints(&textureDesc, 0, 1, 0, &uploadFootprint_, nullptr, nullptr,
@@ -484,16 +531,6 @@ bool d3d12_renderer::CreateOverlayTextures()
                                       displayHeap_->GetCPUDescriptorHandleForHeapStart());
   }
 
-  // execute command list
-  hr = commandList_->Close();
-  if (FAILED(hr)) {
-    g_messageLog.LogError("D3D12", "CreateOverlayTextures - Failed closing CommandList", hr);
-    return false;
-  }
-  ID3D12CommandList* ppCommandLists[] = {commandList_.Get()};
-  queue_->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
-
-  WaitForCompletion();
   return true;
 }
 
@@ -529,6 +566,73 @@ bool d3d12_renderer::CreateConstantBuffer()
   return true;
 }
 
+void d3d12_renderer::CreateTimestampQueries()
+{
+  if (!RecordingState::GetInstance().IsOverlayGpuTimestampsEnabled()) {
+    return;
+  }
+
+  HRESULT hr = queue_->GetTimestampFrequency(&timestampFrequency_);
+  if (FAILED(hr) || timestampFrequency_ == 0) {
+    g_messageLog.LogWarning("D3D12", "Timestamps are not supported on the present queue.", hr);
+    return;
+  }
+
+  D3D12_QUERY_HEAP_DESC queryHeapDesc = {};
+  queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+  queryHeapDesc.Count = bufferCount_ * 2;
+  hr = device_->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&timestampHeap_));
+  if (FAILED(hr)) {
+    g_messageLog.LogWarning("D3D12", "CreateTimestampQueries - failed to create query heap.", hr);
+    return;
+  }
+
+  CD3DX12_HEAP_PROPERTIES readbackHeapProperties(D3D12_HEAP_TYPE_READBACK);
+  CD3DX12_RESOURCE_DESC bufDesc =
+      CD3DX12_RESOURCE_DESC::Buffer(queryHeapDesc.Count * sizeof(UINT64));
+  hr = device_->CreateCommittedResource(&readbackHeapProperties, D3D12_HEAP_FLAG_NONE, &bufDesc,
+                                        D3D12_RESOURCE_STATE_COPY_DEST, nullptr,
+                                        IID_PPV_ARGS(&timestampReadback_));
+  if (FAILED(hr)) {
+    g_messageLog.LogWarning("D3D12", "CreateTimestampQueries - failed to create readback buffer.",
+                            hr);
+    timestampHeap_.Reset();
+    return;
+  }
+
+  timestampFenceValues_.assign(bufferCount_, 0);
+}
+
+void d3d12_renderer::ReadOverlayTimestamps(int backBufferIndex)
+{
+  if (!timestampHeap_ || timestampFenceValues_[backBufferIndex] == 0) {
+    return;
+  }
+
+  // the queries are rewritten by the next pass on this back buffer, so a sample the GPU has
+  // not finished yet is dropped instead of waiting for it
+  const bool completed = fence_->GetCompletedValue() >= timestampFenceValues_[backBufferIndex];
+  timestampFenceValues_[backBufferIndex] = 0;
+  if (!completed) {
+    return;
+  }
+
+  const D3D12_RANGE readRange = {backBufferIndex * 2 * sizeof(UINT64),
+                                 (backBufferIndex + 1) * 2 * sizeof(UINT64)};
+  void* mappedMemory;
+  HRESULT hr = timestampReadback_->Map(0, &readRange, &mappedMemory);
+  if (FAILED(hr)) {
+    return;
+  }
+  const UINT64* timestamps = static_cast<const UINT64*>(mappedMemory) + backBufferIndex * 2;
+  const UINT64 ticks = timestamps[1] - timestamps[0];
+  const D3D12_RANGE writtenRange = {0, 0};
+  timestampReadback_->Unmap(0, &writtenRange);
+
+  overlayBitmap_->GetCostBudget().AddGpuCost(
+      static_cast<float>(static_cast<double>(ticks) * 1000000.0 / timestampFrequency_));
+}
+
 void d3d12_renderer::UpdateConstantBuffer(const ConstantBuffer& constantBuffer)
 {
   void* mappedMemory;
@@ -543,24 +647,37 @@ void d3d12_renderer::UpdateConstantBuffer(const ConstantBuffer& constantBuffer)
   viewportOffsetCB_->Unmap(0, nullptr);
 }
 
-void d3d12_renderer::UpdateOverlayTexture(int backBufferIndex)
+void d3d12_renderer::UpdateOverlayTexture(UINT64 frameFenceValue)
 {
-  const auto textureData = overlayBitmap_->GetBitmapDataRead();
-  if (textureData.dataPtr && textureData.size) {
-    CD3DX12_RANGE readRange(0, 0);
-    HRESULT hr = uploadBuffer_->Map(0, &readRange, &uploadDataPtr_);
-    if (FAILED(hr)) {
-      g_messageLog.LogError("D3D12", "UpdateOverlayTexture - Mapping failed.", hr);
-      return;
-    }
+  // only the regions which changed since the last upload are copied
+  overlayBitmap_->GetDirtyRects(uploadedDrawCount_, dirtyRects_);
+  if (dirtyRects_.empty()) {
+    return;
+  }
 
-    memcpy(uploadDataPtr_, textureData.dataPtr, textureData.size);
-    uploadBuffer_->Unmap(0, &readRange);
+  // if the GPU still copies from the oldest slot, the texture keeps its content for another
+  // frame and the changes are picked up by the next upload
+  UploadSlot& slot = uploadSlots_[nextUploadSlot_];
+  if (fence_->GetCompletedValue() < slot.fenceValue) {
+    return;
+  }
+  nextUploadSlot_ = (nextUploadSlot_ + 1) % uploadSlots_.size();
 
-    hr = commandList_->Reset(commandPool_[backBufferIndex].Get(), nullptr);
-    if (FAILED(hr)) {
-      g_messageLog.LogError("D3D12", "UpdateOverlayTexture - Failed to reset command list.", hr);
-      return;
+  // the slot was last written a few frames ago, so it needs every change since then
+  overlayBitmap_->GetDirtyRects(slot.drawCount, dirtyRects_);
+
+  const auto textureData = overlayBitmap_->GetBitmapDataRead();
+  if (textureData.dataPtr && textureData.size) {
+    // the upload buffer keeps its content, so only the dirty rows have to be written
+    // using the row pitch of the copyable footprint
+    const auto rowPitch = uploadFootprint_.Footprint.RowPitch;
+    auto dest = slot.data + uploadFootprint_.Offset;
+    for (const auto& rect : dirtyRects_) {
+      const size_t rowSize = static_cast<size_t>(rect.Width) * 4;
+      for (int y = rect.Y; y < rect.Y + rect.Height; ++y) {
+        memcpy(dest + y * rowPitch + rect.X * 4,
+               textureData.dataPtr + y * textureData.stride + rect.X * 4, rowSize);
+      }
     }
 
     const auto transitionWrite = CD3DX12_RESOURCE_BARRIER::Transition(
@@ -569,42 +686,37 @@ void d3d12_renderer::UpdateOverlayTexture(int backBufferIndex)
     commandList_->ResourceBarrier(1, &transitionWrite);
 
     CD3DX12_TEXTURE_COPY_LOCATION src_resource =
-      CD3DX12_TEXTURE_COPY_LOCATION(uploadBuffer_.Get(), uploadFootprint_);
+      CD3DX12_TEXTURE_COPY_LOCATION(slot.buffer.Get(), uploadFootprint_);
     CD3DX12_TEXTURE_COPY_LOCATION dest_resource;
     dest_resource.pResource = displayTexture_.Get();
     dest_resource.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
     dest_resource.SubresourceIndex = 0;
 
-    const auto& copyArea = overlayBitmap_->GetCopyArea();
-    const D3D12_BOX area = {
-      static_cast<UINT>(copyArea.left),  static_cast<UINT>(copyArea.top),    0,
-      static_cast<UINT>(copyArea.right), static_cast<UINT>(copyArea.bottom), 1};
-    commandList_->CopyTextureRegion(&dest_resource, 0, 0, 0, &src_resource, &area);
+    for (const auto& rect : dirtyRects_) {
+      const D3D12_BOX area = {
+        static_cast<UINT>(rect.X), static_cast<UINT>(rect.Y), 0,
+        static_cast<UINT>(rect.X + rect.Width), static_cast<UINT>(rect.Y + rect.Height), 1};
+      commandList_->CopyTextureRegion(&dest_resource, area.left, area.top, 0, &src_resource,
+                                      &area);
+    }
 
     const auto transitionRead =
       CD3DX12_RESOURCE_BARRIER::Transition(displayTexture_.Get(), D3D12_RESOURCE_STATE_COPY_DEST,
                                            D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, 0);
     commandList_->ResourceBarrier(1, &transitionRead);
 
-    hr = commandList_->Close();
-    if (FAILED(hr)) {
-      g_messageLog.LogError("D3D12", "UpdateOverlayTexture - Closing command list failed.", hr);
-      return;
-    }
-
-    // Execute draw commands
-    ID3D12CommandList* const commandlists[] = {commandList_.Get()};
-    queue_->ExecuteCommandLists(ARRAYSIZE(commandlists), commandlists);
+    slot.drawCount = overlayBitmap_->GetDrawCount();
+    slot.fenceValue = frameFenceValue;
+    uploadedDrawCount_ = slot.drawCount;
   }
   overlayBitmap_->UnlockBitmapData();
 }
 
-void d3d12_renderer::DrawOverlay(int currentIndex, bool lagIndicatorState)
+void d3d12_renderer::DrawOverlay(int currentIndex, bool lagIndicatorState,
+                                 UINT64 frameFenceValue)
 {
-  HRESULT hr = commandList_->Reset(commandPool_[currentIndex].Get(), nullptr);
-  if (FAILED(hr)) {
-    g_messageLog.LogError("D3D12", "DrawOverlay - Failed to reset command list.", hr);
-    return;
+  if (timestampHeap_) {
+    commandList_->EndQuery(timestampHeap_.Get(), D3D12_QUERY_TYPE_TIMESTAMP, currentIndex * 2);
   }
 
   if (!overlayBitmap_->GetLagIndicatorVisibility())
@@ -624,7 +736,7 @@ void d3d12_renderer::DrawOverlay(int currentIndex, bool lagIndicatorState)
   }
   else {
     void* mappedMemory;
-    hr = lagIndicatorKeyDownCB_->Map(0, nullptr, &mappedMemory);
+    HRESULT hr = lagIndicatorKeyDownCB_->Map(0, nullptr, &mappedMemory);
     if (FAILED(hr)) {
       g_messageLog.LogError(
         "D3D12", "Update Lag Meter Key Down Constant Buffer - failed to update constant buffer.",
@@ -663,40 +775,24 @@ void d3d12_renderer::DrawOverlay(int currentIndex, bool lagIndicatorState)
     D3D12_RESOURCE_STATE_PRESENT, 0);
   commandList_->ResourceBarrier(1, &transitionPresent);
 
-  hr = commandList_->Close();
-  if (FAILED(hr)) {
-    g_messageLog.LogError("D3D12", "DrawOverlay - Failed to close command list.", hr);
-    return;
+  if (timestampHeap_) {
+    commandList_->EndQuery(timestampHeap_.Get(), D3D12_QUERY_TYPE_TIMESTAMP,
+                           currentIndex * 2 + 1);
+    commandList_->ResolveQueryData(timestampHeap_.Get(), D3D12_QUERY_TYPE_TIMESTAMP,
+                                   currentIndex * 2, 2, timestampReadback_.Get(),
+                                   currentIndex * 2 * sizeof(UINT64));
+    timestampFenceValues_[currentIndex] = frameFenceValue;
   }
-
-  ID3D12CommandList* commandLists[] = {commandList_.Get()};
-  queue_->ExecuteCommandLists(1, commandLists);
-
-  queue_->Signal(frameFences_[currentIndex].Get(), currFenceValue_);
-  frameFenceValues_[currentIndex] = currFenceValue_;
-  ++currFenceValue_;
 }
 
 void d3d12_renderer::WaitForCompletion()
 {
-  HRESULT hr = device_->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
-  if (FAILED(hr)) {
-    g_messageLog.LogError("D3D12", "WaitForCompletion - CreateFence failed", hr);
+  if (!fence_ || !fenceEvent_) {
     return;
   }
-  fenceValue_ = 1;
 
-  fenceEvent_ = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-  if (fenceEvent_ == nullptr) {
-    hr = HRESULT_FROM_WIN32(GetLastError());
-    if (FAILED(hr)) {
-      g_messageLog.LogError("D3D12", "WaitForCompletion - CreateEvent failed", hr);
-      return;
-    }
-  }
-
-  const auto currFenceValue = fenceValue_;
-  hr = queue_->Signal(fence_.Get(), currFenceValue);
+  const auto currFenceValue = ++fenceValue_;
+  HRESULT hr = queue_->Signal(fence_.Get(), currFenceValue);
   if (FAILED(hr)) {
     g_messageLog.LogError("D3D12", "WaitForCompletion - Signal queue failed", hr);
     return;
@@ -709,7 +805,5 @@ void d3d12_renderer::WaitForCompletion()
       g_messageLog.LogError("D3D12", "WaitForCompletion - WaitForSingleObject timed out", hr);
     }
   }
-
-  CloseHandle(fenceEvent_);
 }
 }  // namespace GameOverlay
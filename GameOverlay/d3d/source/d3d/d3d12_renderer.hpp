@@ -28,6 +28,7 @@
 #include <d3d12.h>
 #include <dxgi1_4.h>
 #include <wrl.h>
+#include <deque>
 #include <vector>
 
 #include "Rendering/OverlayBitmap.h"
@@ -50,31 +51,62 @@ public:
 
   D3D12_VIEWPORT GetViewport() { return viewPort_; }
 
-  int GetLagIndicatorHotkey() { return overlayBitmap_->GetLagIndicatorHotkey(); }
   bool HideOverlay() { return overlayBitmap_->HideOverlay(); }
 
 private:
+  // Command allocator of a submitted frame, it can be reset once the GPU passed its fence value.
+  struct CommandAllocator {
+    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator;
+    UINT64 fenceValue = 0;
+  };
+
+  // Persistently mapped upload buffer, one slot per frame in flight.
+  struct UploadSlot {
+    Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+    unsigned char* data = nullptr;
+    // draw count of the overlay bitmap the slot content matches
+    UINT64 drawCount = 0;
+    // fence value of the last frame copying from the slot
+    UINT64 fenceValue = 0;
+  };
+
   bool CreateCMDList();
   bool CreateRenderTargets();
-  bool CreateFrameFences();
+  bool CreateFence();
   bool CreateRootSignature();
   bool CreatePipelineStateObject();
   bool CreateOverlayTextures();
   bool CreateConstantBuffer();
+  // Optional, the overlay works without timestamps if this fails.
+  void CreateTimestampQueries();
   void UpdateConstantBuffer(const ConstantBuffer & constantBuffer);
 
-  void UpdateOverlayTexture(int backBufferIndex);
+  // Returns the oldest allocator the GPU is done with, or a new one while the pool is not full.
+  // Returns nullptr instead of waiting if all allocators are still in use.
+  CommandAllocator* AcquireCommandAllocator();
+
+  // Record into the open command list, frameFenceValue is signaled after its execution.
+  void UpdateOverlayTexture(UINT64 frameFenceValue);
   void UpdateOverlayPosition();
-  void DrawOverlay(int currentIndex, bool lagIndicatorState);
+  void DrawOverlay(int currentIndex, bool lagIndicatorState, UINT64 frameFenceValue);
+  // Reads the timestamps of the last overlay pass on the back buffer if the GPU finished it.
+  void ReadOverlayTimestamps(int backBufferIndex);
 
+  // Only used on init and shutdown, the present path never waits on the fence.
   void WaitForCompletion();
 
+  // Upper bound of frames the overlay can have in flight, the maximum DXGI frame latency.
+  static const size_t maxCommandAllocators_;
+
   std::unique_ptr<OverlayBitmap> overlayBitmap_;
+  std::vector<WICRect> dirtyRects_;
+  UINT64 uploadedDrawCount_ = 0;
   Microsoft::WRL::ComPtr<ID3D12Device> device_;
   Microsoft::WRL::ComPtr<ID3D12CommandQueue> queue_;
   Microsoft::WRL::ComPtr<IDXGISwapChain3> swapchain_;
 
-  std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> commandPool_;
+  // in submission order, the front allocator is the first one to become available
+  std::deque<CommandAllocator> commandAllocators_;
   Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList_;
 
   Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature_;
@@ -88,9 +120,9 @@ private:
   std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> renderTargets_;
 
   Microsoft::WRL::ComPtr<ID3D12Resource> displayTexture_;
-  Microsoft::WRL::ComPtr<ID3D12Resource> uploadBuffer_;
+  std::vector<UploadSlot> uploadSlots_;
+  size_t nextUploadSlot_ = 0;
   D3D12_PLACED_SUBRESOURCE_FOOTPRINT uploadFootprint_;
-  void *uploadDataPtr_;
   Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> displayHeap_;
 
   Microsoft::WRL::ComPtr<ID3D12Resource> viewportOffsetCB_;
@@ -101,14 +133,18 @@ private:
   D3D12_VIEWPORT lagIndicatorViewPort_;
   D3D12_RECT lagIndicatorRectScissor_;
 
+  // Signaled with an increasing value after every overlay submission.
   Microsoft::WRL::ComPtr<ID3D12Fence> fence_;
-  UINT64 fenceValue_;
-  HANDLE fenceEvent_;
-
-  std::vector<Microsoft::WRL::ComPtr<ID3D12Fence>> frameFences_;
-  std::vector<HANDLE> frameFenceEvents_;
-  std::vector<UINT64> frameFenceValues_;
-  UINT64 currFenceValue_ = 0;
+  UINT64 fenceValue_ = 0;
+  HANDLE fenceEvent_ = nullptr;
+
+  // GPU time of the overlay pass, two timestamps per back buffer resolved into the readback
+  // buffer by the overlay command list
+  Microsoft::WRL::ComPtr<ID3D12QueryHeap> timestampHeap_;
+  Microsoft::WRL::ComPtr<ID3D12Resource> timestampReadback_;
+  UINT64 timestampFrequency_ = 0;
+  // fence value of the frame which wrote the timestamps of a back buffer, 0 if none are pending
+  std::vector<UINT64> timestampFenceValues_;
 
   int bufferCount_ = 0;
   bool initSuccessfull_ = false;
@@ -28,6 +28,7 @@
 #include <wrl.h>
 
 #include "Logging/MessageLog.h"
+#include "Recording/InputSampler.h"
 
 #include "oculus.h"
 #include "steamvr.h"
@@ -35,8 +36,6 @@
 using namespace Microsoft::WRL;
 extern bool g_uwpApp;
 
-#define KEY_DOWN(key) (key < 0 ? 0 : (GetAsyncKeyState(key) & 0x8000) != 0)
-
 DXGISwapChain::DXGISwapChain(ID3D11Device *device, IDXGISwapChain *swapChain)
     : d3d11Device_{device},
       swapChain_{swapChain},
@@ -285,50 +284,32 @@ HRESULT STDMETHODCALLTYPE DXGISwapChain::Present(UINT SyncInterval, UINT Flags)
 {
   // skip presents that are discarded
   if (Flags != DXGI_PRESENT_TEST) {
+    const bool lagIndicatorState = GameOverlay::g_inputSampler.GetLagIndicatorState();
     switch (d3dVersion_) {
       case D3DVersion_11:
         if (d3d11Renderer_) {
-          if (!d3d11Renderer_->HideOverlay()) d3d11Renderer_->on_present(lagIndicatorState_);
+          if (!d3d11Renderer_->HideOverlay()) d3d11Renderer_->on_present(lagIndicatorState);
         }
         else {
           d3d11Renderer_ = std::make_unique<GameOverlay::d3d11_renderer>(
               d3d11Device_.Get(), swapChain_);
-          d3d11Renderer_->on_present(lagIndicatorState_);
+          d3d11Renderer_->on_present(lagIndicatorState);
         }
         break;
       case D3DVersion_12:
         if (d3d12Renderer_) {
-          if (!d3d12Renderer_->HideOverlay()) d3d12Renderer_->on_present(lagIndicatorState_);
+          if (!d3d12Renderer_->HideOverlay()) d3d12Renderer_->on_present(lagIndicatorState);
         }
         else {
           d3d12Renderer_ = std::make_unique<GameOverlay::d3d12_renderer>(
               d3d12CommandQueue_.Get(), static_cast<IDXGISwapChain3 *>(swapChain_));
-          d3d12Renderer_->on_present(lagIndicatorState_);
-        }
-        break;
-    }
-  }
-
-  HRESULT result = swapChain_->Present(SyncInterval, Flags);
-
-  if (Flags != DXGI_PRESENT_TEST) {
-    mutex_.lock();
-    switch (d3dVersion_) {
-      case D3DVersion_11:
-        if (d3d11Renderer_) {
-          lagIndicatorState_ = KEY_DOWN(d3d11Renderer_->GetLagIndicatorHotkey());
-        }
-        break;
-      case D3DVersion_12:
-        if (d3d12Renderer_) {
-          lagIndicatorState_ = KEY_DOWN(d3d12Renderer_->GetLagIndicatorHotkey());
+          d3d12Renderer_->on_present(lagIndicatorState);
         }
         break;
     }
-    mutex_.unlock();
   }
 
-  return result;
+  return swapChain_->Present(SyncInterval, Flags);
 }
 HRESULT STDMETHODCALLTYPE DXGISwapChain::GetBuffer(UINT Buffer, REFIID riid, void **ppSurface)
 {
@@ -414,51 +395,33 @@ HRESULT STDMETHODCALLTYPE DXGISwapChain::Present1(UINT SyncInterval, UINT Presen
 {
   // skip presents that are discarded
   if (PresentFlags != DXGI_PRESENT_TEST) {
+    const bool lagIndicatorState = GameOverlay::g_inputSampler.GetLagIndicatorState();
     switch (d3dVersion_) {
       case D3DVersion_11:
         if (d3d11Renderer_) {
-          d3d11Renderer_->on_present(lagIndicatorState_);
+          d3d11Renderer_->on_present(lagIndicatorState);
         }
         else {
           d3d11Renderer_ = std::make_unique<GameOverlay::d3d11_renderer>(
               d3d11Device_.Get(), swapChain_);
-          d3d11Renderer_->on_present(lagIndicatorState_);
+          d3d11Renderer_->on_present(lagIndicatorState);
         }
         break;
       case D3DVersion_12:
         if (d3d12Renderer_) {
-          d3d12Renderer_->on_present(lagIndicatorState_);
+          d3d12Renderer_->on_present(lagIndicatorState);
         }
         else {
           d3d12Renderer_ = std::make_unique<GameOverlay::d3d12_renderer>(
               d3d12CommandQueue_.Get(), static_cast<IDXGISwapChain3 *>(swapChain_));
-          d3d12Renderer_->on_present(lagIndicatorState_);
-        }
-        break;
-    }
-  }
-
-  HRESULT result = static_cast<IDXGISwapChain1 *>(swapChain_)
-                       ->Present1(SyncInterval, PresentFlags, pPresentParameters);
-
-  if (PresentFlags != DXGI_PRESENT_TEST) {
-    mutex_.lock();
-    switch (d3dVersion_) {
-      case D3DVersion_11:
-        if (d3d11Renderer_) {
-          lagIndicatorState_ = KEY_DOWN(d3d11Renderer_->GetLagIndicatorHotkey());
-        }
-        break;
-      case D3DVersion_12:
-        if (d3d12Renderer_) {
-          lagIndicatorState_ = KEY_DOWN(d3d12Renderer_->GetLagIndicatorHotkey());
+          d3d12Renderer_->on_present(lagIndicatorState);
         }
         break;
     }
-    mutex_.unlock();
   }
 
-  return result;
+  return static_cast<IDXGISwapChain1 *>(swapChain_)
+      ->Present1(SyncInterval, PresentFlags, pPresentParameters);
 }
 BOOL STDMETHODCALLTYPE DXGISwapChain::IsTemporaryMonoSupported()
 {
@@ -28,7 +28,6 @@
 #include <dxgi1_5.h>
 #include <wrl.h>
 #include <memory>
-#include <mutex>
 #include "d3d11_renderer.hpp"
 #include "d3d12_renderer.hpp"
 
@@ -131,8 +130,6 @@ struct DXGISwapChain : IDXGISwapChain4 {
   D3DVersion d3dVersion_ = D3DVersion_Undefined;
   SwapChainVersion swapChainVersion_ = SWAPCHAIN_0;
 
-  bool lagIndicatorState_ = false;
-  std::mutex mutex_;
 
   bool interfaceQueried_ = false;
 };
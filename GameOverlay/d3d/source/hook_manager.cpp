@@ -28,6 +28,7 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <atomic>
 #include <unordered_map>
 #include <vector>
 #include "Overlay/DLLInjection.h"
@@ -37,6 +38,7 @@
 #include "Utility/FileDirectory.h"
 #include "Logging/MessageLog.h"
 #include "critical_section.hpp"
+#include "trampoline_table.hpp"
 #include "Utility/ProcessHelper.h"
 #include "Utility/SmartHandle.h"
 
@@ -119,6 +121,20 @@ namespace GameOverlay {
     std::vector<std::pair<hook, hook_method>> s_hooks;
     std::unordered_map<hook::address, hook::address *> s_vtable_addresses;
 
+    // Only written while s_cs is held.
+    trampoline_table s_trampoline_table;
+    // Set if a hook did not fit into the table, lookups then fall back to s_hooks.
+    std::atomic<bool> s_trampoline_table_full{false};
+
+    // s_cs must be held.
+    void publish_trampoline(hook::address replacement, hook::address trampoline)
+    {
+      if (!s_trampoline_table.publish(replacement, trampoline)) {
+        g_messageLog.LogWarning("install_hook", "Trampoline table is full");
+        s_trampoline_table_full = true;
+      }
+    }
+
     bool install_hook(hook::address target, hook::address replacement, hook_method method)
     {
       hook hook(target, replacement);
@@ -157,6 +173,7 @@ namespace GameOverlay {
       const critical_section::lock lock(s_cs);
 
       s_hooks.emplace_back(std::move(hook), method);
+      publish_trampoline(s_hooks.back().first.replacement, s_hooks.back().first.trampoline);
 
       g_messageLog.LogVerbose("install_hook", "Successfully installed hook");
       return true;
@@ -786,6 +803,7 @@ namespace GameOverlay {
     // Uninstall hooks
     for (auto &hook : s_hooks) {
       uninstall_hook(hook.first, hook.second);
+      s_trampoline_table.clear(hook.first.replacement);
     }
 
     s_hooks.clear();
@@ -937,6 +955,11 @@ namespace GameOverlay {
 
   __declspec(dllexport) hook::address find_hook_trampoline(hook::address replacement)
   {
+    hook::address trampoline = nullptr;
+    if (s_trampoline_table.lookup(replacement, trampoline) || !s_trampoline_table_full) {
+      return trampoline;
+    }
+
     const hook hook = find_hook(replacement);
 
     if (!hook.valid()) {
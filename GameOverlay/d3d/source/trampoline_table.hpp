@@ -0,0 +1,117 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Trampolines of the installed hooks keyed by their replacement, so that find_hook_trampoline,
+// which runs on every hooked call, does not take a lock. Open addressing with linear probing.
+// Writers have to be serialized, readers probe with acquire loads. Keys are never removed,
+// uninstalled hooks keep their slot with a null trampoline.
+class trampoline_table {
+ public:
+  typedef void *address;
+
+  static const size_t size = 1024;
+
+  // The first trampoline published for a replacement wins until it is cleared, like the first
+  // matching hook in the list of installed hooks. Returns false if the table is full.
+  bool publish(address replacement, address trampoline)
+  {
+    size_t index = get_slot(replacement);
+    for (size_t i = 0; i < size; ++i) {
+      auto &slot = _slots[index];
+      const auto key = slot.replacement.load(std::memory_order_relaxed);
+      if (key == replacement) {
+        if (slot.trampoline.load(std::memory_order_relaxed) == nullptr) {
+          slot.trampoline.store(trampoline, std::memory_order_release);
+        }
+        return true;
+      }
+      if (key == nullptr) {
+        // the trampoline has to be visible before readers can find the key
+        slot.trampoline.store(trampoline, std::memory_order_relaxed);
+        slot.replacement.store(replacement, std::memory_order_release);
+        return true;
+      }
+      index = (index + 1) & (size - 1);
+    }
+    return false;
+  }
+
+  void clear(address replacement)
+  {
+    size_t index = get_slot(replacement);
+    for (size_t i = 0; i < size; ++i) {
+      auto &slot = _slots[index];
+      const auto key = slot.replacement.load(std::memory_order_relaxed);
+      if (key == replacement) {
+        slot.trampoline.store(nullptr, std::memory_order_release);
+        return;
+      }
+      if (key == nullptr) {
+        return;
+      }
+      index = (index + 1) & (size - 1);
+    }
+  }
+
+  // Lock-free, returns false if the replacement is not in the table.
+  bool lookup(address replacement, address &trampoline) const
+  {
+    size_t index = get_slot(replacement);
+    for (size_t i = 0; i < size; ++i) {
+      const auto &slot = _slots[index];
+      const auto key = slot.replacement.load(std::memory_order_acquire);
+      if (key == replacement) {
+        trampoline = slot.trampoline.load(std::memory_order_acquire);
+        return true;
+      }
+      if (key == nullptr) {
+        return false;
+      }
+      index = (index + 1) & (size - 1);
+    }
+    return false;
+  }
+
+ private:
+  struct slot {
+    std::atomic<address> replacement{nullptr};
+    std::atomic<address> trampoline{nullptr};
+  };
+
+  static size_t get_slot(address replacement)
+  {
+    // function addresses are aligned, so the low bits carry little information
+    auto key = reinterpret_cast<uintptr_t>(replacement) >> 4;
+    key ^= key >> 16;
+    key *= 0x45d9f3b;
+    key ^= key >> 16;
+    return static_cast<size_t>(key) & (size - 1);
+  }
+
+  slot _slots[size];
+};
@@ -47,8 +47,12 @@ void AppResMapping::EnumeratePhysicalDevices(VkInstance instance, VkInstDispatch
     for (uint32_t i = 0; i < *pPhysicalDeviceCount; ++i) {
       VkPhysicalDeviceMemoryProperties memoryProperties;
       pTable->GetPhysicalDeviceMemoryProperties(pPhysicalDevices[i], &memoryProperties);
-      physicalDeviceMapping_.Add(pPhysicalDevices[i],
-                                 new PhysicalDeviceMapping{instance, memoryProperties});
+      VkPhysicalDeviceProperties properties;
+      pTable->GetPhysicalDeviceProperties(pPhysicalDevices[i], &properties);
+      physicalDeviceMapping_.Add(
+          pPhysicalDevices[i],
+          new PhysicalDeviceMapping{instance, memoryProperties, {},
+                                    properties.limits.timestampPeriod});
     }
   }
 }
@@ -22,7 +22,9 @@
 
 #pragma once
 
+#ifdef _WIN32
 #define VK_USE_PLATFORM_WIN32_KHR
+#endif
 #include <assert.h>
 
 #include "vk_dispatch_defs.h"
@@ -50,6 +52,8 @@ class AppResMapping {
     VkInstance instance;
     VkPhysicalDeviceMemoryProperties memoryProperties;
     std::vector<VkQueueFamilyProperties> queueProperties;
+    // nanoseconds per timestamp tick
+    float timestampPeriod;
   };
   PhysicalDeviceMapping* GetPhysicalDeviceMapping(VkPhysicalDevice physicalDevice) const;
 
@@ -20,89 +20,295 @@
 // SOFTWARE.
 //
 
+
 #pragma once
 
-#include <algorithm>
-#include <shared_mutex>
-#include <unordered_map>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
+// Open addressing table for the layer's handle mappings, looked up on every submit and present
+// from any thread. Reads do not lock: they probe the current slot array. Writers are
+// serialized by a mutex and insert in place, removed keys become tombstones which later
+// insertions reuse. Once used slots and tombstones fill half the array, it is copied into a new
+// one. Readers may still probe the old array, it is deleted by a later write once every reader
+// which started before the copy has finished.
 template <typename Key, typename T>
 class HashMap {
  public:
-  HashMap() {}
+  HashMap() : table_(CreateTable(minCapacity_))
+  {
+    // Empty
+  }
+
+  HashMap(const HashMap&) = delete;
+  HashMap& operator=(const HashMap&) = delete;
+
+  ~HashMap()
+  {
+    delete table_.load();
+    for (auto table : retiredTables_) {
+      delete table;
+    }
+    for (auto table : gracePeriodTables_) {
+      delete table;
+    }
+  }
+
   void Add(Key key, T value)
   {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
-    if (Find(key) != map_.end()) {
-      return;
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    const auto keyBits = ToBits(key);
+    auto table = table_.load(std::memory_order_relaxed);
+    if (!FindSlot(table, keyBits)) {
+      size_t index = FindInsertSlot(table, keyBits);
+      if (table->slots[index].key.load(std::memory_order_relaxed) == empty_) {
+        if ((table->usedSlots + 1) * 2 > table->capacity) {
+          table = Rehash(table, size_ + 1);
+          index = FindInsertSlot(table, keyBits);
+        }
+        table->usedSlots++;
+      }
+
+      // the value has to be visible before readers can match the key
+      Slot& slot = table->slots[index];
+      slot.value.store(value, std::memory_order_relaxed);
+      slot.key.store(keyBits, std::memory_order_release);
+      size_.store(size_ + 1, std::memory_order_relaxed);
     }
-    map_.push_back(std::make_pair(key, value));
+    ReclaimTables();
   }
 
   void Remove(Key key)
   {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
-    auto it = Find(key);
-    if (it != map_.end()) {
-      map_.erase(it);
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    Slot* slot = FindSlot(table_.load(std::memory_order_relaxed), ToBits(key));
+    if (slot) {
+      slot->key.store(tombstone_, std::memory_order_release);
+      size_.store(size_ - 1, std::memory_order_relaxed);
     }
+    ReclaimTables();
   }
 
   bool Has(Key key) const
   {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    auto it = Find(key);
-    return it != map_.end();
+    ReadGuard guard(*this);
+    return FindSlot(guard.table, ToBits(key));
   }
 
   T Get(Key key) const
   {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    auto it = Find(key);
-    if (it != map_.end()) {
-      return it->second;
+    ReadGuard guard(*this);
+    const Slot* slot = FindSlot(guard.table, ToBits(key));
+    if (slot) {
+      return slot->value.load(std::memory_order_relaxed);
     }
 
     return T(0);
   }
 
   template <class UnaryPredicate>
-  Key FindKey_if(UnaryPredicate pred)
+  Key FindKey_if(UnaryPredicate pred) const
   {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    auto it = std::find_if(map_.begin(), map_.end(), pred);
-    if (it != map_.end()) {
-      return it->first;
+    ReadGuard guard(*this);
+    const Table* table = guard.table;
+    for (size_t i = 0; i < table->capacity; ++i) {
+      const auto keyBits = table->slots[i].key.load(std::memory_order_acquire);
+      if (keyBits != empty_ && keyBits != tombstone_) {
+        const auto entry = std::make_pair(FromBits(keyBits, Key()),
+                                          table->slots[i].value.load(std::memory_order_relaxed));
+        if (pred(entry)) {
+          return entry.first;
+        }
+      }
     }
 
     return Key(0);
   }
 
+  // Removes all entries the predicate returns true for.
   template <class UnaryPredicate>
   void RemoveKeys_if(UnaryPredicate pred)
   {
-      if (map_.size() == 0)
-      {
-          return;
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    Table* table = table_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < table->capacity; ++i) {
+      Slot& slot = table->slots[i];
+      const auto keyBits = slot.key.load(std::memory_order_relaxed);
+      if (keyBits != empty_ && keyBits != tombstone_ &&
+          pred(std::make_pair(FromBits(keyBits, Key()),
+                              slot.value.load(std::memory_order_relaxed)))) {
+        slot.key.store(tombstone_, std::memory_order_release);
+        size_.store(size_ - 1, std::memory_order_relaxed);
+      }
+    }
+    ReclaimTables();
+  }
+
+  size_t GetSize() const { return size_.load(std::memory_order_relaxed); }
+
+ protected:
+  struct Slot {
+    std::atomic<std::uint64_t> key{0};
+    std::atomic<T> value{T(0)};
+  };
+
+  struct Table {
+    size_t capacity;
+    // live keys and tombstones, only changed by writers
+    size_t usedSlots;
+    std::unique_ptr<Slot[]> slots;
+  };
+
+  // Counts the reader in the current epoch while it probes the table it loaded. A reader which
+  // sees the epoch change before it is counted starts over, it might have been missed by a
+  // writer checking the count of the old epoch.
+  struct ReadGuard {
+    explicit ReadGuard(const HashMap& map) : readers(nullptr)
+    {
+      for (;;) {
+        const size_t epoch = map.epoch_.load(std::memory_order_seq_cst);
+        readers = &map.readers_[epoch & 1];
+        readers->fetch_add(1, std::memory_order_seq_cst);
+        if (map.epoch_.load(std::memory_order_seq_cst) == epoch) {
+          break;
+        }
+        readers->fetch_sub(1, std::memory_order_release);
       }
+      table = map.table_.load(std::memory_order_acquire);
+    }
+    ~ReadGuard() { readers->fetch_sub(1, std::memory_order_release); }
 
-      std::unique_lock<std::shared_mutex> lock(mutex_);
-      map_.erase(std::remove_if(map_.begin(), map_.end(), pred));
+    ReadGuard(const ReadGuard&) = delete;
+    ReadGuard& operator=(const ReadGuard&) = delete;
+
+    std::atomic<size_t>* readers;
+    const Table* table;
+  };
+
+  // Handles are compared as integers, dispatchable handles are pointers and non-dispatchable
+  // handles are 64 bit integers on 32 bit platforms.
+  template <typename Handle>
+  static std::uint64_t ToBits(Handle* key)
+  {
+    return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(key));
   }
+  static std::uint64_t ToBits(std::uint64_t key) { return key; }
+  template <typename Handle>
+  static Handle* FromBits(std::uint64_t bits, Handle*)
+  {
+    return reinterpret_cast<Handle*>(static_cast<std::uintptr_t>(bits));
+  }
+  static std::uint64_t FromBits(std::uint64_t bits, std::uint64_t) { return bits; }
 
-  size_t GetSize() const
+  static size_t GetHomeSlot(const Table* table, std::uint64_t keyBits)
   {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    return map_.size();
+    // handles are aligned allocations, the multiplication mixes the low bits
+    return static_cast<size_t>((keyBits * 0x9E3779B97F4A7C15ull) >> 32) & (table->capacity - 1);
   }
 
- protected:
-  auto Find(Key key) const
+  static Table* CreateTable(size_t capacity)
+  {
+    return new Table{capacity, 0, std::unique_ptr<Slot[]>(new Slot[capacity])};
+  }
+
+  static Slot* FindSlot(const Table* table, std::uint64_t keyBits)
+  {
+    if (keyBits == empty_ || keyBits == tombstone_) {
+      return nullptr;
+    }
+
+    // at least half of the slots are empty, the probe sequence ends at one of them
+    size_t index = GetHomeSlot(table, keyBits);
+    for (size_t i = 0; i < table->capacity; ++i) {
+      Slot& slot = table->slots[index];
+      const auto slotKey = slot.key.load(std::memory_order_acquire);
+      if (slotKey == keyBits) {
+        return &slot;
+      }
+      if (slotKey == empty_) {
+        return nullptr;
+      }
+      index = (index + 1) & (table->capacity - 1);
+    }
+    return nullptr;
+  }
+
+  // First tombstone or empty slot of the key's probe sequence. A reused tombstone never ends
+  // the probe sequence of another key. Removing a handle while another thread still uses it is
+  // not valid in Vulkan, so no reader can match the removed key when the slot gets a new one.
+  static size_t FindInsertSlot(const Table* table, std::uint64_t keyBits)
+  {
+    size_t index = GetHomeSlot(table, keyBits);
+    for (;;) {
+      const auto slotKey = table->slots[index].key.load(std::memory_order_relaxed);
+      if (slotKey == empty_ || slotKey == tombstone_) {
+        return index;
+      }
+      index = (index + 1) & (table->capacity - 1);
+    }
+  }
+
+  // Copies the live entries into a new table sized for the given number of entries.
+  Table* Rehash(Table* table, size_t size)
   {
-    return std::find_if(map_.begin(), map_.end(),
-                        [&key](const std::pair<Key, T>& v) { return v.first == key; });
+    size_t capacity = minCapacity_;
+    while (capacity < size * 4) {
+      capacity *= 2;
+    }
+
+    Table* newTable = CreateTable(capacity);
+    for (size_t i = 0; i < table->capacity; ++i) {
+      const auto keyBits = table->slots[i].key.load(std::memory_order_relaxed);
+      if (keyBits != empty_ && keyBits != tombstone_) {
+        Slot& slot = newTable->slots[FindInsertSlot(newTable, keyBits)];
+        slot.value.store(table->slots[i].value.load(std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+        slot.key.store(keyBits, std::memory_order_relaxed);
+        newTable->usedSlots++;
+      }
+    }
+
+    table_.store(newTable, std::memory_order_release);
+    retiredTables_.push_back(table);
+    return newTable;
   }
 
-  mutable std::shared_mutex mutex_;
-  std::vector<std::pair<Key, T>> map_;
-};
\ No newline at end of file
+  // Tables retired in the current epoch may be used by readers of the current and of the
+  // previous epoch, the tables of the grace period only by readers of the previous epoch. Once
+  // those are done, the grace period tables are deleted and a new epoch starts for the
+  // tables retired since. Never waits, a later write retries if readers are still counted.
+  void ReclaimTables()
+  {
+    const size_t epoch = epoch_.load(std::memory_order_relaxed);
+    if (readers_[(epoch + 1) & 1].load(std::memory_order_seq_cst) != 0) {
+      return;
+    }
+
+    for (auto table : gracePeriodTables_) {
+      delete table;
+    }
+    gracePeriodTables_.clear();
+
+    if (!retiredTables_.empty()) {
+      gracePeriodTables_.swap(retiredTables_);
+      epoch_.store(epoch + 1, std::memory_order_seq_cst);
+    }
+  }
+
+  static const size_t minCapacity_ = 16;
+  static const std::uint64_t empty_ = 0;
+  static const std::uint64_t tombstone_ = ~0ull;
+
+  std::atomic<Table*> table_;
+  std::atomic<size_t> size_{0};
+  std::mutex writeMutex_;
+  std::vector<Table*> retiredTables_;
+  std::vector<Table*> gracePeriodTables_;
+  std::atomic<size_t> epoch_{0};
+  // readers counted in even and odd epochs
+  mutable std::atomic<size_t> readers_[2] = {{0}, {0}};
+};
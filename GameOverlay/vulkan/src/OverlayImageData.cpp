@@ -23,77 +23,175 @@
 #include "OverlayImageData.h"
 #include "Logging/MessageLog.h"
 
-bool OverlayImageData::CopyBuffer(VkDevice device, VkDeviceSize size, 
-  VkDevDispatchTable* pTable, PFN_vkSetDeviceLoaderData setDeviceLoaderDataFuncPtr, 
-  VkCommandPool commandPool, VkQueue queue)
+#include <algorithm>
+
+namespace {
+bool EqualRegions(const std::vector<VkBufferCopy>& a, const std::vector<VkBufferCopy>& b)
+{
+  return a.size() == b.size() &&
+    std::equal(a.begin(), a.end(), b.begin(), [](const VkBufferCopy& x, const VkBufferCopy& y) {
+      return x.srcOffset == y.srcOffset && x.dstOffset == y.dstOffset && x.size == y.size;
+    });
+}
+} // namespace
+
+bool OverlayImageData::CopiesPending(VkDevice device, VkDevDispatchTable* pTable)
 {
-  if (commandBuffer[commandBufferIndex] != VK_NULL_HANDLE)
+  for (auto& copyCommand : copyCommands)
   {
-#if _DEBUG
-    pTable->WaitForFences(device, 1, &commandBufferFence[commandBufferIndex], VK_TRUE, UINT64_MAX);
-    pTable->ResetFences(device, 1, &commandBufferFence[commandBufferIndex]);
-#endif
-    pTable->FreeCommandBuffers(device, commandPool, 1, &commandBuffer[commandBufferIndex]);
+    auto& command = copyCommand.second;
+    if (command.pending)
+    {
+      if (pTable->GetFenceStatus(device, command.fence) != VK_SUCCESS)
+      {
+        return true;
+      }
+      pTable->ResetFences(device, 1, &command.fence);
+      command.pending = false;
+    }
   }
+  return false;
+}
 
-  VkCommandBufferAllocateInfo cmdBufferAllocateInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
-  cmdBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  cmdBufferAllocateInfo.commandPool = commandPool;
-  cmdBufferAllocateInfo.commandBufferCount = 1;
-
-  VkResult result = pTable->AllocateCommandBuffers(device, &cmdBufferAllocateInfo, &commandBuffer[commandBufferIndex]);
-  if (result != VK_SUCCESS)
+void OverlayImageData::WaitForCopies(VkDevice device, VkDevDispatchTable* pTable)
+{
+  for (auto& copyCommand : copyCommands)
   {
-    return false;
+    auto& command = copyCommand.second;
+    if (command.pending)
+    {
+      pTable->WaitForFences(device, 1, &command.fence, VK_TRUE, UINT64_MAX);
+      pTable->ResetFences(device, 1, &command.fence);
+      command.pending = false;
+    }
   }
+}
 
-  VkDevice cmdBuf = static_cast<VkDevice>(static_cast<void*>(commandBuffer[commandBufferIndex]));
-  setDeviceLoaderDataFuncPtr(device, cmdBuf);
+bool OverlayImageData::FlushHostMemory(VkDevice device, VkDevDispatchTable* pTable)
+{
+  if (overlayHostCoherent)
+  {
+    return true;
+  }
 
-  VkCommandBufferBeginInfo cmdBufferBeginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
-  cmdBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  VkMappedMemoryRange range = { VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE };
+  range.memory = overlayHostMemory;
+  range.offset = 0;
+  range.size = VK_WHOLE_SIZE;
+  return pTable->FlushMappedMemoryRanges(device, 1, &range) == VK_SUCCESS;
+}
 
-  result = pTable->BeginCommandBuffer(commandBuffer[commandBufferIndex], &cmdBufferBeginInfo);
-  if (result != VK_SUCCESS)
+bool OverlayImageData::CopyBuffer(VkDevice device, const std::vector<VkBufferCopy>& regions,
+  VkDevDispatchTable* pTable, PFN_vkSetDeviceLoaderData setDeviceLoaderDataFuncPtr, 
+  VkCommandPool commandPool, VkQueue queue, uint32_t queueFamilyIndex)
+{
+  if (regions.empty())
   {
-    g_messageLog.LogError("CopyBuffer", "Failed to begin command buffer." + std::to_string(static_cast<int>(result)));
-    pTable->FreeCommandBuffers(device, commandPool, 1, &commandBuffer[commandBufferIndex]);
-    return false;
+    // the render pass waits for the copy semaphore, signal it without copying anything
+    VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &overlayCopySemaphore;
+    return pTable->QueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) == VK_SUCCESS;
   }
 
-  VkBufferCopy bufferCopy = {};
-  bufferCopy.size = size;
-  pTable->CmdCopyBuffer(commandBuffer[commandBufferIndex], overlayHostBuffer, overlayBuffer, 1, &bufferCopy);
+  auto& copyCommand = copyCommands[queueFamilyIndex];
+  if (copyCommand.commandBuffer == VK_NULL_HANDLE)
+  {
+    VkCommandBufferAllocateInfo cmdBufferAllocateInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    cmdBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmdBufferAllocateInfo.commandPool = commandPool;
+    cmdBufferAllocateInfo.commandBufferCount = 1;
 
-  result = pTable->EndCommandBuffer(commandBuffer[commandBufferIndex]);
-  if (result != VK_SUCCESS)
+    VkResult result = pTable->AllocateCommandBuffers(device, &cmdBufferAllocateInfo, &copyCommand.commandBuffer);
+    if (result != VK_SUCCESS)
+    {
+      copyCommand.commandBuffer = VK_NULL_HANDLE;
+      return false;
+    }
+
+    VkDevice cmdBuf = static_cast<VkDevice>(static_cast<void*>(copyCommand.commandBuffer));
+    setDeviceLoaderDataFuncPtr(device, cmdBuf);
+
+    VkFenceCreateInfo fenceCreateInfo = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    result = pTable->CreateFence(device, &fenceCreateInfo, nullptr, &copyCommand.fence);
+    if (result != VK_SUCCESS)
+    {
+      pTable->FreeCommandBuffers(device, commandPool, 1, &copyCommand.commandBuffer);
+      copyCommands.erase(queueFamilyIndex);
+      return false;
+    }
+  }
+
+  // the overlay elements change at different rates, most presents copy the same regions
+  if (!EqualRegions(copyCommand.regions, regions))
   {
-    pTable->FreeCommandBuffers(device, commandPool, 1, &commandBuffer[commandBufferIndex]);
-    return false;
+    if (!RecordCopy(device, copyCommand, regions, pTable))
+    {
+      return false;
+    }
   }
 
   VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
   submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &commandBuffer[commandBufferIndex];
+  submitInfo.pCommandBuffers = &copyCommand.commandBuffer;
   submitInfo.signalSemaphoreCount = 1;
   submitInfo.pSignalSemaphores = &overlayCopySemaphore;
 
-#if _DEBUG
-  result = pTable->QueueSubmit(queue, 1, &submitInfo, commandBufferFence[commandBufferIndex]);
-#else
-  result = pTable->QueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
-#endif
+  VkResult result = pTable->QueueSubmit(queue, 1, &submitInfo, copyCommand.fence);
   if (result != VK_SUCCESS)
   {
     if (result == VK_ERROR_INITIALIZATION_FAILED)
     {
       g_messageLog.LogError("CopyBuffer", "Queue Submit: Initialization failed.");
     }
-    pTable->FreeCommandBuffers(device, commandPool, 1, &commandBuffer[commandBufferIndex]);
     return false;
   }
 
-  // toggles: from 0 to 1 and from 1 to 0
-  commandBufferIndex = 1 - commandBufferIndex;
+  copyCommand.pending = true;
   return true;
 }
+
+bool OverlayImageData::RecordCopy(VkDevice device, CopyCommand& copyCommand,
+  const std::vector<VkBufferCopy>& regions, VkDevDispatchTable* pTable)
+{
+  // the fence was signaled, the command buffer is not in use
+  copyCommand.regions.clear();
+  VkResult result = pTable->ResetCommandBuffer(copyCommand.commandBuffer, 0);
+  if (result != VK_SUCCESS)
+  {
+    return false;
+  }
+
+  VkCommandBufferBeginInfo cmdBufferBeginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+  result = pTable->BeginCommandBuffer(copyCommand.commandBuffer, &cmdBufferBeginInfo);
+  if (result != VK_SUCCESS)
+  {
+    g_messageLog.LogError("CopyBuffer", "Failed to begin command buffer." + std::to_string(static_cast<int>(result)));
+    return false;
+  }
+
+  pTable->CmdCopyBuffer(copyCommand.commandBuffer, overlayHostBuffer, overlayBuffer,
+    static_cast<uint32_t>(regions.size()), regions.data());
+
+  result = pTable->EndCommandBuffer(copyCommand.commandBuffer);
+  if (result != VK_SUCCESS)
+  {
+    return false;
+  }
+
+  copyCommand.regions = regions;
+  return true;
+}
+
+void OverlayImageData::DestroyCopyCommands(VkDevice device, VkDevDispatchTable* pTable)
+{
+  WaitForCopies(device, pTable);
+  for (auto& copyCommand : copyCommands)
+  {
+    if (copyCommand.second.fence != VK_NULL_HANDLE)
+    {
+      pTable->DestroyFence(device, copyCommand.second.fence, nullptr);
+    }
+  }
+  copyCommands.clear();
+}
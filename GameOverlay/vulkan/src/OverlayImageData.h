@@ -22,27 +22,59 @@
 
 #pragma once
 
+#ifdef _WIN32
 #define VK_USE_PLATFORM_WIN32_KHR
+#endif
 #include <assert.h>
 #include "vk_dispatch_defs.h"
 #include <vulkan/vk_layer.h>
 #include <vulkan/vulkan.h>
 
+#include <unordered_map>
+#include <vector>
+
 struct OverlayImageData {
+  // Copy from the host buffer, recorded once per queue family and only re-recorded when the
+  // copied regions change. The fence guards the command buffer and the host buffer.
+  struct CopyCommand {
+    VkCommandBuffer commandBuffer;
+    VkFence fence;
+    bool pending;
+    std::vector<VkBufferCopy> regions;
+  };
+
   VkBuffer overlayHostBuffer;
   VkDeviceMemory overlayHostMemory;
+  // persistently mapped overlayHostMemory, needs a flush after writes if it is not coherent
+  unsigned char* overlayHostData;
+  bool overlayHostCoherent;
   VkBuffer overlayBuffer;
   VkBufferView bufferView;
   VkDeviceMemory overlayMemory;
-  uint32_t commandBufferIndex;
-  VkCommandBuffer commandBuffer[2];
-  VkFence commandBufferFence[2];
+  std::unordered_map<uint32_t, CopyCommand> copyCommands;
   VkSemaphore overlayCopySemaphore;
   VkDescriptorSet descriptorSet;
   VkDescriptorSet lagIndicatorDescriptorSet;
   bool valid;
+  // draw count of the overlay bitmap the host buffer was last updated with
+  uint64_t bitmapDrawCount;
 
-  bool CopyBuffer(VkDevice device, VkDeviceSize size, VkDevDispatchTable* pTable,
+  // True while a submitted copy may still read the host buffer, does not wait for it.
+  bool CopiesPending(VkDevice device, VkDevDispatchTable* pTable);
+  // Waits for pending copies of the host buffer, only used before destruction.
+  void WaitForCopies(VkDevice device, VkDevDispatchTable* pTable);
+  // Makes host writes visible to the device for non-coherent memory.
+  bool FlushHostMemory(VkDevice device, VkDevDispatchTable* pTable);
+  // Copies the given regions of the host buffer, the copy semaphore is signalled even if
+  // no region has to be copied. CopiesPending has to be false if regions are copied.
+  bool CopyBuffer(VkDevice device, const std::vector<VkBufferCopy>& regions,
+    VkDevDispatchTable* pTable,
     PFN_vkSetDeviceLoaderData setDeviceLoaderDataFuncPtr,
-    VkCommandPool commandPool, VkQueue queue);
+    VkCommandPool commandPool, VkQueue queue, uint32_t queueFamilyIndex);
+  // Destroys the fences, the command buffers are freed with their command pools.
+  void DestroyCopyCommands(VkDevice device, VkDevDispatchTable* pTable);
+
+private:
+  bool RecordCopy(VkDevice device, CopyCommand& copyCommand,
+    const std::vector<VkBufferCopy>& regions, VkDevDispatchTable* pTable);
 };
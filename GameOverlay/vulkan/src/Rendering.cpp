@@ -23,6 +23,7 @@
 #include "Rendering.h"
 #include <algorithm>
 #include <array>
+#include <cstring>
 #include <fstream>
 
 #include "Recording/Capturing.h"
@@ -48,6 +49,8 @@ void Rendering::OnDestroySwapchain(VkDevice device, VkDevDispatchTable* pTable,
 void Rendering::DestroySwapchain(VkDevDispatchTable* pTable, SwapchainMapping* sm)
 {
   for (int i = 0; i < 2; ++i) {
+    sm->overlayImages[i].DestroyCopyCommands(sm->device, pTable);
+
     if (sm->overlayImages[i].bufferView != VK_NULL_HANDLE) {
       pTable->DestroyBufferView(sm->device, sm->overlayImages[i].bufferView, nullptr);
     }
@@ -71,14 +74,6 @@ void Rendering::DestroySwapchain(VkDevDispatchTable* pTable, SwapchainMapping* s
     if (sm->overlayImages[i].overlayCopySemaphore != VK_NULL_HANDLE) {
       pTable->DestroySemaphore(sm->device, sm->overlayImages[i].overlayCopySemaphore, nullptr);
     }
-
-    if (sm->overlayImages[i].commandBufferFence[0] != VK_NULL_HANDLE) {
-      pTable->DestroyFence(sm->device, sm->overlayImages[i].commandBufferFence[0], nullptr);
-    }
-
-    if (sm->overlayImages[i].commandBufferFence[1] != VK_NULL_HANDLE) {
-      pTable->DestroyFence(sm->device, sm->overlayImages[i].commandBufferFence[1], nullptr);
-    }
   }
 
   if (sm->uniformBuffer != VK_NULL_HANDLE) {
@@ -97,6 +92,11 @@ void Rendering::DestroySwapchain(VkDevDispatchTable* pTable, SwapchainMapping* s
     pTable->FreeMemory(sm->device, sm->lagIndicatorUniformMemory, nullptr);
   }
 
+  if (sm->timestampQueryPool != VK_NULL_HANDLE) {
+    pTable->DestroyQueryPool(sm->device, sm->timestampQueryPool, nullptr);
+    sm->timestampQueryPool = VK_NULL_HANDLE;
+  }
+
   if (sm->renderPass != VK_NULL_HANDLE) {
     pTable->DestroyRenderPass(sm->device, sm->renderPass, nullptr);
   }
@@ -126,12 +126,19 @@ void Rendering::DestroySwapchain(VkDevDispatchTable* pTable, SwapchainMapping* s
   }
 
   for (auto& qm : sm->queueMappings) {
-    for (auto& im : qm.second.imageMappings) {
-      pTable->DestroySemaphore(sm->device, im.semaphore, nullptr);
+    if (qm.commandPool == VK_NULL_HANDLE) {
+      continue;
+    }
+
+    for (auto& im : qm.imageMappings) {
+      if (im.semaphore != VK_NULL_HANDLE) {
+        pTable->DestroySemaphore(sm->device, im.semaphore, nullptr);
+      }
     }
 
-    pTable->DestroyCommandPool(sm->device, qm.second.commandPool, nullptr);
+    pTable->DestroyCommandPool(sm->device, qm.commandPool, nullptr);
   }
+  sm->queueMappings.clear();
 
   sm->ClearImageData(pTable);
 }
@@ -164,6 +171,9 @@ VkResult Rendering::CreateOverlayImageBuffer(
   overlayHostBufferInfo.size = sm->overlayRect.extent.width * sm->overlayRect.extent.height * 4;
   overlayHostBufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 
+  overlayImage.valid = false;
+  overlayImage.bitmapDrawCount = 0;
+
   VkResult result = pTable->CreateBuffer(device, &overlayHostBufferInfo, nullptr,
                                          &overlayImage.overlayHostBuffer);
   if (result != VK_SUCCESS) {
@@ -178,6 +188,15 @@ VkResult Rendering::CreateOverlayImageBuffer(
   memoryAllocateInfo.memoryTypeIndex = GetMemoryTypeIndex(
       physicalDeviceMemoryProperties, memoryRequirements.memoryTypeBits,
       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  overlayImage.overlayHostCoherent = true;
+
+  if (memoryAllocateInfo.memoryTypeIndex == UINT32_MAX) {
+    // non-coherent memory is flushed after every update
+    memoryAllocateInfo.memoryTypeIndex =
+        GetMemoryTypeIndex(physicalDeviceMemoryProperties, memoryRequirements.memoryTypeBits,
+                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+    overlayImage.overlayHostCoherent = false;
+  }
 
   if (memoryAllocateInfo.memoryTypeIndex == UINT32_MAX) {
     pTable->DestroyBuffer(device, overlayImage.overlayHostBuffer, nullptr);
@@ -199,6 +218,17 @@ VkResult Rendering::CreateOverlayImageBuffer(
     return result;
   }
 
+  // stays mapped until the memory is freed
+  void* hostData = nullptr;
+  result = pTable->MapMemory(device, overlayImage.overlayHostMemory, 0, VK_WHOLE_SIZE, 0,
+                             &hostData);
+  if (result != VK_SUCCESS) {
+    pTable->FreeMemory(device, overlayImage.overlayHostMemory, nullptr);
+    pTable->DestroyBuffer(device, overlayImage.overlayHostBuffer, nullptr);
+    return result;
+  }
+  overlayImage.overlayHostData = static_cast<unsigned char*>(hostData);
+
   VkBufferCreateInfo overlayBufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
   overlayBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
   overlayBufferInfo.size = sm->overlayRect.extent.width * sm->overlayRect.extent.height * 4;
@@ -268,28 +298,6 @@ VkResult Rendering::CreateOverlayImageBuffer(
     pTable->DestroyBufferView(device, overlayImage.bufferView, nullptr);
     return result;
   }
-#if _DEBUG
-  VkFenceCreateInfo createInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr, 0};
-  result = pTable->CreateFence(device, &createInfo, nullptr, &overlayImage.commandBufferFence[0]);
-  if (result != VK_SUCCESS) {
-    pTable->FreeMemory(device, overlayImage.overlayMemory, nullptr);
-    pTable->DestroyBuffer(device, overlayImage.overlayBuffer, nullptr);
-    pTable->FreeMemory(device, overlayImage.overlayHostMemory, nullptr);
-    pTable->DestroyBuffer(device, overlayImage.overlayHostBuffer, nullptr);
-    pTable->DestroyBufferView(device, overlayImage.bufferView, nullptr);
-    return result;
-  }
-
-  result = pTable->CreateFence(device, &createInfo, nullptr, &overlayImage.commandBufferFence[1]);
-  if (result != VK_SUCCESS) {
-    pTable->FreeMemory(device, overlayImage.overlayMemory, nullptr);
-    pTable->DestroyBuffer(device, overlayImage.overlayBuffer, nullptr);
-    pTable->FreeMemory(device, overlayImage.overlayHostMemory, nullptr);
-    pTable->DestroyBuffer(device, overlayImage.overlayHostBuffer, nullptr);
-    pTable->DestroyBufferView(device, overlayImage.bufferView, nullptr);
-    return result;
-  }
-#endif
 
   return VK_SUCCESS;
 }
@@ -459,10 +467,11 @@ void Rendering::OnCreateSwapchain(
     VkDevice device, VkDevDispatchTable* pTable,
     const VkPhysicalDeviceMemoryProperties& physicalDeviceMemoryProperties,
     VkSwapchainKHR swapchain, VkFormat format, const VkExtent2D& extent,
-    const VkImageUsageFlags usage)
+    const VkImageUsageFlags usage, float timestampPeriod)
 {
   SwapchainMapping* sm =
       new SwapchainMapping{device, format, VK_FORMAT_B8G8R8A8_UNORM, extent, usage};
+  sm->timestampPeriod = timestampPeriod;
   swapchainMappings_.Add(swapchain, sm);
 
   InitRenderPass(pTable, physicalDeviceMemoryProperties, sm);
@@ -1196,154 +1205,224 @@ VkSemaphore Rendering::Present(VkDevDispatchTable* pTable,
                                PFN_vkSetDeviceLoaderData setDeviceLoaderDataFuncPtr,
                                VkQueue queue,
                                uint32_t queueFamilyIndex, VkQueueFlags queueFlags,
-                               uint32_t imageIndex, uint32_t waitSemaphoreCount,
-                               const VkSemaphore* pWaitSemaphores,
-                               SwapchainMapping* swapchainMapping, bool lagIndicatorState)
+                               uint32_t swapchainCount, SwapchainMapping* const* swapchainMappings,
+                               const uint32_t* imageIndices, uint32_t waitSemaphoreCount,
+                               const VkSemaphore* pWaitSemaphores, uint32_t timestampValidBits,
+                               bool lagIndicatorState)
 {
   if ((queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) == 0) {
     return VK_NULL_HANDLE;
   }
 
-  int32_t graphicsQueue = queueFlags & VK_QUEUE_GRAPHICS_BIT;
+  const bool graphicsQueue = (queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
 
-  if (graphicsQueue == 0) {
-    // compute queue -> check if storage bit is set, otherwise return
-    if (!(swapchainMapping->usage & VK_IMAGE_USAGE_STORAGE_BIT)) {
-      return VK_NULL_HANDLE;
-    }
+  // check if default overlay or lag indicator should be displayed
+  lagIndicatorVisibility_ = overlayBitmap_->GetLagIndicatorVisibility();
+
+  // the overlay is drawn once per present call, every swapchain of the batch copies the
+  // regions it has not seen yet
+  if (!lagIndicatorVisibility_) {
+    overlayBitmap_->DrawOverlay();
   }
 
-  VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
-  SwapchainImageMapping* imageMapping = nullptr;
-  SwapchainQueueMapping* queueMapping = nullptr;
+  const VkPipelineStageFlags pipelineStageFlags =
+      graphicsQueue ? VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+                    : VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+  presentCommandBuffers_.clear();
+  presentWaitSemaphores_.assign(pWaitSemaphores, pWaitSemaphores + waitSemaphoreCount);
+  VkSemaphore signalSemaphore = VK_NULL_HANDLE;
 
-  for (auto& qm : swapchainMapping->queueMappings) {
-    if (qm.second.queue == queue) {
-      queueMapping = &qm.second;
-      for (auto& im : qm.second.imageMappings) {
-        if (im.imageIndex == imageIndex) {
-          imageMapping = &im;
-          break;
-        }
-      }
-      break;
+  for (uint32_t i = 0; i < swapchainCount; ++i) {
+    SwapchainImageMapping* imageMapping =
+        PrepareSwapchain(pTable, setDeviceLoaderDataFuncPtr, queue, queueFamilyIndex,
+                         graphicsQueue, timestampValidBits, imageIndices[i],
+                         swapchainMappings[i], lagIndicatorState);
+    if (imageMapping == nullptr) {
+      continue;
+    }
+
+    presentCommandBuffers_.push_back(
+        imageMapping->commandBuffer[swapchainMappings[i]->nextOverlayImage]);
+
+    // we only need to wait for the signal of overlayCopySemaphore if we copied the default
+    // overlay, no need in case of lag Indicator
+    if (!lagIndicatorVisibility_) {
+      presentWaitSemaphores_.push_back(
+          swapchainMappings[i]->overlayImages[swapchainMappings[i]->nextOverlayImage]
+              .overlayCopySemaphore);
+    }
+
+    // one semaphore signals the whole batch, the one of the first swapchain is reused as it is
+    // only signaled again after that image was acquired and presented again
+    if (signalSemaphore == VK_NULL_HANDLE) {
+      signalSemaphore = imageMapping->semaphore;
     }
   }
 
-  // check if default overlay or lag indicator should be displayed
-  if (lagIndicatorVisibility_ != overlayBitmap_->GetLagIndicatorVisibility())
-  {
-    remainingRecordRenderPassUpdates_ = static_cast<int>(swapchainMapping->imageData.size());
-    lagIndicatorVisibility_ = overlayBitmap_->GetLagIndicatorVisibility();
+  if (presentCommandBuffers_.empty()) {
+    return VK_NULL_HANDLE;
   }
 
-  if (cmdBuffer == VK_NULL_HANDLE) {
-    if (queueMapping == nullptr) {
-      VkCommandPoolCreateInfo cmdPoolCreateInfo = {
-          VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO, nullptr,
-          VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, queueFamilyIndex};
-      VkCommandPool cmdPool;
-      VkResult result = pTable->CreateCommandPool(swapchainMapping->device, &cmdPoolCreateInfo,
-                                                  nullptr, &cmdPool);
-      g_messageLog.LogInfo("VulkanOverlay", "Create command pool");
-      if (result != VK_SUCCESS) {
-        return VK_NULL_HANDLE;
-      }
+  presentWaitStages_.assign(presentWaitSemaphores_.size(), pipelineStageFlags);
 
-      swapchainMapping->queueMappings.insert(
-          std::make_pair(queueFamilyIndex, SwapchainQueueMapping{queue, graphicsQueue, cmdPool}));
-      queueMapping = &swapchainMapping->queueMappings.at(queueFamilyIndex);
-    }
+  VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                             nullptr,
+                             static_cast<uint32_t>(presentWaitSemaphores_.size()),
+                             presentWaitSemaphores_.data(),
+                             presentWaitStages_.data(),
+                             static_cast<uint32_t>(presentCommandBuffers_.size()),
+                             presentCommandBuffers_.data(),
+                             1,
+                             &signalSemaphore};
 
-    if (imageMapping == nullptr) {
-      SwapchainImageMapping im = {};
-      im.imageIndex = imageIndex;
-      CreateImageMapping(pTable, 
-          setDeviceLoaderDataFuncPtr, 
-          swapchainMapping, queueMapping,
-                         queueFamilyIndex, &im);
-      if (im.commandBuffer == VK_NULL_HANDLE) {
-        return VK_NULL_HANDLE;
-      }
+  VkResult result = pTable->QueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+  if (result != VK_SUCCESS) {
+    return VK_NULL_HANDLE;
+  }
+  return signalSemaphore;
+}
 
-      queueMapping->imageMappings.push_back(im);
-      imageMapping = &queueMapping->imageMappings.back();
+SwapchainImageMapping* Rendering::PrepareSwapchain(
+    VkDevDispatchTable* pTable, PFN_vkSetDeviceLoaderData setDeviceLoaderDataFuncPtr,
+    VkQueue queue, uint32_t queueFamilyIndex, bool graphicsQueue, uint32_t timestampValidBits,
+    uint32_t imageIndex, SwapchainMapping* swapchainMapping, bool lagIndicatorState)
+{
+  if (!graphicsQueue) {
+    // compute queue -> check if storage bit is set, otherwise return
+    if (!(swapchainMapping->usage & VK_IMAGE_USAGE_STORAGE_BIT)) {
+      return nullptr;
     }
+  }
 
-    VkResult result = UpdateUniformBuffer(pTable, swapchainMapping);
+  // switching between the overlay and the lag indicator changes what every image records
+  if (swapchainMapping->lagIndicatorVisibility != lagIndicatorVisibility_) {
+    swapchainMapping->lagIndicatorVisibility = lagIndicatorVisibility_;
+    ++swapchainMapping->recordGeneration;
+  }
+
+  SwapchainQueueMapping* queueMapping =
+      &GetQueueMapping(swapchainMapping->queueMappings, queueFamilyIndex);
+  if (queueMapping->commandPool == VK_NULL_HANDLE) {
+    VkCommandPoolCreateInfo cmdPoolCreateInfo = {
+        VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO, nullptr,
+        VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, queueFamilyIndex};
+    VkCommandPool cmdPool;
+    VkResult result = pTable->CreateCommandPool(swapchainMapping->device, &cmdPoolCreateInfo,
+                                                nullptr, &cmdPool);
+    g_messageLog.LogInfo("VulkanOverlay", "Create command pool");
     if (result != VK_SUCCESS) {
-      g_messageLog.LogError("OnPresent", "Failed to update uniform buffer.");
-      return VK_NULL_HANDLE;
+      return nullptr;
+    }
+
+    queueMapping->isGraphicsQueue = static_cast<int32_t>(graphicsQueue);
+    queueMapping->commandPool = cmdPool;
+    queueMapping->imageMappings.resize(swapchainMapping->imageData.size());
+
+    if (timestampValidBits != 0 && CreateTimestampQueryPool(pTable, swapchainMapping)) {
+      queueMapping->timestampValidBits = timestampValidBits;
+    }
+  }
+
+  SwapchainImageMapping* imageMapping = &queueMapping->GetImageMapping(imageIndex);
+  if (imageMapping->commandBuffer[0] == VK_NULL_HANDLE) {
+    imageMapping->imageIndex = imageIndex;
+    CreateImageMapping(pTable, 
+        setDeviceLoaderDataFuncPtr, 
+        swapchainMapping, queueMapping,
+                       queueFamilyIndex, imageMapping);
+    if (imageMapping->commandBuffer[0] == VK_NULL_HANDLE) {
+      return nullptr;
     }
   }
 
+  VkResult result = UpdateUniformBuffer(pTable, swapchainMapping);
+  if (result != VK_SUCCESS) {
+    g_messageLog.LogError("OnPresent", "Failed to update uniform buffer.");
+    return nullptr;
+  }
+
   auto& overlayImageIdx = swapchainMapping->overlayImages[swapchainMapping->nextOverlayImage];
-  uint32_t bufferSize = 0;
 
-  // if default overlay should be displayed: Update overlay bitmap and copy to texture
+  // if default overlay should be displayed: copy the overlay bitmap to the texture
   if (!lagIndicatorVisibility_)
   {
-    overlayBitmap_->DrawOverlay();
+    // only the regions which changed since the overlay image was last updated are copied
+    const bool partialCopy = overlayImageIdx.valid;
+    overlayBitmap_->GetDirtyRects(partialCopy ? overlayImageIdx.bitmapDrawCount : 0,
+                                  overlayCopyRects_);
+    overlayCopyRegions_.clear();
 
     auto textureData = overlayBitmap_->GetBitmapDataRead();
 
-    if (textureData.dataPtr && textureData.size) {
-      bufferSize = max(textureData.size, swapchainMapping->lastOverlayBufferSize);
-      void* data;
-      VkResult result = pTable->MapMemory(swapchainMapping->device, overlayImageIdx.overlayHostMemory,
-                                          0, bufferSize, 0, &data);
-      if (result != VK_SUCCESS) {
-        return VK_NULL_HANDLE;
+    // The copy submitted two presents ago may still read from the host buffer. Instead of
+    // waiting for it the update is deferred, the draw count of the image is kept so its dirty
+    // regions are copied with the next update.
+    if (textureData.dataPtr && textureData.size && !overlayCopyRects_.empty() &&
+        !overlayImageIdx.CopiesPending(swapchainMapping->device, pTable)) {
+      const uint32_t bufferSize = partialCopy
+          ? textureData.size
+          : (std::max)(textureData.size, swapchainMapping->lastOverlayBufferSize);
+
+      auto dest = overlayImageIdx.overlayHostData;
+      if (partialCopy) {
+        for (const auto& rect : overlayCopyRects_) {
+          const VkDeviceSize rowSize = rect.Width * 4;
+          for (int y = rect.Y; y < rect.Y + rect.Height; ++y) {
+            const VkDeviceSize offset = y * textureData.stride + rect.X * 4;
+            memcpy(dest + offset, textureData.dataPtr + offset, rowSize);
+            overlayCopyRegions_.push_back({offset, offset, rowSize});
+          }
+        }
+      }
+      else {
+        memcpy(dest, textureData.dataPtr, bufferSize);
+        overlayCopyRegions_.push_back({0, 0, bufferSize});
+      }
+      if (!overlayImageIdx.FlushHostMemory(swapchainMapping->device, pTable)) {
+        overlayBitmap_->UnlockBitmapData();
+        return nullptr;
       }
-      memcpy(data, textureData.dataPtr, bufferSize);
-      pTable->UnmapMemory(swapchainMapping->device, overlayImageIdx.overlayHostMemory);
       swapchainMapping->lastOverlayBufferSize = textureData.size;
+      overlayImageIdx.bitmapDrawCount = overlayBitmap_->GetDrawCount();
     }
 
     overlayBitmap_->UnlockBitmapData();
 
     if (!overlayImageIdx.CopyBuffer(
-                  swapchainMapping->device, bufferSize, pTable, setDeviceLoaderDataFuncPtr,
-                  swapchainMapping->queueMappings[queueFamilyIndex].commandPool, queue)) {
-      return VK_NULL_HANDLE;
+                  swapchainMapping->device, overlayCopyRegions_, pTable, setDeviceLoaderDataFuncPtr,
+                  queueMapping->commandPool, queue, queueFamilyIndex)) {
+      return nullptr;
     }
 
     overlayImageIdx.valid = true;
 
     swapchainMapping->nextOverlayImage = 1 - swapchainMapping->nextOverlayImage;
     if (!swapchainMapping->overlayImages[swapchainMapping->nextOverlayImage].valid) {
-      return VK_NULL_HANDLE;
+      return nullptr;
     }
-  }
 
-  cmdBuffer = imageMapping->commandBuffer[swapchainMapping->nextOverlayImage];
-
-  if (!lagIndicatorVisibility_)
-  {
     auto position = overlayBitmap_->GetScreenPos();
     if (swapchainMapping->overlayRect.offset.x != position.x ||
         swapchainMapping->overlayRect.offset.y != position.y) {
       // Position changed.
-      VkResult result =
-          UpdateOverlayPosition(pTable, swapchainMapping, overlayBitmap_->GetScreenPos());
+      result = UpdateOverlayPosition(pTable, swapchainMapping, overlayBitmap_->GetScreenPos());
       if (result != VK_SUCCESS) {
         g_messageLog.LogError("OnPresent", "Failed to update overlay position.");
-        return VK_NULL_HANDLE;
+        return nullptr;
       }
 
-      remainingRecordRenderPassUpdates_ = static_cast<int>(swapchainMapping->imageData.size());
+      ++swapchainMapping->recordGeneration;
     }
   }
-  
-  if (lagIndicatorVisibility_)
+  else
   {
     void* data;
-    VkResult result =
-        pTable->MapMemory(swapchainMapping->device, swapchainMapping->lagIndicatorUniformMemory, 0,
-                          4 * sizeof(int), 0, &data);
+    result = pTable->MapMemory(swapchainMapping->device,
+                               swapchainMapping->lagIndicatorUniformMemory, 0, 4 * sizeof(int),
+                               0, &data);
     if (result != VK_SUCCESS) {
       g_messageLog.LogError("UpdateOverlayPosition", "Failed to map memory for lag meter.");
-      return VK_NULL_HANDLE;
+      return nullptr;
     }
 
     int* constants = static_cast<int*>(data);
@@ -1354,67 +1433,115 @@ VkSemaphore Rendering::Present(VkDevDispatchTable* pTable,
     pTable->UnmapMemory(swapchainMapping->device, swapchainMapping->lagIndicatorUniformMemory);
   }
 
-  // Make sure that the render pass of every image in the image mapping gets updated.
-  if (remainingRecordRenderPassUpdates_ > 0) {
-    // Record render pass to update the viewport changes.
-    VkResult result = RecordRenderPass(pTable, 
+  // Re-record the render pass of every image once after a viewport or overlay change.
+  if (imageMapping->recordedGeneration != swapchainMapping->recordGeneration) {
+    result = RecordRenderPass(pTable, 
         setDeviceLoaderDataFuncPtr,
         swapchainMapping,
         queueMapping, queueFamilyIndex, imageMapping);
     if (result != VK_SUCCESS) {
       g_messageLog.LogError("OnPresent", "Failed to record render pass.");
-      return VK_NULL_HANDLE;
+      return nullptr;
     }
-    remainingRecordRenderPassUpdates_--;
   }
 
-  std::vector<VkPipelineStageFlags> pPipelineStageFlags(waitSemaphoreCount + 1);
-  std::vector<VkSemaphore> waitSemaphores(waitSemaphoreCount + 1);
-  VkPipelineStageFlagBits pipelineStageFlagBit = graphicsQueue
-                                                     ? VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
-                                                     : VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-  for (uint32_t i = 0; i < waitSemaphoreCount; ++i) {
-    pPipelineStageFlags[i] = pipelineStageFlagBit;
-    waitSemaphores[i] = pWaitSemaphores[i];
+  if (queueMapping->timestampValidBits != 0) {
+    ReadOverlayTimestamps(pTable, swapchainMapping, queueMapping, imageMapping,
+                          swapchainMapping->nextOverlayImage);
   }
 
-  // we only need to wait for the signal of overlayCopySemaphore if we copied the default overlay
-  // no need in case of lag Indicator
-  if (!lagIndicatorVisibility_) {
-    pPipelineStageFlags[waitSemaphoreCount] = pipelineStageFlagBit;
-    waitSemaphores[waitSemaphoreCount] =
-     swapchainMapping->overlayImages[swapchainMapping->nextOverlayImage].overlayCopySemaphore;
-    ++waitSemaphoreCount;
-  }
+  return imageMapping;
+}
 
-  VkSubmitInfo submitInfo = {
-      VK_STRUCTURE_TYPE_SUBMIT_INFO, nullptr, waitSemaphoreCount, waitSemaphores.data(),
-      pPipelineStageFlags.data(),    1,       &cmdBuffer,         1,
-      &imageMapping->semaphore};
+bool Rendering::CreateTimestampQueryPool(VkDevDispatchTable* pTable, SwapchainMapping* sm)
+{
+  if (sm->timestampQueryPool != VK_NULL_HANDLE) {
+    return true;
+  }
+  if (!RecordingState::GetInstance().IsOverlayGpuTimestampsEnabled() ||
+      sm->timestampPeriod <= 0.0f || sm->imageData.empty()) {
+    return false;
+  }
 
-  VkResult result = pTable->QueueSubmit(queueMapping->queue, 1, &submitInfo, VK_NULL_HANDLE);
+  VkQueryPoolCreateInfo queryPoolCreateInfo = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+  queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  queryPoolCreateInfo.queryCount = static_cast<uint32_t>(sm->imageData.size()) * 4;
+  VkResult result =
+      pTable->CreateQueryPool(sm->device, &queryPoolCreateInfo, nullptr, &sm->timestampQueryPool);
   if (result != VK_SUCCESS) {
-    return VK_NULL_HANDLE;
+    g_messageLog.LogWarning("VulkanOverlay", "Failed to create timestamp query pool.");
+    sm->timestampQueryPool = VK_NULL_HANDLE;
+    return false;
   }
-  return imageMapping->semaphore;
+  sm->timestampQueryCount = queryPoolCreateInfo.queryCount;
+  return true;
+}
+
+void Rendering::ReadOverlayTimestamps(VkDevDispatchTable* pTable, SwapchainMapping* sm,
+                                      SwapchainQueueMapping* qm, SwapchainImageMapping* im,
+                                      uint32_t commandBufferIndex)
+{
+  const uint32_t query = GetTimestampQuery(im->imageIndex, commandBufferIndex);
+  if (query + 2 > sm->timestampQueryCount) {
+    return;
+  }
+
+  // The command buffer is submitted again at most once per acquire of the image, so the
+  // timestamps of its previous submission are usually available and reading never waits.
+  if (im->timestampsPending[commandBufferIndex]) {
+    // timestamp and availability of both queries
+    uint64_t results[4] = {};
+    VkResult result = pTable->GetQueryPoolResults(
+        sm->device, sm->timestampQueryPool, query, 2, sizeof(results), results,
+        2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if ((result == VK_SUCCESS || result == VK_NOT_READY) && results[1] && results[3]) {
+      const uint64_t mask =
+          qm->timestampValidBits >= 64 ? ~0ull : (1ull << qm->timestampValidBits) - 1;
+      const uint64_t ticks = (results[2] - results[0]) & mask;
+      overlayBitmap_->GetCostBudget().AddGpuCost(
+          static_cast<float>(static_cast<double>(ticks) * sm->timestampPeriod / 1000.0));
+    }
+  }
+  im->timestampsPending[commandBufferIndex] = true;
+}
+
+uint32_t Rendering::GetTimestampQuery(uint32_t imageIndex, uint32_t commandBufferIndex)
+{
+  return (imageIndex * 2 + commandBufferIndex) * 2;
 }
 
 VkSemaphore Rendering::OnPresent(VkDevDispatchTable* pTable,
                                  PFN_vkSetDeviceLoaderData setDeviceLoaderDataFuncPtr,
                                  VkQueue queue, uint32_t queueFamilyIndex, VkQueueFlags queueFlags,
-                                 VkSwapchainKHR swapchain, uint32_t imageIndex,
-                                 uint32_t waitSemaphoreCount, const VkSemaphore* pWaitSemaphores,
+                                 uint32_t swapchainCount, const VkSwapchainKHR* pSwapchains,
+                                 const uint32_t* pImageIndices, uint32_t waitSemaphoreCount,
+                                 const VkSemaphore* pWaitSemaphores, uint32_t timestampValidBits,
                                  bool lagIndicatorState)
 {
   if (!pipelineInitialized_) return VK_NULL_HANDLE;
 
-  const auto swapchainMapping = swapchainMappings_.Get(swapchain);
+  std::lock_guard<std::mutex> lock(presentMutex_);
+  OverlayCostScope costScope(overlayBitmap_->GetCostBudget());
+
+  // swapchains the layer has not seen are presented without overlay
+  presentSwapchains_.clear();
+  presentImageIndices_.clear();
+  for (uint32_t i = 0; i < swapchainCount; ++i) {
+    if (SwapchainMapping* swapchainMapping = swapchainMappings_.Get(pSwapchains[i])) {
+      presentSwapchains_.push_back(swapchainMapping);
+      presentImageIndices_.push_back(pImageIndices[i]);
+    }
+  }
+  if (presentSwapchains_.empty()) {
+    return VK_NULL_HANDLE;
+  }
 
   return Present(pTable,
                  setDeviceLoaderDataFuncPtr,
                  queue, queueFamilyIndex, queueFlags,
-                 imageIndex, waitSemaphoreCount, pWaitSemaphores, swapchainMapping,
-                 lagIndicatorState);
+                 static_cast<uint32_t>(presentSwapchains_.size()), presentSwapchains_.data(),
+                 presentImageIndices_.data(), waitSemaphoreCount, pWaitSemaphores,
+                 timestampValidBits, lagIndicatorState);
 }
 
 VkSemaphore Rendering::OnSubmitFrameCompositor(VkDevDispatchTable* pTable,
@@ -1424,11 +1551,14 @@ VkSemaphore Rendering::OnSubmitFrameCompositor(VkDevDispatchTable* pTable,
 {
   if (!pipelineInitialized_) return VK_NULL_HANDLE;
 
+  std::lock_guard<std::mutex> lock(presentMutex_);
+
   // synchronizing should be done via the compositor
+  SwapchainMapping* swapchainMapping = &compositorSwapchainMapping_;
   return Present(pTable,
                  setDeviceLoaderDataFuncPtr,
                  queue, queueFamilyIndex, queueFlags,
-                 imageIndex, 0, nullptr, &compositorSwapchainMapping_);
+                 1, &swapchainMapping, &imageIndex, 0, nullptr, 0);
 }
 
 VkResult Rendering::RecordRenderPass(VkDevDispatchTable* pTable,
@@ -1454,6 +1584,15 @@ VkResult Rendering::RecordRenderPass(VkDevDispatchTable* pTable,
       return result;
     }
 
+    const uint32_t timestampQuery = GetTimestampQuery(im->imageIndex, i);
+    const bool timestamps = qm->timestampValidBits != 0 &&
+                            timestampQuery + 2 <= sm->timestampQueryCount;
+    if (timestamps) {
+      pTable->CmdResetQueryPool(im->commandBuffer[i], sm->timestampQueryPool, timestampQuery, 2);
+      pTable->CmdWriteTimestamp(im->commandBuffer[i], VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                sm->timestampQueryPool, timestampQuery);
+    }
+
     if (qm->isGraphicsQueue) {
       VkRenderPassBeginInfo rpBeginInfo = {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
                                            nullptr,
@@ -1557,6 +1696,11 @@ VkResult Rendering::RecordRenderPass(VkDevDispatchTable* pTable,
                                      nullptr, 1, &computeToPresentBarrier);
     }
 
+    if (timestamps) {
+      pTable->CmdWriteTimestamp(im->commandBuffer[i], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                sm->timestampQueryPool, timestampQuery + 1);
+    }
+
     result = pTable->EndCommandBuffer(im->commandBuffer[i]);
     if (result != VK_SUCCESS) {
       pTable->FreeCommandBuffers(sm->device, qm->commandPool, 1, &im->commandBuffer[i]);
@@ -1564,6 +1708,7 @@ VkResult Rendering::RecordRenderPass(VkDevDispatchTable* pTable,
     }
   }
 
+  im->recordedGeneration = sm->recordGeneration;
   return VK_SUCCESS;
 }
 
@@ -1599,7 +1744,13 @@ void Rendering::CreateImageMapping(VkDevDispatchTable* pTable,
 VkShaderModule Rendering::CreateShaderModuleFromFile(VkDevice device, VkDevDispatchTable* pTable,
                                                      const std::wstring& fileName) const
 {
+#ifdef _WIN32
   std::ifstream shaderFile(fileName, std::ios::ate | std::ios::binary);
+#else
+  // the shader directory of the benchmarks is an ASCII build path
+  std::ifstream shaderFile(std::string(fileName.begin(), fileName.end()),
+                           std::ios::ate | std::ios::binary);
+#endif
   if (!shaderFile.is_open()) {
     return VK_NULL_HANDLE;
   }
@@ -22,9 +22,12 @@
 
 #pragma once
 
+#include <mutex>
 #include <vector>
 
+#ifdef _WIN32
 #define VK_USE_PLATFORM_WIN32_KHR
+#endif
 #include <vulkan/vk_layer.h>
 #include <vulkan/vulkan.h>
 
@@ -47,7 +50,7 @@ public:
   void OnCreateSwapchain(VkDevice device, VkDevDispatchTable* pTable,
     const VkPhysicalDeviceMemoryProperties& physicalDeviceMemoryProperties,
     VkSwapchainKHR swapchain, VkFormat format, const VkExtent2D& extent,
-    const VkImageUsageFlags usage);
+    const VkImageUsageFlags usage, float timestampPeriod);
   void OnGetSwapchainImages(VkDevDispatchTable* pTable, VkSwapchainKHR swapchain,
     uint32_t imageCount, VkImage* images);
 
@@ -57,12 +60,16 @@ public:
     VkFormat format, const VkExtent2D& extent, VkImageUsageFlags usage,
     uint32_t imageCount, VkImage* images);
 
+  // Renders the overlay into every swapchain image of the present call with one submission,
+  // returns the semaphore the present has to wait for instead of pWaitSemaphores.
+  // timestampValidBits of the queue family enables the GPU time measurement of the overlay.
   VkSemaphore OnPresent(VkDevDispatchTable* pTable,
     PFN_vkSetDeviceLoaderData setDeviceLoaderDataFuncPtr,
     VkQueue queue,
     uint32_t queueFamilyIndex, VkQueueFlags queueFlags,
-    VkSwapchainKHR swapchain, uint32_t imageIndex, uint32_t waitSemaphoreCount,
-    const VkSemaphore* pWaitSemaphores, bool lagIndicatorState = false);
+    uint32_t swapchainCount, const VkSwapchainKHR* pSwapchains, const uint32_t* pImageIndices,
+    uint32_t waitSemaphoreCount, const VkSemaphore* pWaitSemaphores,
+    uint32_t timestampValidBits, bool lagIndicatorState = false);
 
   VkSemaphore OnSubmitFrameCompositor(VkDevDispatchTable* pTable,
     PFN_vkSetDeviceLoaderData setDeviceLoaderDataFuncPtr,
@@ -73,7 +80,6 @@ public:
   VkRect2D GetViewportCompositor() { return compositorSwapchainMapping_.overlayRect; }
   bool Initialized() { return pipelineInitialized_; }
 
-  int GetLagIndicatorHotkey() { return overlayBitmap_->GetLagIndicatorHotkey(); }
   bool HideOverlay() { return overlayBitmap_->HideOverlay(); }
 
 protected:
@@ -90,9 +96,23 @@ protected:
     PFN_vkSetDeviceLoaderData setDeviceLoaderDataFuncPtr,
     VkQueue queue,
     uint32_t queueFamilyIndex, VkQueueFlags queueFlags,
-    uint32_t imageIndex, uint32_t waitSemaphoreCount,
-    const VkSemaphore* pWaitSemaphores, SwapchainMapping* swapchainMapping,
+    uint32_t swapchainCount, SwapchainMapping* const* swapchainMappings,
+    const uint32_t* imageIndices, uint32_t waitSemaphoreCount,
+    const VkSemaphore* pWaitSemaphores, uint32_t timestampValidBits,
     bool lagIndicatorState = false);
+  // Updates the overlay image of one swapchain of the batch and returns the mapping of the image
+  // whose command buffer has to be submitted, nullptr if the overlay is skipped for it.
+  SwapchainImageMapping* PrepareSwapchain(VkDevDispatchTable* pTable,
+    PFN_vkSetDeviceLoaderData setDeviceLoaderDataFuncPtr,
+    VkQueue queue, uint32_t queueFamilyIndex, bool graphicsQueue, uint32_t timestampValidBits,
+    uint32_t imageIndex, SwapchainMapping* swapchainMapping, bool lagIndicatorState);
+  // Only created if overlayGpuTimestamps is enabled.
+  bool CreateTimestampQueryPool(VkDevDispatchTable* pTable, SwapchainMapping* sm);
+  // Reports the GPU time of the previous submission of the command buffer to the cost budget
+  // if its timestamps are available, the command buffer is about to be submitted again.
+  void ReadOverlayTimestamps(VkDevDispatchTable* pTable, SwapchainMapping* sm,
+    SwapchainQueueMapping* qm, SwapchainImageMapping* im, uint32_t commandBufferIndex);
+  static uint32_t GetTimestampQuery(uint32_t imageIndex, uint32_t commandBufferIndex);
 
   VkResult RecordRenderPass(VkDevDispatchTable* pTable,
     PFN_vkSetDeviceLoaderData setDeviceLoaderDataFuncPtr,
@@ -121,7 +141,17 @@ protected:
   SwapchainMapping compositorSwapchainMapping_;
   std::wstring shaderDirectory_;
   std::unique_ptr<OverlayBitmap> overlayBitmap_;
-  int remainingRecordRenderPassUpdates_ = 0;
+  std::vector<WICRect> overlayCopyRects_;
+  std::vector<VkBufferCopy> overlayCopyRegions_;
+  // reused by every present to collect the batch without allocating
+  std::vector<SwapchainMapping*> presentSwapchains_;
+  std::vector<uint32_t> presentImageIndices_;
+  std::vector<VkCommandBuffer> presentCommandBuffers_;
+  std::vector<VkSemaphore> presentWaitSemaphores_;
+  std::vector<VkPipelineStageFlags> presentWaitStages_;
+  // Held by every present. Queues of one family share the command pools, and presents from
+  // different queues may come from different threads.
+  std::mutex presentMutex_;
   bool overlayBitmapInitialized_ = false;
   bool pipelineInitialized_ = false;
 
@@ -22,7 +22,9 @@
 
 #pragma once
 
+#ifdef _WIN32
 #define VK_USE_PLATFORM_WIN32_KHR
+#endif
 #include <vulkan/vk_layer.h>
 #include <vulkan/vulkan.h>
 
@@ -22,12 +22,18 @@
 
 #pragma once
 
+#ifdef _WIN32
 #define VK_USE_PLATFORM_WIN32_KHR
+#endif
 #include <vulkan/vk_layer.h>
 #include <vulkan/vulkan.h>
 
 struct SwapchainImageMapping {
-  uint32_t imageIndex;
-  VkCommandBuffer commandBuffer[2];
-  VkSemaphore semaphore;
+  uint32_t imageIndex = 0;
+  VkCommandBuffer commandBuffer[2] = {};
+  VkSemaphore semaphore = VK_NULL_HANDLE;
+  // the command buffer was submitted with timestamps that have not been read back yet
+  bool timestampsPending[2] = {};
+  // SwapchainMapping::recordGeneration the command buffers were recorded for
+  uint32_t recordedGeneration = 0;
 };
@@ -22,12 +22,13 @@
 
 #pragma once
 
+#ifdef _WIN32
 #define VK_USE_PLATFORM_WIN32_KHR
+#endif
 #include <vulkan/vk_layer.h>
 #include <vulkan/vulkan.h>
 
 #include <vector>
-#include <unordered_map>
 
 #include "OverlayImageData.h"
 #include "SwapchainImageData.h"
@@ -58,7 +59,15 @@ struct SwapchainMapping {
   VkBuffer lagIndicatorUniformBuffer;
   VkDeviceMemory lagIndicatorUniformMemory;
   std::vector<SwapchainImageData> imageData;
-  std::unordered_map<uint32_t, SwapchainQueueMapping> queueMappings;
+  // indexed by queue family, families the swapchain was not presented from have no command pool
+  std::vector<SwapchainQueueMapping> queueMappings;
+  // GPU time of the overlay pass, two timestamps per command buffer of every image
+  float timestampPeriod;
+  VkQueryPool timestampQueryPool;
+  uint32_t timestampQueryCount;
+  // bumped whenever the recorded command buffers of every image are out of date
+  uint32_t recordGeneration;
+  bool lagIndicatorVisibility;
 
   void ClearImageData(VkDevDispatchTable* pTable);
 };
@@ -22,7 +22,9 @@
 
 #pragma once
 
+#ifdef _WIN32
 #define VK_USE_PLATFORM_WIN32_KHR
+#endif
 #include <vulkan/vk_layer.h>
 #include <vulkan/vulkan.h>
 
@@ -30,9 +32,32 @@
 
 #include "SwapchainImageMapping.h"
 
+// Command state of a swapchain for one queue family. Every queue of the family presents with the
+// same command pool and command buffers, Rendering serializes presents with its present mutex.
 struct SwapchainQueueMapping {
-  VkQueue queue;
-  int32_t isGraphicsQueue;
-  VkCommandPool commandPool;
+  int32_t isGraphicsQueue = 0;
+  VkCommandPool commandPool = VK_NULL_HANDLE;
+  // 0 if the queue family does not support timestamps
+  uint32_t timestampValidBits = 0;
+  // indexed by swapchain image, created on the first present of the image
   std::vector<SwapchainImageMapping> imageMappings;
+
+  // Adds an empty mapping on the first present of the image.
+  SwapchainImageMapping& GetImageMapping(uint32_t imageIndex)
+  {
+    if (imageIndex >= imageMappings.size()) {
+      imageMappings.resize(imageIndex + 1);
+    }
+    return imageMappings[imageIndex];
+  }
 };
+
+// Adds an empty mapping without command pool on the first present from the queue family.
+inline SwapchainQueueMapping& GetQueueMapping(std::vector<SwapchainQueueMapping>& queueMappings,
+                                              uint32_t queueFamilyIndex)
+{
+  if (queueFamilyIndex >= queueMappings.size()) {
+    queueMappings.resize(queueFamilyIndex + 1);
+  }
+  return queueMappings[queueFamilyIndex];
+}
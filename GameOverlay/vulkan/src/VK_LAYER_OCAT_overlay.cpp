@@ -27,17 +27,17 @@
 
 #include "AppResMapping.h"
 #include "Recording/Capturing.h"
+#include "Recording/InputSampler.h"
 #include "Utility/FileDirectory.h"
 #include "HashMap.h"
 #include "Rendering.h"
 #include "Utility/ProcessHelper.h"
 #include "hook_manager.hpp"
+#include "vk_layer_hooks.h"
 #include "Compositor/vk_oculus.h"
 #include "Compositor/vk_steamvr.h"
 #include "d3d/steamvr.h"
 
-#include <mutex>
-
 // This was part of vulkan/vk_layer.h previously, but has been removed in later SDK versions
 #ifndef VK_LAYER_EXPORT
 #define VK_LAYER_EXPORT
@@ -48,35 +48,6 @@ static const VkLayerProperties global_layer = {
 
 AppResMapping g_AppResources;
 std::unique_ptr<Rendering> g_Rendering;
-std::mutex g_mutex;
-bool g_LagIndicatorState;
-
-struct VulkanFunction {
-  const char* name;
-  PFN_vkVoidFunction ptr;
-};
-
-VulkanFunction hookedInstanceFunctions[] = {
-    {"vkGetInstanceProcAddr", reinterpret_cast<PFN_vkVoidFunction>(vkGetInstanceProcAddr)},
-    {"vkCreateInstance", reinterpret_cast<PFN_vkVoidFunction>(vkCreateInstance)},
-    {"vkDestroyInstance", reinterpret_cast<PFN_vkVoidFunction>(vkDestroyInstance)},
-    {"vkEnumeratePhysicalDevices",
-     reinterpret_cast<PFN_vkVoidFunction>(vkEnumeratePhysicalDevices)},
-    {"vkCreateDevice", reinterpret_cast<PFN_vkVoidFunction>(vkCreateDevice)},
-    //{"vkEnumerateInstanceLayerProperties",
-    // reinterpret_cast<PFN_vkVoidFunction>(vkEnumerateInstanceLayerProperties)},
-    {"vkEnumerateDeviceLayerProperties",
-     reinterpret_cast<PFN_vkVoidFunction>(vkEnumerateDeviceLayerProperties)},
-    //{"vkEnumerateInstanceExtensionProperties",
-    // reinterpret_cast<PFN_vkVoidFunction>(vkEnumerateInstanceExtensionProperties)},
-    {"vkEnumerateDeviceExtensionProperties",
-     reinterpret_cast<PFN_vkVoidFunction>(vkEnumerateDeviceExtensionProperties)},
-    {"vkGetPhysicalDeviceQueueFamilyProperties",
-     reinterpret_cast<PFN_vkVoidFunction>(vkGetPhysicalDeviceQueueFamilyProperties)},
-    {"vkGetPhysicalDeviceQueueFamilyProperties2",
-     reinterpret_cast<PFN_vkVoidFunction>(vkGetPhysicalDeviceQueueFamilyProperties2)},
-    {"vkGetPhysicalDeviceQueueFamilyProperties2KHR",
-     reinterpret_cast<PFN_vkVoidFunction>(vkGetPhysicalDeviceQueueFamilyProperties2KHR) } };
 
 void registerInstanceFunctions(VkInstDispatchTable* pTable, VkInstance instance)
 {
@@ -100,12 +71,6 @@ void registerInstanceFunctions(VkInstDispatchTable* pTable, VkInstance instance)
   pTable->GetPhysicalDeviceSurfaceCapabilitiesKHR = (PFN_vkGetPhysicalDeviceSurfaceCapabilitiesKHR)gpa(instance, "vkGetPhysicalDeviceSurfaceCapabilitiesKHR");
 }
 
-VulkanFunction hookedDeviceFunctions[] = {
-    {"vkGetDeviceProcAddr", reinterpret_cast<PFN_vkVoidFunction>(vkGetDeviceProcAddr)},
-    {"vkDestroyDevice", reinterpret_cast<PFN_vkVoidFunction>(vkDestroyDevice)},
-    {"vkGetDeviceQueue", reinterpret_cast<PFN_vkVoidFunction>(vkGetDeviceQueue)}
-};
-
 void registerDeviceFunctions(VkDevDispatchTable* pTable, VkDevice device)
 {
   PFN_vkGetDeviceProcAddr gpa = pTable->GetDeviceProcAddr;
@@ -143,9 +108,11 @@ void registerDeviceFunctions(VkDevDispatchTable* pTable, VkDevice device)
   pTable->CreateCommandPool = (PFN_vkCreateCommandPool)gpa(device, "vkCreateCommandPool");
   pTable->MapMemory = (PFN_vkMapMemory)gpa(device, "vkMapMemory");
   pTable->UnmapMemory = (PFN_vkUnmapMemory)gpa(device, "vkUnmapMemory");
+  pTable->FlushMappedMemoryRanges = (PFN_vkFlushMappedMemoryRanges)gpa(device, "vkFlushMappedMemoryRanges");
   pTable->QueueSubmit = (PFN_vkQueueSubmit)gpa(device, "vkQueueSubmit");
   pTable->BeginCommandBuffer = (PFN_vkBeginCommandBuffer)gpa(device, "vkBeginCommandBuffer");
   pTable->FreeCommandBuffers = (PFN_vkFreeCommandBuffers)gpa(device, "vkFreeCommandBuffers");
+  pTable->ResetCommandBuffer = (PFN_vkResetCommandBuffer)gpa(device, "vkResetCommandBuffer");
   pTable->CmdBeginRenderPass = (PFN_vkCmdBeginRenderPass)gpa(device, "vkCmdBeginRenderPass");
   pTable->CmdBindPipeline = (PFN_vkCmdBindPipeline)gpa(device, "vkCmdBindPipeline");
   pTable->CmdBindDescriptorSets = (PFN_vkCmdBindDescriptorSets)gpa(device, "vkCmdBindDescriptorSets");
@@ -158,19 +125,19 @@ void registerDeviceFunctions(VkDevDispatchTable* pTable, VkDevice device)
   pTable->AllocateCommandBuffers = (PFN_vkAllocateCommandBuffers)gpa(device, "vkAllocateCommandBuffers");
   pTable->CreateShaderModule = (PFN_vkCreateShaderModule)gpa(device, "vkCreateShaderModule");
   pTable->CmdCopyBuffer = (PFN_vkCmdCopyBuffer)gpa(device, "vkCmdCopyBuffer");
+  pTable->CreateQueryPool = (PFN_vkCreateQueryPool)gpa(device, "vkCreateQueryPool");
+  pTable->DestroyQueryPool = (PFN_vkDestroyQueryPool)gpa(device, "vkDestroyQueryPool");
+  pTable->GetQueryPoolResults = (PFN_vkGetQueryPoolResults)gpa(device, "vkGetQueryPoolResults");
+  pTable->CmdResetQueryPool = (PFN_vkCmdResetQueryPool)gpa(device, "vkCmdResetQueryPool");
+  pTable->CmdWriteTimestamp = (PFN_vkCmdWriteTimestamp)gpa(device, "vkCmdWriteTimestamp");
   pTable->WaitForFences = (PFN_vkWaitForFences)gpa(device, "vkWaitForFences");
+  pTable->GetFenceStatus = (PFN_vkGetFenceStatus)gpa(device, "vkGetFenceStatus");
   pTable->ResetFences = (PFN_vkResetFences)gpa(device, "vkResetFences");
   pTable->DestroyImageView = (PFN_vkDestroyImageView)gpa(device, "vkDestroyImageView");
   pTable->DestroyFramebuffer = (PFN_vkDestroyFramebuffer)gpa(device, "vkDestroyFramebuffer");
   pTable->DestroyDescriptorPool = (PFN_vkDestroyDescriptorPool)gpa(device, "vkDestroyDescriptorPool");
 }
 
-VulkanFunction hookedKHRExtFunctions[] = {
-    {"vkCreateSwapchainKHR", reinterpret_cast<PFN_vkVoidFunction>(vkCreateSwapchainKHR)},
-    {"vkDestroySwapchainKHR", reinterpret_cast<PFN_vkVoidFunction>(vkDestroySwapchainKHR)},
-    {"vkGetSwapchainImagesKHR", reinterpret_cast<PFN_vkVoidFunction>(vkGetSwapchainImagesKHR)},
-    {"vkQueuePresentKHR", reinterpret_cast<PFN_vkVoidFunction>(vkQueuePresentKHR)}};
-
 void registerDeviceKHRExtFunctions(VkDevDispatchTable* pTable, VkDevice device)
 {
   PFN_vkGetDeviceProcAddr gpa = pTable->GetDeviceProcAddr;
@@ -560,7 +527,8 @@ vkCreateSwapchainKHR(VkDevice device, const VkSwapchainCreateInfoKHR* pCreateInf
 
   g_Rendering->OnCreateSwapchain(
       device, pTable, g_AppResources.GetPhysicalDeviceMapping(physicalDevice)->memoryProperties,
-      *pSwapchain, createInfo.imageFormat, pCreateInfo->imageExtent, createInfo.imageUsage);
+      *pSwapchain, createInfo.imageFormat, pCreateInfo->imageExtent, createInfo.imageUsage,
+      g_AppResources.GetPhysicalDeviceMapping(physicalDevice)->timestampPeriod);
 
   // if we find a VRCompositor, create swapchain for HMD overlay
   if (GetVRCompositor() != nullptr) {
@@ -643,8 +611,9 @@ vkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR* pPresentInfo)
 
   auto semaphore = g_Rendering->OnPresent(
     pTable, deviceLoaderDataFunc_.Get(device), queue, queueFamilyIndex, queueProperties.queueFlags,
-    pPresentInfo->pSwapchains[0], pPresentInfo->pImageIndices[0],
-    pPresentInfo->waitSemaphoreCount, pPresentInfo->pWaitSemaphores, g_LagIndicatorState);
+    pPresentInfo->swapchainCount, pPresentInfo->pSwapchains, pPresentInfo->pImageIndices,
+    pPresentInfo->waitSemaphoreCount, pPresentInfo->pWaitSemaphores,
+    queueProperties.timestampValidBits, GameOverlay::g_inputSampler.GetLagIndicatorState());
 
   VkPresentInfoKHR newPresentInfo = *pPresentInfo;
   if (semaphore != VK_NULL_HANDLE) {
@@ -652,14 +621,7 @@ vkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR* pPresentInfo)
     newPresentInfo.pWaitSemaphores = &semaphore;
   }
 
-  VkResult result = pTable->QueuePresentKHR(queue, &newPresentInfo);
-
-  g_mutex.lock();
-#define KEY_DOWN(key) (key < 0 ? 0 : (GetAsyncKeyState(key) & 0x8000) != 0)
-  g_LagIndicatorState = KEY_DOWN(g_Rendering->GetLagIndicatorHotkey());
-  g_mutex.unlock();
-
-  return result;
+  return pTable->QueuePresentKHR(queue, &newPresentInfo);
 }
 
 //VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL
@@ -720,22 +682,8 @@ vkEnumerateDeviceExtensionProperties(VkPhysicalDevice physicalDevice, const char
 VK_LAYER_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetInstanceProcAddr(VkInstance instance,
                                                                                const char* funcName)
 {
-  for (const auto& hf : hookedInstanceFunctions) {
-    if (strcmp(funcName, hf.name) == 0) {
-      return hf.ptr;
-    }
-  }
-
-  for (const auto& hf : hookedDeviceFunctions) {
-    if (strcmp(funcName, hf.name) == 0) {
-      return hf.ptr;
-    }
-  }
-
-  for (const auto& hf : hookedKHRExtFunctions) {
-    if (strcmp(funcName, hf.name) == 0) {
-      return hf.ptr;
-    }
+  if (PFN_vkVoidFunction function = GetLayerHookFunction(funcName, false)) {
+    return function;
   }
 
   VkInstDispatchTable* pTable = instanceDispatchTable_.Get(instance);
@@ -749,16 +697,8 @@ VK_LAYER_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetInstanceProcAddr(V
 VK_LAYER_EXPORT VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetDeviceProcAddr(VkDevice device,
                                                                              const char* funcName)
 {
-  for (const auto& hf : hookedDeviceFunctions) {
-    if (strcmp(funcName, hf.name) == 0) {
-      return hf.ptr;
-    }
-  }
-
-  for (const auto& hf : hookedKHRExtFunctions) {
-    if (strcmp(funcName, hf.name) == 0) {
-      return hf.ptr;
-    }
+  if (PFN_vkVoidFunction function = GetLayerHookFunction(funcName, true)) {
+    return function;
   }
 
   VkDevDispatchTable* pTable = deviceDispatchTable_.Get(device);
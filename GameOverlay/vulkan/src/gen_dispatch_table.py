@@ -15,11 +15,15 @@ if sys.platform == 'msys':
 # that way we're not sensitive to CWD
 pathname = os.path.abspath(os.path.dirname(sys.argv[0])) + os.path.sep
 
+# gen_dispatch_table.py [vk.xml [output directory]], the tests generate from the SDK's registry
+registry_file = sys.argv[1] if len(sys.argv) > 1 else pathname + 'vk.xml'
+output_path = os.path.join(sys.argv[2], '') if len(sys.argv) > 2 else pathname
+
 # open the file for write
-f = open(pathname + 'vk_dispatch_defs.h', mode='w', newline = nl)
+f = open(output_path + 'vk_dispatch_defs.h', mode='w', newline = nl)
 
 # open XML registry
-registry = ET.parse(pathname + 'vk.xml').getroot()
+registry = ET.parse(registry_file).getroot()
 
 # f.write the file, starting with a template header
 f.write('''
@@ -199,3 +203,116 @@ struct VkDevDispatchTable
   PFN_vkCreateDevice CreateDevice;
 }};
 '''.format(**locals()))
+
+f.close()
+
+# Entry points intercepted by the layer. vkGetInstanceProcAddr returns all of them,
+# vkGetDeviceProcAddr only the device level ones.
+hooked_instance_commands = [
+    'vkGetInstanceProcAddr',
+    'vkCreateInstance',
+    'vkDestroyInstance',
+    'vkEnumeratePhysicalDevices',
+    'vkCreateDevice',
+    # 'vkEnumerateInstanceLayerProperties',
+    'vkEnumerateDeviceLayerProperties',
+    # 'vkEnumerateInstanceExtensionProperties',
+    'vkEnumerateDeviceExtensionProperties',
+    'vkGetPhysicalDeviceQueueFamilyProperties',
+    'vkGetPhysicalDeviceQueueFamilyProperties2',
+    'vkGetPhysicalDeviceQueueFamilyProperties2KHR',
+]
+
+hooked_device_commands = [
+    'vkGetDeviceProcAddr',
+    'vkDestroyDevice',
+    'vkGetDeviceQueue',
+    'vkCreateSwapchainKHR',
+    'vkDestroySwapchainKHR',
+    'vkGetSwapchainImagesKHR',
+    'vkQueuePresentKHR',
+]
+
+for function in hooked_instance_commands + hooked_device_commands:
+    if function not in commands:
+        raise ValueError('hooked command {} is unknown'.format(function))
+
+# FNV-1a, the seed is searched so that every hooked name gets its own slot and a lookup
+# only needs a single strcmp to reject names the layer does not intercept
+def fnv1a(name, seed):
+    h = (2166136261 ^ seed) & 0xffffffff
+    for c in name.encode('ascii'):
+        h ^= c
+        h = (h * 16777619) & 0xffffffff
+    return h
+
+hooked_commands = hooked_instance_commands + hooked_device_commands
+hook_slots = 1
+while hook_slots < len(hooked_commands) * 2:
+    hook_slots *= 2
+
+hook_seed = 0
+while len(set(fnv1a(name, hook_seed) & (hook_slots - 1) for name in hooked_commands)) != len(hooked_commands):
+    hook_seed += 1
+
+slots = ['  {nullptr, nullptr, false},'] * hook_slots
+for name in hooked_commands:
+    slots[fnv1a(name, hook_seed) & (hook_slots - 1)] = '  {{"{name}", reinterpret_cast<PFN_vkVoidFunction>({name}), {device}}},'.format(
+        name = name, device = 'true' if name in hooked_device_commands else 'false')
+hook_table = '\n'.join(slots)
+
+f = open(output_path + 'vk_layer_hooks.h', mode='w', newline = nl)
+
+f.write('''
+// This file is autogenerated with gen_dispatch_table.py - any changes will be overwritten next time
+// that script is run.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <vulkan/vulkan.h>
+
+// this file is autogenerated, so don't worry about clang-format issues
+// clang-format off
+
+struct VkLayerHook
+{{
+  const char* name;
+  PFN_vkVoidFunction function;
+  // also returned by vkGetDeviceProcAddr
+  bool device;
+}};
+
+// Perfect hash over the names of the entry points intercepted by the layer, returns nullptr
+// for every other name.
+inline const VkLayerHook* FindLayerHook(const char* name)
+{{
+  static const VkLayerHook hooks[{hook_slots}] = {{
+{hook_table}
+  }};
+
+  uint32_t hash = 2166136261u ^ {hook_seed}u;
+  for (const char* c = name; *c; ++c) {{
+    hash ^= static_cast<uint8_t>(*c);
+    hash *= 16777619u;
+  }}
+
+  const VkLayerHook& hook = hooks[hash & {hook_mask}];
+  if (hook.name && strcmp(hook.name, name) == 0) {{
+    return &hook;
+  }}
+  return nullptr;
+}}
+
+// Entry point of the layer returned by vkGetInstanceProcAddr or, if device is set, by
+// vkGetDeviceProcAddr. nullptr if the query has to be passed down the chain.
+inline PFN_vkVoidFunction GetLayerHookFunction(const char* name, bool device)
+{{
+  const VkLayerHook* hook = FindLayerHook(name);
+  return hook && (hook->device || !device) ? hook->function : nullptr;
+}}
+'''.lstrip().format(hook_slots = hook_slots, hook_table = hook_table, hook_seed = hook_seed, hook_mask = hook_slots - 1))
+
+f.close()
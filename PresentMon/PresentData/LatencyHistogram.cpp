@@ -0,0 +1,138 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+const double LatencyHistogram::MIN_MS = 1.0 / 64.0;
+const double LatencyHistogram::MAX_MS = LatencyHistogram::MIN_MS * (1 << OCTAVE_COUNT);
+
+uint32_t LatencyHistogram::GetBucketIndex(double ms)
+{
+  if (!(ms >= MIN_MS)) {
+    return 0;
+  }
+  if (ms >= MAX_MS) {
+    return BUCKET_COUNT - 1;
+  }
+  const double octaves = std::log2(ms / MIN_MS);
+  uint32_t bucket = std::min<uint32_t>(1 + static_cast<uint32_t>(octaves * BUCKETS_PER_OCTAVE),
+                                       BUCKET_COUNT - 2);
+  // log2 can round across a bucket bound, keep the index consistent with the bounds
+  if (ms < GetBucketLowerBound(bucket)) {
+    bucket--;
+  }
+  else if (ms >= GetBucketUpperBound(bucket)) {
+    bucket++;
+  }
+  return bucket;
+}
+
+double LatencyHistogram::GetBucketLowerBound(uint32_t bucket)
+{
+  if (bucket == 0) {
+    return 0.0;
+  }
+  return MIN_MS * std::exp2(static_cast<double>(bucket - 1) / BUCKETS_PER_OCTAVE);
+}
+
+double LatencyHistogram::GetBucketUpperBound(uint32_t bucket)
+{
+  if (bucket >= BUCKET_COUNT - 1) {
+    return HUGE_VAL;
+  }
+  return GetBucketLowerBound(bucket + 1);
+}
+
+void LatencyHistogram::Add(double ms)
+{
+  if (ms < 0.0) {
+    return;
+  }
+  if (mTotalCount == 0) {
+    mMinMs = ms;
+    mMaxMs = ms;
+  }
+  else {
+    mMinMs = std::min(mMinMs, ms);
+    mMaxMs = std::max(mMaxMs, ms);
+  }
+  mCounts[GetBucketIndex(ms)]++;
+  mTotalCount++;
+  mSumMs += ms;
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+  if (other.mTotalCount == 0) {
+    return;
+  }
+  if (mTotalCount == 0) {
+    mMinMs = other.mMinMs;
+    mMaxMs = other.mMaxMs;
+  }
+  else {
+    mMinMs = std::min(mMinMs, other.mMinMs);
+    mMaxMs = std::max(mMaxMs, other.mMaxMs);
+  }
+  for (uint32_t i = 0; i < BUCKET_COUNT; ++i) {
+    mCounts[i] += other.mCounts[i];
+  }
+  mTotalCount += other.mTotalCount;
+  mSumMs += other.mSumMs;
+}
+
+void LatencyHistogram::Reset()
+{
+  *this = LatencyHistogram();
+}
+
+double LatencyHistogram::GetMean() const
+{
+  return mTotalCount ? mSumMs / mTotalCount : 0.0;
+}
+
+double LatencyHistogram::GetPercentile(double percentile) const
+{
+  if (mTotalCount == 0) {
+    return 0.0;
+  }
+
+  const double rank = std::min(std::max(percentile, 0.0), 100.0) / 100.0 * mTotalCount;
+  uint64_t cumulative = 0;
+  for (uint32_t i = 0; i < BUCKET_COUNT; ++i) {
+    if (mCounts[i] == 0) {
+      continue;
+    }
+    if (cumulative + mCounts[i] >= rank) {
+      // the exact extremes are known, so don't report values outside of them
+      const double lower = std::max(GetBucketLowerBound(i), mMinMs);
+      const double upper = std::min(GetBucketUpperBound(i), mMaxMs);
+      const double fraction = (rank - cumulative) / mCounts[i];
+      return lower + fraction * (upper - lower);
+    }
+    cumulative += mCounts[i];
+  }
+  return mMaxMs;
+}
@@ -0,0 +1,73 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+// Latency histogram with logarithmically spaced buckets. Each power of two
+// between MIN_MS and MAX_MS is split into BUCKETS_PER_OCTAVE buckets, which keeps
+// the relative error of the reported percentiles below ~9% independent of the
+// magnitude, while the memory footprint stays fixed.
+struct LatencyHistogram
+{
+  enum {
+    BUCKETS_PER_OCTAVE = 8,
+    OCTAVE_COUNT = 18,
+    // first bucket collects values below MIN_MS, last bucket values above MAX_MS
+    BUCKET_COUNT = BUCKETS_PER_OCTAVE * OCTAVE_COUNT + 2
+  };
+
+  static const double MIN_MS;
+  static const double MAX_MS;
+
+  uint64_t mCounts[BUCKET_COUNT] = {};
+  uint64_t mTotalCount = 0;
+  double mSumMs = 0.0;
+  double mMinMs = 0.0;
+  double mMaxMs = 0.0;
+
+  void Add(double ms);
+  void Merge(const LatencyHistogram& other);
+  void Reset();
+
+  double GetMean() const;
+  // percentile in [0, 100], interpolated within the bucket
+  double GetPercentile(double percentile) const;
+
+  static uint32_t GetBucketIndex(double ms);
+  static double GetBucketLowerBound(uint32_t bucket);
+  static double GetBucketUpperBound(uint32_t bucket);
+};
+
+// Latency decomposition of a single swap chain:
+// present call -> GPU work complete -> frame displayed.
+struct SwapChainLatencyHistograms
+{
+  std::wstring mProcessName;
+  uint32_t mProcessId = 0;
+  uint64_t mSwapChainAddress = 0;
+  LatencyHistogram mUntilRenderComplete;
+  LatencyHistogram mRenderCompleteToDisplayed;
+  LatencyHistogram mUntilDisplayed;
+};
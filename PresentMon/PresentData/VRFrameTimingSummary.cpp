@@ -0,0 +1,66 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "VRFrameTimingSummary.hpp"
+
+void VRFrameTimingSummary::AddCompositorFrame(bool newAppFrame, bool appMissed, bool compositorMissed,
+                                              double compositorGpuMs, double motionToPhotonMs)
+{
+  mCompositorFrameCount++;
+  if (newAppFrame) {
+    mAppFrameCount++;
+  }
+  else {
+    mReprojectedCount++;
+  }
+  if (appMissed) {
+    mAppMissedCount++;
+  }
+  if (compositorMissed) {
+    mCompositorMissedCount++;
+  }
+  if (compositorGpuMs > 0.0) {
+    mCompositorGpuTime.Add(compositorGpuMs);
+  }
+  if (motionToPhotonMs > 0.0) {
+    mMotionToPhoton.Add(motionToPhotonMs);
+  }
+}
+
+double VRFrameTimingSummary::GetAppMissedRate() const
+{
+  if (!mAppMissedTracked) {
+    return -1.0;
+  }
+  const uint64_t expected = mAppFrameCount + mAppMissedCount;
+  return expected == 0 ? 0.0 : double(mAppMissedCount) / expected;
+}
+
+double VRFrameTimingSummary::GetReprojectionRate() const
+{
+  return mCompositorFrameCount == 0 ? 0.0 : double(mReprojectedCount) / mCompositorFrameCount;
+}
+
+double VRFrameTimingSummary::GetCompositorMissedRate() const
+{
+  return mCompositorFrameCount == 0 ? 0.0 : double(mCompositorMissedCount) / mCompositorFrameCount;
+}
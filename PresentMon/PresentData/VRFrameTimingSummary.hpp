@@ -0,0 +1,62 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#include "LatencyHistogram.hpp"
+
+// Frame timing of one VR application as seen by its compositor (WMR late stage
+// reprojection, SteamVR or Oculus), accumulated for the whole recording. Timings
+// are kept in histograms so the memory use does not grow with the capture length.
+struct VRFrameTimingSummary
+{
+  std::wstring mProcessName;
+  std::wstring mFileName;
+  std::string mCompositor;
+  uint32_t mProcessId = 0;
+
+  uint64_t mCompositorFrameCount = 0;
+  // Compositor frames which latched a new application frame
+  uint64_t mAppFrameCount = 0;
+  uint64_t mAppMissedCount = 0;
+  // False if the compositor events can't tell a missed application frame apart from a
+  // reprojection, as for WMR where both only show as a compositor frame without a new source.
+  bool mAppMissedTracked = true;
+  // Compositor frames which reprojected an already displayed application frame
+  uint64_t mReprojectedCount = 0;
+  uint64_t mCompositorMissedCount = 0;
+  LatencyHistogram mCompositorGpuTime;
+  LatencyHistogram mMotionToPhoton;
+
+  // Timings <= 0 are unknown for this frame and not added.
+  void AddCompositorFrame(bool newAppFrame, bool appMissed, bool compositorMissed,
+                          double compositorGpuMs, double motionToPhotonMs);
+
+  // Missed application frames relative to all frames the application should have delivered,
+  // -1 if not tracked
+  double GetAppMissedRate() const;
+  double GetReprojectionRate() const;
+  double GetCompositorMissedRate() const;
+};
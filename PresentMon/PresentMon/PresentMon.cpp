@@ -653,6 +653,49 @@ const char* FinalStateToDroppedString(PresentResult res)
   }
 }
 
+// The Oculus events have no VSync, it is guessed to happen this long after EndSpinWait, which
+// is the spin wait of the compositor for the next frame interval.
+static const double OCULUS_END_SPIN_WAIT_TO_VSYNC_MS = 8.5;
+
+static std::mutex g_VRFrameTimingSummariesMutex;
+static std::vector<VRFrameTimingSummary> g_VRFrameTimingSummaries;
+
+static void UpdateVRFrameTimingSummary(PresentMonData& pm, ProcessInfo const& proc, uint32_t processId, const char* compositor,
+  bool newAppFrame, bool appMissed, bool appMissedTracked, bool compositorMissed, double compositorGpuMs,
+  double motionToPhotonMs)
+{
+  auto& summary = pm.mVRFrameTimingSummaries[std::make_pair(processId, std::string(compositor))];
+  if (summary.mCompositorFrameCount == 0) {
+    summary.mAppMissedTracked = appMissedTracked;
+    summary.mProcessName = proc.mModuleName;
+    summary.mFileName = proc.mFileName;
+    summary.mCompositor = compositor;
+    summary.mProcessId = processId;
+  }
+  summary.AddCompositorFrame(newAppFrame, appMissed, compositorMissed, compositorGpuMs, motionToPhotonMs);
+  pm.mVRFrameTimingSummariesChanged = true;
+}
+
+static void PublishVRFrameTimingSummaries(PresentMonData& pm)
+{
+  if (!pm.mVRFrameTimingSummariesChanged) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(g_VRFrameTimingSummariesMutex);
+  g_VRFrameTimingSummaries.clear();
+  for (auto& s : pm.mVRFrameTimingSummaries) {
+    g_VRFrameTimingSummaries.push_back(s.second);
+  }
+  pm.mVRFrameTimingSummariesChanged = false;
+}
+
+std::vector<VRFrameTimingSummary> GetVRFrameTimingSummaries()
+{
+  std::lock_guard<std::mutex> lock(g_VRFrameTimingSummariesMutex);
+  return g_VRFrameTimingSummaries;
+}
+
 void AddLateStageReprojection(PresentMonData& pm, LateStageReprojectionEvent& p, uint64_t now, uint64_t perfFreq)
 {
   const uint32_t appProcessId = p.GetAppProcessId();
@@ -666,6 +709,10 @@ void AddLateStageReprojection(PresentMonData& pm, LateStageReprojectionEvent& p,
   }
 
   pm.mLateStageReprojectionData.AddLateStageReprojection(p);
+  // A compositor frame without a new source is a reprojection, LSR doesn't tell whether the
+  // application missed its frame or was never expected to deliver one
+  UpdateVRFrameTimingSummary(pm, *proc, appProcessId, "WMR", p.NewSourceLatched, false, false,
+    p.MissedVsyncCount > 0, p.GpuStartToGpuStopInMs, p.GetLsrMotionToPhotonLatencyMs());
 
   auto file = proc->mOutputFile;
   if (file && (p.FinalState == LateStageReprojectionResult::Presented || !pm.mArgs->mExcludeDropped)) {
@@ -784,6 +831,15 @@ void AddSteamVREvent(PresentMonData& pm, SteamVREvent& p, uint64_t now, uint64_t
   }
 
   pm.mSVRData.AddCompositorPresent(p);
+  {
+    const double compositorGpuMs = (p.ReprojectionStart && p.ReprojectionEnd > p.ReprojectionStart)
+      ? 1000 * double(p.ReprojectionEnd - p.ReprojectionStart) / perfFreq : 0.0;
+    // No photon timing available, approximated by the end of the reprojection pass
+    const double motionToPhotonMs = (p.AppRenderStart && p.ReprojectionEnd > p.AppRenderStart)
+      ? 1000 * double(p.ReprojectionEnd - p.AppRenderStart) / perfFreq : 0.0;
+    UpdateVRFrameTimingSummary(pm, *proc, appProcessId, "SteamVR", p.AppRenderStart && !p.AppMiss, p.AppMiss, true,
+      p.WarpMiss, compositorGpuMs, motionToPhotonMs);
+  }
 
   auto file = proc->mOutputFile;
   if (file) {
@@ -866,6 +922,15 @@ void AddOculusVREvent(PresentMonData& pm, OculusVREvent& p, uint64_t now, uint64
   }
 
   pm.mOVRData.AddCompositorPresent(p);
+  {
+    const double compositorGpuMs = (p.ReprojectionStart && p.ReprojectionEnd > p.ReprojectionStart)
+      ? 1000 * double(p.ReprojectionEnd - p.ReprojectionStart) / perfFreq : 0.0;
+    // VSync is guessed based on the EndSpinWait event, as for the csv output
+    const double motionToPhotonMs = (p.AppRenderStart && p.EndSpinWait > p.AppRenderStart)
+      ? 1000 * double(p.EndSpinWait - p.AppRenderStart) / perfFreq + OCULUS_END_SPIN_WAIT_TO_VSYNC_MS : 0.0;
+    UpdateVRFrameTimingSummary(pm, *proc, appProcessId, "OculusVR", p.AppRenderStart && !p.AppMiss, p.AppMiss, true,
+      p.WarpMiss, compositorGpuMs, motionToPhotonMs);
+  }
 
   auto file = proc->mOutputFile;
   if (file) {
@@ -899,7 +964,7 @@ void AddOculusVREvent(PresentMonData& pm, OculusVREvent& p, uint64_t now, uint64
       const double reprojectionEnd = (double)(int64_t)(p.ReprojectionEnd - pm.mStartupQpcTime) / perfFreq;
 
       // guess VSync based on EndSpinWait Event
-      const double VSync = ((double)(int64_t)(p.EndSpinWait - pm.mStartupQpcTime) / perfFreq) + 0.0085;
+      const double VSync = ((double)(int64_t)(p.EndSpinWait - pm.mStartupQpcTime) / perfFreq) + OCULUS_END_SPIN_WAIT_TO_VSYNC_MS / 1000;
 
       PresentFrameInfo frameInfo;
 
@@ -939,6 +1004,104 @@ void AddOculusVREvent(PresentMonData& pm, OculusVREvent& p, uint64_t now, uint64
   pm.mOVRData.PruneDeque(perfFreq, MAX_HISTORY_TIME, MAX_PRESENTS_IN_DEQUE);
 }
 
+static std::mutex g_LatencyHistogramsMutex;
+static std::vector<SwapChainLatencyHistograms> g_LatencyHistograms;
+
+static void UpdateLatencyHistograms(PresentMonData& pm, ProcessInfo const& proc, PresentEvent const& p, uint64_t perfFreq)
+{
+  // ReadyTime and ScreenTime are only tracked for displayed frames above simple verbosity
+  if (p.FinalState != PresentResult::Presented || p.ReadyTime == 0 || p.ScreenTime == 0) {
+    return;
+  }
+
+  auto& histograms = pm.mLatencyHistograms[std::make_pair(p.ProcessId, p.SwapChainAddress)];
+  if (histograms.mUntilDisplayed.mTotalCount == 0) {
+    histograms.mProcessName = proc.mModuleName;
+    histograms.mProcessId = p.ProcessId;
+    histograms.mSwapChainAddress = p.SwapChainAddress;
+  }
+
+  const double untilRenderComplete = 1000 * double(p.ReadyTime - p.QpcTime) / perfFreq;
+  const double untilDisplayed = 1000 * double(p.ScreenTime - p.QpcTime) / perfFreq;
+  histograms.mUntilRenderComplete.Add(untilRenderComplete);
+  histograms.mRenderCompleteToDisplayed.Add(untilDisplayed - untilRenderComplete);
+  histograms.mUntilDisplayed.Add(untilDisplayed);
+  pm.mLatencyHistogramsChanged = true;
+}
+
+static void PublishLatencyHistograms(PresentMonData& pm)
+{
+  if (!pm.mLatencyHistogramsChanged) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(g_LatencyHistogramsMutex);
+  g_LatencyHistograms.clear();
+  for (auto& h : pm.mLatencyHistograms) {
+    g_LatencyHistograms.push_back(h.second);
+  }
+  pm.mLatencyHistogramsChanged = false;
+}
+
+std::vector<SwapChainLatencyHistograms> GetLatencyHistograms()
+{
+  std::lock_guard<std::mutex> lock(g_LatencyHistogramsMutex);
+  return g_LatencyHistograms;
+}
+
+static void WriteLatencyHistogram(FILE* file, SwapChainLatencyHistograms const& h, const char* metric, LatencyHistogram const& histogram)
+{
+  uint64_t cumulative = 0;
+  for (uint32_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+    if (histogram.mCounts[i] == 0) {
+      continue;
+    }
+    cumulative += histogram.mCounts[i];
+    const double upper = LatencyHistogram::GetBucketUpperBound(i);
+    fprintf(file, "%ws,%d,0x%016llX,%s,%.4lf,%.4lf,%llu,%.6lf\n",
+      h.mProcessName.c_str(), h.mProcessId, h.mSwapChainAddress, metric,
+      LatencyHistogram::GetBucketLowerBound(i), i == LatencyHistogram::BUCKET_COUNT - 1 ? histogram.mMaxMs : upper,
+      histogram.mCounts[i], double(cumulative) / histogram.mTotalCount);
+  }
+}
+
+// Writes all latency histograms of the recording into
+// PATH-LatencyHistograms-TIME.csv next to the regular output files.
+static void WriteLatencyHistograms(PresentMonData const& pm)
+{
+  if (pm.mLatencyHistograms.empty()) {
+    return;
+  }
+
+  wchar_t path[MAX_PATH];
+  if (pm.mArgs->mOutputFileName) {
+    wchar_t drive[_MAX_DRIVE];
+    wchar_t dir[_MAX_DIR];
+    wchar_t name[_MAX_FNAME];
+    wchar_t ext[_MAX_EXT];
+    _wsplitpath_s(ConvertUTF8StringToUTF16String(pm.mArgs->mOutputFileName).c_str(), drive, dir, name, ext);
+    _snwprintf_s(path, MAX_PATH, _TRUNCATE, L"%s%s%s-LatencyHistograms-%S.csv", drive, dir, name, pm.mCaptureTimeStr);
+  }
+  else {
+    _snwprintf_s(path, MAX_PATH, _TRUNCATE, L"PresentMon-LatencyHistograms-%S.csv", pm.mCaptureTimeStr);
+  }
+
+  FILE* file = nullptr;
+  _wfopen_s(&file, path, L"w");
+  if (file == nullptr) {
+    g_messageLog.LogWarning("PresentMon", std::wstring(L"Could not create latency histogram file ") + path);
+    return;
+  }
+
+  fprintf(file, "Application,ProcessID,SwapChainAddress,Latency,BucketStartMs,BucketEndMs,Count,CumulativeFraction\n");
+  for (auto& h : pm.mLatencyHistograms) {
+    WriteLatencyHistogram(file, h.second, "MsUntilRenderComplete", h.second.mUntilRenderComplete);
+    WriteLatencyHistogram(file, h.second, "MsRenderCompleteToDisplayed", h.second.mRenderCompleteToDisplayed);
+    WriteLatencyHistogram(file, h.second, "MsUntilDisplayed", h.second.mUntilDisplayed);
+  }
+  fclose(file);
+}
+
 void AddPresent(PresentMonData& pm, PresentEvent& p, uint64_t now, uint64_t perfFreq)
 {
   const uint32_t appProcessId = p.ProcessId;
@@ -949,6 +1112,7 @@ void AddPresent(PresentMonData& pm, PresentEvent& p, uint64_t now, uint64_t perf
 
   auto& chain = proc->mChainMap[p.SwapChainAddress];
   chain.AddPresentToSwapChain(p);
+  UpdateLatencyHistograms(pm, *proc, p, perfFreq);
 
   auto file = proc->mOutputFile;
   if (file && (p.FinalState == PresentResult::Presented || !pm.mArgs->mExcludeDropped)) {
@@ -1050,6 +1214,15 @@ void PresentMon_Init(const CommandLineArgs& args, PresentMonData& pm)
     pm.mStartupQpcTime = 0;
   }
 
+  {
+    std::lock_guard<std::mutex> lock(g_LatencyHistogramsMutex);
+    g_LatencyHistograms.clear();
+  }
+  {
+    std::lock_guard<std::mutex> lock(g_VRFrameTimingSummariesMutex);
+    g_VRFrameTimingSummaries.clear();
+  }
+
   // Generate capture date string in ISO 8601 format
   {
     struct tm tm;
@@ -1091,6 +1264,9 @@ void PresentMon_Update(PresentMonData& pm, std::vector<std::shared_ptr<PresentEv
     AddOculusVREvent(pm, *p, now, perfFreq);
   }
 
+  PublishLatencyHistograms(pm);
+  PublishVRFrameTimingSummaries(pm);
+
   // Update realtime process info
   if (!pm.mArgs->mEtlFileName) {
     std::vector<std::map<uint32_t, ProcessInfo>::iterator> removeDXGI;
@@ -1158,6 +1334,12 @@ void PresentMon_Shutdown(PresentMonData& pm, uint32_t totalEventsLost, uint32_t
   pm.mOutputFile = nullptr;
   pm.mLsrOutputFile = nullptr;
 
+  PublishLatencyHistograms(pm);
+  WriteLatencyHistograms(pm);
+  pm.mLatencyHistograms.clear();
+  PublishVRFrameTimingSummaries(pm);
+  pm.mVRFrameTimingSummaries.clear();
+
   for (auto& p : pm.mDXGIProcessMap) {
     auto proc = &p.second;
     CloseFile(proc->mOutputFile, totalEventsLost, totalBuffersLost);
@@ -37,6 +37,8 @@ SOFTWARE.
 #include "../PresentData/MixedRealityTraceConsumer.hpp"
 #include "../PresentData/SteamVRTraceConsumer.hpp"
 #include "../PresentData/OculusVRTraceConsumer.hpp"
+#include "../PresentData/LatencyHistogram.hpp"
+#include "../PresentData/VRFrameTimingSummary.hpp"
 
 
 struct ProcessInfo {
@@ -72,6 +74,13 @@ struct PresentMonData {
   Verbosity mSVRVerbosity = Verbosity::Default;
   Verbosity mOVRVerbosity = Verbosity::Default;
   SystemSpecs specs;
+  // Keyed by process id and swap chain address. Kept separate from the swap chain
+  // data, which is discarded for stale swap chains before the recording ends.
+  std::map<std::pair<uint32_t, uint64_t>, SwapChainLatencyHistograms> mLatencyHistograms;
+  bool mLatencyHistogramsChanged = false;
+  // Keyed by application process id and compositor
+  std::map<std::pair<uint32_t, std::string>, VRFrameTimingSummary> mVRFrameTimingSummaries;
+  bool mVRFrameTimingSummariesChanged = false;
 };
 
 void EtwConsumingThread(const CommandLineArgs& args, const SystemSpecs& specs);
@@ -86,6 +95,13 @@ void PresentMon_Update(PresentMonData& pm,
 void PresentMon_Shutdown(PresentMonData& pm, uint32_t totalEventsLost, 
   uint32_t totalBuffersLost);
 
+// Returns a copy of the latency histograms of the current (or last) recording.
+// Safe to call from any thread.
+std::vector<SwapChainLatencyHistograms> GetLatencyHistograms();
+// Returns a copy of the VR frame timing summaries of the current (or last) recording.
+// Safe to call from any thread.
+std::vector<VRFrameTimingSummary> GetVRFrameTimingSummaries();
+
 bool EtwThreadsShouldQuit();
 void PostStopRecording();
 void PostQuitProcess();
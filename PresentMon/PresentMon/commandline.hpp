@@ -27,6 +27,7 @@ SOFTWARE.
 #include <vector>
 
 #include "../Commons/Config/Config.h"
+#include "SystemSpecs.hpp"
 
 //  Target:           mTargetProcessName mTargetPid mEtlFileName
 //  All processes    nullptr            0          nullptr
@@ -48,26 +49,6 @@ enum class CompositorInfo {
   OculusVR
 };
 
-struct GPU
-{
-  std::string name;
-  int coreClock;
-  int memoryClock;
-  int totalMemory;
-};
-
-struct SystemSpecs
-{
-  std::string motherboard;
-  std::string os;
-  std::string cpu;
-  std::string ram;
-  std::string driverVersionBasic;
-  std::string driverVersionDetail;
-  int gpuCount;
-  std::vector<GPU> gpus;
-};
-
 struct CommandLineArgs {
   std::vector<const char*> mTargetProcessNames;
   std::vector<std::string> mDenyList;
@@ -0,0 +1,81 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "ChangePointDetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+const uint32_t ChangePointDetector::warmupFrames_ = 60;
+const double ChangePointDetector::minSegmentMs_ = 5000.0;
+const double ChangePointDetector::slack_ = 0.5;
+const double ChangePointDetector::threshold_ = 30.0;
+const double ChangePointDetector::maxDeviation_ = 3.0;
+const double ChangePointDetector::minStdDev_ = 0.05;
+
+bool ChangePointDetector::AddFrameTime(double ms)
+{
+  if (ms <= 0.0) {
+    return false;
+  }
+
+  const double value = std::log(ms);
+  segmentMs_ += ms;
+
+  if (frameCount_ >= warmupFrames_) {
+    const double stdDev = std::max(std::sqrt(m2_ / (frameCount_ - 1)), minStdDev_);
+    const double z = std::min(std::max((value - mean_) / stdDev, -maxDeviation_), maxDeviation_);
+    positiveSum_ = std::max(0.0, positiveSum_ + z - slack_);
+    negativeSum_ = std::max(0.0, negativeSum_ - z - slack_);
+
+    if (positiveSum_ > threshold_ || negativeSum_ > threshold_) {
+      if (segmentMs_ >= minSegmentMs_) {
+        // the new segment starts with this frame
+        Reset();
+        frameCount_ = 1;
+        mean_ = value;
+        segmentMs_ = ms;
+        return true;
+      }
+      positiveSum_ = 0.0;
+      negativeSum_ = 0.0;
+    }
+  }
+
+  // Welford's running mean and variance of the current segment
+  frameCount_++;
+  const double delta = value - mean_;
+  mean_ += delta / frameCount_;
+  m2_ += delta * (value - mean_);
+  return false;
+}
+
+void ChangePointDetector::Reset()
+{
+  frameCount_ = 0;
+  segmentMs_ = 0.0;
+  mean_ = 0.0;
+  m2_ = 0.0;
+  positiveSum_ = 0.0;
+  negativeSum_ = 0.0;
+}
@@ -0,0 +1,59 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include <cstdint>
+
+// Online change-point detection on the frame time series of a single process.
+// Runs a two-sided CUSUM on the logarithm of the frame time, standardized by the
+// running mean and deviation of the current segment. Large single-frame spikes are
+// clamped so that only sustained shifts in performance start a new segment.
+// Memory usage is constant regardless of capture length.
+class ChangePointDetector {
+ public:
+  // Returns true if the frame starts a new performance regime.
+  bool AddFrameTime(double ms);
+  void Reset();
+
+ private:
+  // Frames used to establish the statistics of a new segment before detecting
+  static const uint32_t warmupFrames_;
+  // Minimum duration of a segment to avoid splitting on short transitions
+  static const double minSegmentMs_;
+  // Allowed drift in deviations per frame before the sums accumulate
+  static const double slack_;
+  // Decision threshold of the cumulative sums
+  static const double threshold_;
+  // Maximum contribution of a single frame in deviations
+  static const double maxDeviation_;
+  // Lower bound of the deviation of log frame times (~5%)
+  static const double minStdDev_;
+
+  uint32_t frameCount_ = 0;
+  double segmentMs_ = 0.0;
+  double mean_ = 0.0;
+  double m2_ = 0.0;
+  double positiveSum_ = 0.0;
+  double negativeSum_ = 0.0;
+};
@@ -191,6 +191,7 @@ void PresentMonInterface::StopRecording(bool audioCue)
     {
       StopEtwThreads(&args_);
     }
+    recording_.SetVRFrameTimingSummaries(GetVRFrameTimingSummaries());
     recording_.Stop();
     if (audioCue)
     {
@@ -209,6 +210,23 @@ const std::wstring PresentMonInterface::GetRecordedProcess()
   return L"";
 }
 
+std::vector<SwapChainLatencyHistograms> PresentMonInterface::GetLatencyHistograms()
+{
+  return ::GetLatencyHistograms();
+}
+
+std::vector<SummaryRecord> PresentMonInterface::QuerySummaries(const SummaryQuery& query)
+{
+  std::lock_guard<std::mutex> lock(g_RecordingMutex);
+  SummaryStore store(recording_.GetDirectory());
+  return store.Query(query);
+}
+
+bool PresentMonInterface::ExportSummaries(const std::wstring& filePath, const SummaryQuery& query)
+{
+  return SummaryStore::ExportCsv(filePath, QuerySummaries(query));
+}
+
 bool PresentMonInterface::CurrentlyRecording()
 {
   return EtwThreadsRunning();
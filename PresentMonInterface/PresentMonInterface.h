@@ -26,6 +26,7 @@ SOFTWARE.
 #include "Config/DenyList.h"
 
 #include "../PresentMon/PresentMon/commandline.hpp"
+#include "../PresentMon/PresentData/LatencyHistogram.hpp"
 
 #include <windows.h>
 #include <string>
@@ -43,6 +44,12 @@ public:
   int GetPresentMonRecordingStopMessage();
   void UpdateOutputFolder(const std::wstring& outputFolder);
   void UpdateUserNote(const std::wstring& userNote);
+  // Per swap chain present-to-display latency histograms of the running recording
+  std::vector<SwapChainLatencyHistograms> GetLatencyHistograms();
+  // Summaries of past recordings in the output folder, read from the summary store
+  std::vector<SummaryRecord> QuerySummaries(const SummaryQuery& query);
+  // Writes the matching summaries in the layout of perf_summary.csv
+  bool ExportSummaries(const std::wstring& filePath, const SummaryQuery& query);
 
 private:
   void StartRecording(bool recordAllProcesses, unsigned int timer, bool audioCue);
@@ -46,6 +46,7 @@
 #include "GPUDetect.h"
 
 const std::wstring Recording::defaultProcessName_ = L"*";
+const size_t Recording::maxSegments_ = 256;
 
 Recording::Recording() { PopulateSystemSpecs(); }
 Recording::~Recording() {}
@@ -484,6 +485,7 @@ void Recording::Start()
   recording_ = true;
   processName_ = defaultProcessName_;
   accumulatedResultsPerProcess_.clear();
+  vrFrameTimingSummaries_.clear();
 
   if (recordAllProcesses_) {
     g_messageLog.LogInfo("Recording", "Capturing all processes");
@@ -505,6 +507,8 @@ void Recording::Start()
 void Recording::Stop()
 {
   PrintSummary();
+  PrintDistribution();
+  PrintVRSummary();
   recording_ = false;
   processName_.clear();
   processID_ = 0;
@@ -524,6 +528,11 @@ const std::wstring& Recording::GetDirectory() { return directory_; }
 
 void Recording::SetUserNote(const std::wstring& userNote) { userNote_ = userNote; }
 
+void Recording::SetVRFrameTimingSummaries(const std::vector<VRFrameTimingSummary>& summaries)
+{
+  vrFrameTimingSummaries_ = summaries;
+}
+
 DWORD Recording::GetProcessFromWindow()
 {
   const auto window = GetForegroundWindow();
@@ -649,6 +658,7 @@ void Recording::AddPresent(const std::wstring& fileName, const std::wstring& pro
   if (it == accumulatedResultsPerProcess_.end()) {
     AccumulatedResults input = {};
     input.startTime = FormatCurrentTime();
+    input.startTimestamp = static_cast<int64_t>(time(nullptr));
     input.processName = processName;
     input.width = width;
     input.height = height;
@@ -676,40 +686,62 @@ void Recording::AddPresent(const std::wstring& fileName, const std::wstring& pro
   }
   accInput = &it->second;
 
+  double frameTime = 0;
   if (msBetweenPresents > 0) {
-    accInput->frameTimes.push_back(msBetweenPresents);
+    frameTime = msBetweenPresents;
+    accInput->frameTimes.push_back(frameTime);
   }
   else if (accInput->timeInSeconds > 0 && timeInSeconds > 0) {
-    accInput->frameTimes.push_back(1000 * (timeInSeconds - accInput->timeInSeconds));
+    frameTime = 1000 * (timeInSeconds - accInput->timeInSeconds);
+    accInput->frameTimes.push_back(frameTime);
   }
 
   if (timeInSeconds > 0) accInput->timeInSeconds = timeInSeconds;
 
   accInput->estimatedDriverLag += estimatedDriverLag;
 
-  switch (frameInfo) {
-    case PresentFrameInfo::COMPOSITOR_APP_WARP: {
-      accInput->app.UpdateFrameStats(true);
-      accInput->warp.UpdateFrameStats(true);
-      return;
-    }
-    case PresentFrameInfo::COMPOSITOR_APPMISS_WARP: {
-      accInput->app.UpdateFrameStats(false);
-      accInput->warp.UpdateFrameStats(true);
-      return;
-    }
-    case PresentFrameInfo::COMPOSITOR_APP_WARPMISS: {
-      accInput->app.UpdateFrameStats(true);
-      accInput->warp.UpdateFrameStats(false);
-      return;
+  const bool appPresented = frameInfo == PresentFrameInfo::COMPOSITOR_APP_WARP ||
+                            frameInfo == PresentFrameInfo::COMPOSITOR_APP_WARPMISS;
+  const bool warpPresented = frameInfo == PresentFrameInfo::COMPOSITOR_APP_WARP ||
+                             frameInfo == PresentFrameInfo::COMPOSITOR_APPMISS_WARP;
+  accInput->app.UpdateFrameStats(appPresented);
+  accInput->warp.UpdateFrameStats(warpPresented);
+
+  AddFrameToSegment(*accInput, timeInSeconds, frameTime, estimatedDriverLag, appPresented,
+                    warpPresented);
+}
+
+void Recording::AddFrameToSegment(AccumulatedResults& input, double timeInSeconds,
+                                  double frameTime, double estimatedDriverLag, bool appPresented,
+                                  bool warpPresented)
+{
+  const bool changePoint = frameTime > 0 && input.changePointDetector.AddFrameTime(frameTime);
+
+  if (input.segments.empty() || (changePoint && input.segments.size() < maxSegments_)) {
+    Segment segment;
+    if (input.segments.empty()) {
+      segment.startTime = std::max(0.0, timeInSeconds - frameTime / 1000.0);
     }
-    case PresentFrameInfo::COMPOSITOR_APPMISS_WARPMISS: {
-      accInput->app.UpdateFrameStats(false);
-      accInput->warp.UpdateFrameStats(false);
-      return;
+    else {
+      segment.startTime = input.segments.back().endTime;
+      if (input.segments.size() + 1 == maxSegments_) {
+        g_messageLog.LogWarning("Recording",
+                                L"Maximum number of performance segments reached for " +
+                                    input.processName);
+      }
     }
+    input.segments.push_back(segment);
+  }
+
+  Segment& segment = input.segments.back();
+  if (frameTime > 0) {
+    segment.frameTimes.Add(frameTime);
+    segment.sumSquaredFrameTimes += frameTime * frameTime;
   }
-  return;
+  if (timeInSeconds > 0) segment.endTime = timeInSeconds;
+  segment.estimatedDriverLag += estimatedDriverLag;
+  segment.app.UpdateFrameStats(appPresented);
+  segment.warp.UpdateFrameStats(warpPresented);
 }
 
 std::string Recording::FormatCurrentTime()
@@ -776,27 +808,11 @@ double calcStdDev(const std::vector<double>& sortedData, double mean)
   return sqrt(squaredDiffsSum / size);
 }
 
-struct Statistics {
-  double minimum;
-  double maximum;
-  double mean;
-  double stdDev;
-  double median;
-  double percentile01;
-  double percentile1;
-  double percentile5;
-  double percentile25;
-  double percentile75;
-  double percentile95;
-  double percentile99;
-  double percentile999;
-};
-
 Statistics calcStats(const std::vector<double>& data)
 {
   const size_t size = data.size();
   if (size < 2) {
-    return {-1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0};  // throw instead?
+    return Statistics();
   }
 
   std::vector<double> sortedData(data);
@@ -819,6 +835,30 @@ Statistics calcStats(const std::vector<double>& data)
   return stats;
 }
 
+Statistics calcStats(const LatencyHistogram& histogram, double sumSquared)
+{
+  if (histogram.mTotalCount < 2) {
+    return Statistics();
+  }
+
+  Statistics stats;
+  stats.minimum = histogram.mMinMs;
+  stats.maximum = histogram.mMaxMs;
+  stats.mean = histogram.GetMean();
+  stats.stdDev =
+      sqrt(std::max(0.0, sumSquared / histogram.mTotalCount - stats.mean * stats.mean));
+  stats.median = histogram.GetPercentile(50);
+  stats.percentile01 = histogram.GetPercentile(0.1);
+  stats.percentile1 = histogram.GetPercentile(1);
+  stats.percentile5 = histogram.GetPercentile(5);
+  stats.percentile25 = histogram.GetPercentile(25);
+  stats.percentile75 = histogram.GetPercentile(75);
+  stats.percentile95 = histogram.GetPercentile(95);
+  stats.percentile99 = histogram.GetPercentile(99);
+  stats.percentile999 = histogram.GetPercentile(99.9);
+  return stats;
+}
+
 void Recording::PrintSummary()
 {
   if (accumulatedResultsPerProcess_.size() == 0) {
@@ -842,72 +882,214 @@ void Recording::PrintSummary()
   // If newly created, append header:
   if (!summaryFileExisted) {
     std::string bom_utf8 = "\xef\xbb\xbf";
-    summaryFile << bom_utf8;
-    std::string header =
-        "File,Application Name,Compositor,Date and Time,Average FPS (Application),"
-        "Average frame time (ms) (Application),"
-        "Minimum frame time (ms) (Application),"
-        "Maximum frame time (ms) (Application),"
-        "Median frame time (ms) (Application),"
-        "Standard deviation of frame time (ms) (Application),"
-        "0.1st-percentile frame time (ms) (Application),"
-        "1st-percentile frame time (ms) (Application),"
-        "5th-percentile frame time (ms) (Application),"
-        "25th-percentile frame time (ms) (Application),"
-        "75th-percentile frame time (ms) (Application),"
-        "95th-percentile frame time (ms) (Application),"
-        "99th-percentile frame time (ms) (Application),"
-        "99.9th-percentile frame time (ms) (Application),"
-        "Missed frames (Application),Average number of missed frames (Application),"
-        "Maximum number of consecutive missed frames (Application),Missed frames (Compositor),"
-        "Average number of missed frames (Compositor),Maximum number of consecutive missed frames "
-        "(Compositor),"
-        "Average Estimated Driver Lag (ms),Width,Height,User Note,"
-        "Motherboard,OS,Processor,System RAM,Base Driver Version,Driver Package,"
-        "GPU #,GPU,GPU Core Clock (MHz),GPU Memory Clock (MHz),GPU Memory (MB)\n";
-    summaryFile << header;
+    summaryFile << bom_utf8 << SummaryStore::GetCsvHeader();
   }
 
+  SummaryStore store(directory_);
+  auto printRow = [&](const SummaryRecord& record) {
+    summaryFile << SummaryStore::FormatCsvLine(record);
+    if (!store.Append(record)) {
+      g_messageLog.LogWarning("Recording", "Failed adding summary to the summary store.");
+    }
+  };
+
+  SummaryRecord base;
+  base.userNote = ConvertUTF16StringToUTF8String(userNote_);
+  base.specs = specs_;
+
   for (auto& item : accumulatedResultsPerProcess_) {
-    std::stringstream line;
     AccumulatedResults& input = item.second;
 
-    Statistics frameStats = calcStats(input.frameTimes);
+    SummaryRecord row = base;
+    row.timestamp = input.startTimestamp;
+    row.file = ConvertUTF16StringToUTF8String(item.first);
+    row.application = ConvertUTF16StringToUTF8String(input.processName);
+    row.compositor = input.compositor;
+    row.startTime = input.startTime;
+    row.width = input.width;
+    row.height = input.height;
+    row.frameStats = calcStats(input.frameTimes);
+    row.avgFPS = input.frameTimes.size() / input.timeInSeconds;
+    row.avgFrameTime = (input.timeInSeconds * 1000.0) / input.frameTimes.size();
+    row.appMissed = input.app.totalMissed;
+    row.avgMissedFramesApp = static_cast<double>(input.app.totalMissed) /
+                             (input.frameTimes.size() + input.app.totalMissed);
+    row.appMaxConsecutiveMissed = input.app.maxConsecutiveMissed;
+    row.warpMissed = input.warp.totalMissed;
+    row.avgMissedFramesCompositor = static_cast<double>(input.warp.totalMissed) /
+                                    (input.frameTimes.size() + input.warp.totalMissed);
+    row.warpMaxConsecutiveMissed = input.warp.maxConsecutiveMissed;
+    row.avgEstimatedDriverLag = (input.estimatedDriverLag) / input.frameTimes.size();
+    printRow(row);
+
+    // One additional row per detected performance regime, if the recording was split
+    if (input.segments.size() < 2) {
+      continue;
+    }
 
-    double avgFPS = input.frameTimes.size() / input.timeInSeconds;
-    double avgFrameTime = (input.timeInSeconds * 1000.0) / input.frameTimes.size();
-    double avgMissedFramesApp = static_cast<double>(input.app.totalMissed) /
-                                (input.frameTimes.size() + input.app.totalMissed);
-    double avgMissedFramesCompositor = static_cast<double>(input.warp.totalMissed) /
-                                       (input.frameTimes.size() + input.warp.totalMissed);
-    double avgEstimatedDriverLag = (input.estimatedDriverLag) / input.frameTimes.size();
+    for (size_t i = 0; i < input.segments.size(); i++) {
+      const Segment& segment = input.segments[i];
+      const double frameCount = static_cast<double>(segment.frameTimes.mTotalCount);
+      const double durationMs = segment.frameTimes.mSumMs;
+
+      std::stringstream file;
+      file.precision(1);
+      file << row.file << " (segment " << i + 1 << ": " << std::fixed << segment.startTime
+           << "s - " << segment.endTime << "s)";
+
+      SummaryRecord segmentRow = row;
+      segmentRow.file = file.str();
+      segmentRow.frameStats = calcStats(segment.frameTimes, segment.sumSquaredFrameTimes);
+      segmentRow.avgFPS = frameCount / (durationMs / 1000.0);
+      segmentRow.avgFrameTime = durationMs / frameCount;
+      segmentRow.appMissed = segment.app.totalMissed;
+      segmentRow.avgMissedFramesApp =
+          static_cast<double>(segment.app.totalMissed) / (frameCount + segment.app.totalMissed);
+      segmentRow.appMaxConsecutiveMissed = segment.app.maxConsecutiveMissed;
+      segmentRow.warpMissed = segment.warp.totalMissed;
+      segmentRow.avgMissedFramesCompositor =
+          static_cast<double>(segment.warp.totalMissed) / (frameCount + segment.warp.totalMissed);
+      segmentRow.warpMaxConsecutiveMissed = segment.warp.maxConsecutiveMissed;
+      segmentRow.avgEstimatedDriverLag = segment.estimatedDriverLag / frameCount;
+      printRow(segmentRow);
+    }
+  }
 
-    line.precision(1);
+  summaryFile.close();
+}
+
+void Recording::PrintDistribution()
+{
+  if (accumulatedResultsPerProcess_.size() == 0) {
+    return;
+  }
 
-    line << ConvertUTF16StringToUTF8String(item.first) << ","
-         << ConvertUTF16StringToUTF8String(input.processName) << "," << input.compositor << ","
-         << input.startTime << "," << std::fixed << avgFPS << "," << avgFrameTime << ","
-         << frameStats.minimum << "," << frameStats.maximum << "," << frameStats.median << ","
-         << frameStats.stdDev << "," << frameStats.percentile01 << "," << frameStats.percentile1
-         << "," << frameStats.percentile5 << "," << frameStats.percentile25 << ","
-         << frameStats.percentile75 << "," << frameStats.percentile95 << ","
-         << frameStats.percentile99 << "," << frameStats.percentile999 << ","
-         << input.app.totalMissed << "," << avgMissedFramesApp << ","
-         << input.app.maxConsecutiveMissed << "," << input.warp.totalMissed << ","
-         << avgMissedFramesCompositor << "," << input.warp.maxConsecutiveMissed << ","
-         << avgEstimatedDriverLag << "," << input.width << "," << input.height << ","
-         << ConvertUTF16StringToUTF8String(userNote_) << "," << specs_.motherboard << ","
-         << specs_.os << "," << specs_.cpu << "," << specs_.ram << "," << specs_.driverVersionBasic
-         << "," << specs_.driverVersionDetail << "," << specs_.gpuCount;
-
-    for (int i = 0; i < specs_.gpuCount; i++) {
-      line << "," << specs_.gpus[i].name << "," << specs_.gpus[i].coreClock << ","
-           << ((specs_.gpus[i].memoryClock > 0) ? std::to_string(specs_.gpus[i].memoryClock) : "-")
-           << "," << specs_.gpus[i].totalMemory;
+  std::wstring distributionFilePath = directory_ + L"perf_distribution.csv";
+  bool distributionFileExisted = FileExists(distributionFilePath);
+
+  std::ofstream distributionFile(distributionFilePath, std::ofstream::app);
+  if (distributionFile.fail()) {
+    g_messageLog.LogError("Recording",
+                          "Can't open distribution file. Either it is open in another process or "
+                          "OCAT is missing write permissions.");
+    return;
+  }
+
+  if (!distributionFileExisted) {
+    std::string bom_utf8 = "\xef\xbb\xbf";
+    distributionFile << bom_utf8;
+    std::string header =
+        "File,Application Name,Compositor,Date and Time,Bucket,Bucket start (ms),"
+        "Bucket end (ms),Frames,Cumulative fraction\n";
+    distributionFile << header;
+  }
+
+  for (const auto& item : accumulatedResultsPerProcess_) {
+    const AccumulatedResults& input = item.second;
+
+    // The segments cover the whole recording, their histograms add up to the distribution
+    // of all frame times.
+    LatencyHistogram frameTimes;
+    for (const Segment& segment : input.segments) {
+      frameTimes.Merge(segment.frameTimes);
+    }
+    if (frameTimes.mTotalCount == 0) {
+      continue;
+    }
+
+    const std::string prefix = ConvertUTF16StringToUTF8String(item.first) + "," +
+                               ConvertUTF16StringToUTF8String(input.processName) + "," +
+                               input.compositor + "," + input.startTime + ",";
+
+    // Only non-empty buckets are written. Bucket boundaries don't depend on the recording,
+    // so distributions of several runs can be merged by adding the frames per bucket.
+    std::stringstream lines;
+    uint64_t cumulative = 0;
+    for (uint32_t i = 0; i < LatencyHistogram::BUCKET_COUNT; i++) {
+      if (frameTimes.mCounts[i] == 0) {
+        continue;
+      }
+      cumulative += frameTimes.mCounts[i];
+      lines.precision(4);
+      lines << prefix << i << "," << std::fixed << LatencyHistogram::GetBucketLowerBound(i)
+            << ",";
+      if (i + 1 < LatencyHistogram::BUCKET_COUNT) {
+        lines << LatencyHistogram::GetBucketUpperBound(i);
+      }
+      else {
+        lines << "-";
+      }
+      lines.precision(6);
+      lines << "," << frameTimes.mCounts[i] << ","
+            << static_cast<double>(cumulative) / frameTimes.mTotalCount << std::endl;
+    }
+    distributionFile << lines.str();
+  }
+
+  distributionFile.close();
+}
+
+void Recording::PrintVRSummary()
+{
+  if (vrFrameTimingSummaries_.empty()) {
+    return;
+  }
+
+  std::wstring summaryFilePath = directory_ + L"perf_summary_vr.csv";
+  bool summaryFileExisted = FileExists(summaryFilePath);
+
+  std::ofstream summaryFile(summaryFilePath, std::ofstream::app);
+  if (summaryFile.fail()) {
+    g_messageLog.LogError("Recording",
+                          "Can't open VR summary file. Either it is open in another process or "
+                          "OCAT is missing write permissions.");
+    return;
+  }
+
+  if (!summaryFileExisted) {
+    std::string bom_utf8 = "\xef\xbb\xbf";
+    summaryFile << bom_utf8;
+    std::string header =
+        "File,Application Name,Compositor,Date and Time,Compositor frames,Application frames,"
+        "Missed frames (Application) (%),Reprojected frames (%),Missed frames (Compositor) (%),"
+        "Median compositor GPU time (ms),95th-percentile compositor GPU time (ms),"
+        "99th-percentile compositor GPU time (ms),Maximum compositor GPU time (ms),"
+        "Median motion-to-photon latency (ms),95th-percentile motion-to-photon latency (ms),"
+        "99th-percentile motion-to-photon latency (ms),User Note\n";
+    summaryFile << header;
+  }
+
+  // -1 marks timings which were not available for this compositor
+  auto printPercentiles = [](std::stringstream& line, const LatencyHistogram& histogram,
+                             std::initializer_list<double> percentiles) {
+    for (double percentile : percentiles) {
+      line << "," << (histogram.mTotalCount ? histogram.GetPercentile(percentile) : -1.0);
     }
+  };
+
+  for (const auto& summary : vrFrameTimingSummaries_) {
+    // Use the start time of the regular summary row of the same file
+    const auto it = accumulatedResultsPerProcess_.find(summary.mFileName);
+    const std::string startTime =
+        (it != accumulatedResultsPerProcess_.end()) ? it->second.startTime : FormatCurrentTime();
 
-    line << std::endl;
+    // percentage, or the -1 of an untracked rate as is
+    const double appMissedRate = summary.GetAppMissedRate();
 
+    std::stringstream line;
+    line.precision(1);
+    line << ConvertUTF16StringToUTF8String(summary.mFileName) << ","
+         << ConvertUTF16StringToUTF8String(summary.mProcessName) << "," << summary.mCompositor
+         << "," << startTime << "," << summary.mCompositorFrameCount << ","
+         << summary.mAppFrameCount << "," << std::fixed
+         << (appMissedRate < 0.0 ? appMissedRate : appMissedRate * 100.0)
+         << "," << summary.GetReprojectionRate() * 100.0 << ","
+         << summary.GetCompositorMissedRate() * 100.0;
+    printPercentiles(line, summary.mCompositorGpuTime, {50, 95, 99});
+    line << ","
+         << (summary.mCompositorGpuTime.mTotalCount ? summary.mCompositorGpuTime.mMaxMs : -1.0);
+    printPercentiles(line, summary.mMotionToPhoton, {50, 95, 99});
+    line << "," << ConvertUTF16StringToUTF8String(userNote_) << std::endl;
     summaryFile << line.str();
   }
 
@@ -27,8 +27,12 @@
 #include <vector>
 #include <unordered_map>
 
+#include "ChangePointDetector.h"
+#include "SummaryStore.h"
 #include "Utility/ProcessHelper.h"
 #include "../PresentMon/PresentMon/commandline.hpp"
+#include "../PresentMon/PresentData/LatencyHistogram.hpp"
+#include "../PresentMon/PresentData/VRFrameTimingSummary.hpp"
 
 // Handles process selection for recording
 // State of the current Recording
@@ -56,6 +60,8 @@ public:
   static std::string FormatCurrentTime();
 
   void SetUserNote(const std::wstring& userNote);
+  // VR frame timing of the recording, written to perf_summary_vr.csv when it stops
+  void SetVRFrameTimingSummaries(const std::vector<VRFrameTimingSummary>& summaries);
 
   SystemSpecs GetSpecs() { return specs_; }
 
@@ -68,6 +74,18 @@ private:
     void UpdateFrameStats(bool presented);
   };
 
+  // Part of a recording with consistent performance, as found by the ChangePointDetector.
+  // Frame times are kept in a histogram to bound the memory of long captures.
+  struct Segment {
+    double startTime = 0;
+    double endTime = 0;
+    LatencyHistogram frameTimes;
+    double sumSquaredFrameTimes = 0;
+    double estimatedDriverLag = 0;
+    FrameStats app;
+    FrameStats warp;
+  };
+
   // For use in a map with processName as key
   struct AccumulatedResults {
     std::vector<double> frameTimes;
@@ -76,10 +94,13 @@ private:
     std::wstring processName;
     std::string compositor;
     std::string startTime;
+    int64_t startTimestamp = 0;
     FrameStats app;
     FrameStats warp;
     uint32_t width = 0;
     uint32_t height = 0;
+    ChangePointDetector changePointDetector;
+    std::vector<Segment> segments;
   };
 
   void PopulateSystemSpecs();
@@ -100,12 +121,22 @@ private:
   // Print the summary of the last successful recording.
   // Creates the summary file if it did not already exist.
   void PrintSummary();
+  // Appends the frame time histogram and cumulative distribution of the last recording
+  // to the distribution file.
+  void PrintDistribution();
+  void PrintVRSummary();
+  void AddFrameToSegment(AccumulatedResults& input, double timeInSeconds, double frameTime,
+                         double estimatedDriverLag, bool appPresented, bool warpPresented);
+
+  // Upper bound of segments per process, the last segment covers the rest of the recording
+  static const size_t maxSegments_;
 
   static const std::wstring defaultProcessName_;
 
   SystemSpecs specs_;
 
   std::unordered_map<std::wstring, AccumulatedResults> accumulatedResultsPerProcess_;
+  std::vector<VRFrameTimingSummary> vrFrameTimingSummaries_;
   std::wstring directory_;
   std::wstring processName_;
   std::wstring userNote_;
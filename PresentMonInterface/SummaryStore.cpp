@@ -0,0 +1,468 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "SummaryStore.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "Logging/MessageLog.h"
+
+const uint32_t SummaryStore::dataMagic_ = 0x4D555350;   // "PSUM"
+const uint32_t SummaryStore::indexMagic_ = 0x58444950;  // "PIDX"
+const uint32_t SummaryStore::version_ = 1;
+
+namespace {
+const uint64_t headerSize = 2 * sizeof(uint32_t);
+
+// File streams only take wide paths with MSVC, the tests also build elsewhere
+#ifdef _WIN32
+const std::wstring& NativePath(const std::wstring& path) { return path; }
+#else
+std::string NativePath(const std::wstring& path) { return std::string(path.begin(), path.end()); }
+#endif
+
+class RecordWriter {
+ public:
+  template <typename T>
+  void Write(const T& value)
+  {
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void WriteString(const std::string& value)
+  {
+    Write(static_cast<uint32_t>(value.size()));
+    buffer_.append(value);
+  }
+
+  const std::string& GetBuffer() const { return buffer_; }
+
+ private:
+  std::string buffer_;
+};
+
+class RecordReader {
+ public:
+  explicit RecordReader(const std::string& buffer) : buffer_(buffer) {}
+
+  template <typename T>
+  bool Read(T& value)
+  {
+    if (buffer_.size() - position_ < sizeof(T)) return false;
+    memcpy(&value, buffer_.data() + position_, sizeof(T));
+    position_ += sizeof(T);
+    return true;
+  }
+
+  bool ReadString(std::string& value)
+  {
+    uint32_t size = 0;
+    if (!Read(size) || buffer_.size() - position_ < size) return false;
+    value.assign(buffer_.data() + position_, size);
+    position_ += size;
+    return true;
+  }
+
+ private:
+  const std::string& buffer_;
+  size_t position_ = 0;
+};
+
+std::string Serialize(const SummaryRecord& record)
+{
+  RecordWriter writer;
+  writer.Write(record.timestamp);
+  writer.WriteString(record.file);
+  writer.WriteString(record.application);
+  writer.WriteString(record.compositor);
+  writer.WriteString(record.startTime);
+  writer.Write(record.frameStats);
+  writer.Write(record.avgFPS);
+  writer.Write(record.avgFrameTime);
+  writer.Write(record.appMissed);
+  writer.Write(record.avgMissedFramesApp);
+  writer.Write(record.appMaxConsecutiveMissed);
+  writer.Write(record.warpMissed);
+  writer.Write(record.avgMissedFramesCompositor);
+  writer.Write(record.warpMaxConsecutiveMissed);
+  writer.Write(record.avgEstimatedDriverLag);
+  writer.Write(record.width);
+  writer.Write(record.height);
+  writer.WriteString(record.userNote);
+  writer.WriteString(record.specs.motherboard);
+  writer.WriteString(record.specs.os);
+  writer.WriteString(record.specs.cpu);
+  writer.WriteString(record.specs.ram);
+  writer.WriteString(record.specs.driverVersionBasic);
+  writer.WriteString(record.specs.driverVersionDetail);
+  writer.Write(static_cast<int32_t>(record.specs.gpus.size()));
+  for (const auto& gpu : record.specs.gpus) {
+    writer.WriteString(gpu.name);
+    writer.Write(static_cast<int32_t>(gpu.coreClock));
+    writer.Write(static_cast<int32_t>(gpu.memoryClock));
+    writer.Write(static_cast<int32_t>(gpu.totalMemory));
+  }
+  return writer.GetBuffer();
+}
+
+bool Deserialize(const std::string& buffer, SummaryRecord& record)
+{
+  RecordReader reader(buffer);
+  int32_t gpuCount = 0;
+  bool valid = reader.Read(record.timestamp) && reader.ReadString(record.file) &&
+               reader.ReadString(record.application) && reader.ReadString(record.compositor) &&
+               reader.ReadString(record.startTime) && reader.Read(record.frameStats) &&
+               reader.Read(record.avgFPS) && reader.Read(record.avgFrameTime) &&
+               reader.Read(record.appMissed) && reader.Read(record.avgMissedFramesApp) &&
+               reader.Read(record.appMaxConsecutiveMissed) && reader.Read(record.warpMissed) &&
+               reader.Read(record.avgMissedFramesCompositor) &&
+               reader.Read(record.warpMaxConsecutiveMissed) &&
+               reader.Read(record.avgEstimatedDriverLag) && reader.Read(record.width) &&
+               reader.Read(record.height) && reader.ReadString(record.userNote) &&
+               reader.ReadString(record.specs.motherboard) && reader.ReadString(record.specs.os) &&
+               reader.ReadString(record.specs.cpu) && reader.ReadString(record.specs.ram) &&
+               reader.ReadString(record.specs.driverVersionBasic) &&
+               reader.ReadString(record.specs.driverVersionDetail) && reader.Read(gpuCount);
+  if (!valid || gpuCount < 0) {
+    return false;
+  }
+
+  record.specs.gpuCount = gpuCount;
+  record.specs.gpus.resize(gpuCount);
+  for (auto& gpu : record.specs.gpus) {
+    int32_t coreClock = 0;
+    int32_t memoryClock = 0;
+    int32_t totalMemory = 0;
+    if (!reader.ReadString(gpu.name) || !reader.Read(coreClock) || !reader.Read(memoryClock) ||
+        !reader.Read(totalMemory)) {
+      return false;
+    }
+    gpu.coreClock = coreClock;
+    gpu.memoryClock = memoryClock;
+    gpu.totalMemory = totalMemory;
+  }
+  return true;
+}
+
+bool EqualsIgnoreCase(const std::string& a, const std::string& b)
+{
+  return a.size() == b.size() &&
+         std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return std::tolower(static_cast<unsigned char>(x)) ==
+                  std::tolower(static_cast<unsigned char>(y));
+         });
+}
+
+const std::string& GetFirstGPU(const SummaryRecord& record)
+{
+  static const std::string none;
+  return record.specs.gpus.empty() ? none : record.specs.gpus[0].name;
+}
+}  // namespace
+
+SummaryStore::SummaryStore(const std::wstring& directory)
+    : dataFilePath_(directory + L"perf_summary.bin"),
+      indexFilePath_(directory + L"perf_summary.idx")
+{
+  indexLoaded_ = LoadIndex();
+}
+
+uint32_t SummaryStore::Hash(const std::string& text)
+{
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  for (char c : text) {
+    hash ^= static_cast<uint32_t>(std::tolower(static_cast<unsigned char>(c)));
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+SummaryStore::IndexEntry SummaryStore::CreateIndexEntry(const SummaryRecord& record,
+                                                        uint64_t offset, uint32_t size)
+{
+  IndexEntry entry = {};
+  entry.timestamp = record.timestamp;
+  entry.offset = offset;
+  entry.size = size;
+  entry.applicationHash = Hash(record.application);
+  entry.gpuHash = Hash(GetFirstGPU(record));
+  return entry;
+}
+
+bool SummaryStore::LoadIndex()
+{
+  index_.clear();
+
+  std::ifstream dataFile(NativePath(dataFilePath_), std::ios::binary | std::ios::ate);
+  if (!dataFile.is_open()) {
+    // Nothing stored yet
+    return true;
+  }
+  const uint64_t dataSize = static_cast<uint64_t>(dataFile.tellg());
+  if (dataSize == 0) {
+    return true;
+  }
+
+  uint32_t dataMagic = 0;
+  uint32_t dataVersion = 0;
+  dataFile.seekg(0);
+  dataFile.read(reinterpret_cast<char*>(&dataMagic), sizeof(dataMagic));
+  dataFile.read(reinterpret_cast<char*>(&dataVersion), sizeof(dataVersion));
+  if (!dataFile.good() || dataMagic != dataMagic_ || dataVersion != version_) {
+    // Don't append to a file of another format or version
+    g_messageLog.LogError("SummaryStore", L"Unknown format of summary store " + dataFilePath_);
+    return false;
+  }
+
+  std::ifstream indexFile(NativePath(indexFilePath_), std::ios::binary | std::ios::ate);
+  if (indexFile.is_open()) {
+    const uint64_t indexSize = static_cast<uint64_t>(indexFile.tellg());
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    indexFile.seekg(0);
+    indexFile.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    indexFile.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (indexFile.good() && magic == indexMagic_ && version == version_ &&
+        indexSize >= headerSize) {
+      index_.resize(static_cast<size_t>((indexSize - headerSize) / sizeof(IndexEntry)));
+      if (!index_.empty()) {
+        indexFile.read(reinterpret_cast<char*>(index_.data()), index_.size() * sizeof(IndexEntry));
+      }
+    }
+    if (!indexFile.good()) {
+      index_.clear();
+    }
+  }
+
+  // Drop index entries which don't refer to the record file
+  uint64_t indexedEnd = headerSize;
+  for (size_t i = 0; i < index_.size(); i++) {
+    const IndexEntry& entry = index_[i];
+    if (entry.offset != indexedEnd || entry.offset + sizeof(uint32_t) + entry.size > dataSize) {
+      g_messageLog.LogWarning("SummaryStore", "Summary index is inconsistent, rebuilding it");
+      index_.resize(i);
+      break;
+    }
+    indexedEnd = entry.offset + sizeof(uint32_t) + entry.size;
+  }
+
+  if (indexedEnd == dataSize && indexFile.is_open() && !index_.empty()) {
+    return true;
+  }
+
+  // Index records which were appended without updating the index
+  bool indexChanged = false;
+  dataFile.seekg(indexedEnd);
+  while (indexedEnd + sizeof(uint32_t) <= dataSize) {
+    uint32_t size = 0;
+    dataFile.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (!dataFile.good() || indexedEnd + sizeof(uint32_t) + size > dataSize) {
+      g_messageLog.LogWarning("SummaryStore", "Summary file contains an incomplete record");
+      break;
+    }
+    std::string buffer(size, '\0');
+    dataFile.read(&buffer[0], size);
+    SummaryRecord record;
+    if (!dataFile.good() || !Deserialize(buffer, record)) {
+      g_messageLog.LogWarning("SummaryStore", "Summary file contains an invalid record");
+      break;
+    }
+    index_.push_back(CreateIndexEntry(record, indexedEnd, size));
+    indexedEnd += sizeof(uint32_t) + size;
+    indexChanged = true;
+  }
+
+  if (indexChanged || !indexFile.is_open()) {
+    indexFile.close();
+    std::ofstream output(NativePath(indexFilePath_), std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char*>(&indexMagic_), sizeof(indexMagic_));
+    output.write(reinterpret_cast<const char*>(&version_), sizeof(version_));
+    if (!index_.empty()) {
+      output.write(reinterpret_cast<const char*>(index_.data()), index_.size() * sizeof(IndexEntry));
+    }
+    if (output.fail()) {
+      g_messageLog.LogError("SummaryStore", L"Can't write summary index " + indexFilePath_);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SummaryStore::ReadRecord(const IndexEntry& entry, SummaryRecord& record)
+{
+  std::ifstream dataFile(NativePath(dataFilePath_), std::ios::binary);
+  dataFile.seekg(entry.offset + sizeof(uint32_t));
+  std::string buffer(entry.size, '\0');
+  dataFile.read(&buffer[0], entry.size);
+  return dataFile.good() && Deserialize(buffer, record);
+}
+
+bool SummaryStore::Append(const SummaryRecord& record)
+{
+  if (!indexLoaded_) {
+    return false;
+  }
+
+  std::ofstream dataFile(NativePath(dataFilePath_), std::ios::binary | std::ios::app);
+  if (dataFile.fail()) {
+    g_messageLog.LogError("SummaryStore", L"Can't open summary store " + dataFilePath_);
+    return false;
+  }
+
+  dataFile.seekp(0, std::ios::end);
+  uint64_t offset = static_cast<uint64_t>(dataFile.tellp());
+  if (offset == 0) {
+    dataFile.write(reinterpret_cast<const char*>(&dataMagic_), sizeof(dataMagic_));
+    dataFile.write(reinterpret_cast<const char*>(&version_), sizeof(version_));
+    offset = headerSize;
+  }
+
+  const std::string buffer = Serialize(record);
+  const uint32_t size = static_cast<uint32_t>(buffer.size());
+  dataFile.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  dataFile.write(buffer.data(), buffer.size());
+  dataFile.close();
+  if (dataFile.fail()) {
+    g_messageLog.LogError("SummaryStore", L"Can't write summary store " + dataFilePath_);
+    return false;
+  }
+
+  const IndexEntry entry = CreateIndexEntry(record, offset, size);
+  std::ofstream indexFile(NativePath(indexFilePath_), std::ios::binary | std::ios::app);
+  indexFile.seekp(0, std::ios::end);
+  if (indexFile.tellp() == 0) {
+    // First record of a new store
+    indexFile.write(reinterpret_cast<const char*>(&indexMagic_), sizeof(indexMagic_));
+    indexFile.write(reinterpret_cast<const char*>(&version_), sizeof(version_));
+  }
+  indexFile.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+  index_.push_back(entry);
+  return !indexFile.fail();
+}
+
+std::vector<SummaryRecord> SummaryStore::Query(const SummaryQuery& query)
+{
+  std::vector<SummaryRecord> records;
+  if (!indexLoaded_) {
+    return records;
+  }
+
+  const uint32_t applicationHash = Hash(query.application);
+  const uint32_t gpuHash = Hash(query.gpu);
+  for (const IndexEntry& entry : index_) {
+    if (entry.timestamp < query.fromTimestamp || entry.timestamp > query.toTimestamp ||
+        (!query.application.empty() && entry.applicationHash != applicationHash) ||
+        (!query.gpu.empty() && entry.gpuHash != gpuHash)) {
+      continue;
+    }
+
+    SummaryRecord record;
+    if (!ReadRecord(entry, record)) {
+      g_messageLog.LogWarning("SummaryStore", "Failed reading summary record");
+      continue;
+    }
+    // Hashes may collide
+    if ((!query.application.empty() && !EqualsIgnoreCase(record.application, query.application)) ||
+        (!query.gpu.empty() && !EqualsIgnoreCase(GetFirstGPU(record), query.gpu))) {
+      continue;
+    }
+    records.push_back(std::move(record));
+  }
+  return records;
+}
+
+std::string SummaryStore::GetCsvHeader()
+{
+  return "File,Application Name,Compositor,Date and Time,Average FPS (Application),"
+         "Average frame time (ms) (Application),"
+         "Minimum frame time (ms) (Application),"
+         "Maximum frame time (ms) (Application),"
+         "Median frame time (ms) (Application),"
+         "Standard deviation of frame time (ms) (Application),"
+         "0.1st-percentile frame time (ms) (Application),"
+         "1st-percentile frame time (ms) (Application),"
+         "5th-percentile frame time (ms) (Application),"
+         "25th-percentile frame time (ms) (Application),"
+         "75th-percentile frame time (ms) (Application),"
+         "95th-percentile frame time (ms) (Application),"
+         "99th-percentile frame time (ms) (Application),"
+         "99.9th-percentile frame time (ms) (Application),"
+         "Missed frames (Application),Average number of missed frames (Application),"
+         "Maximum number of consecutive missed frames (Application),Missed frames (Compositor),"
+         "Average number of missed frames (Compositor),Maximum number of consecutive missed "
+         "frames (Compositor),"
+         "Average Estimated Driver Lag (ms),Width,Height,User Note,"
+         "Motherboard,OS,Processor,System RAM,Base Driver Version,Driver Package,"
+         "GPU #,GPU,GPU Core Clock (MHz),GPU Memory Clock (MHz),GPU Memory (MB)\n";
+}
+
+std::string SummaryStore::FormatCsvLine(const SummaryRecord& record)
+{
+  std::stringstream line;
+  line.precision(1);
+
+  const Statistics& frameStats = record.frameStats;
+  line << record.file << "," << record.application << "," << record.compositor << ","
+       << record.startTime << "," << std::fixed << record.avgFPS << "," << record.avgFrameTime
+       << "," << frameStats.minimum << "," << frameStats.maximum << "," << frameStats.median << ","
+       << frameStats.stdDev << "," << frameStats.percentile01 << "," << frameStats.percentile1
+       << "," << frameStats.percentile5 << "," << frameStats.percentile25 << ","
+       << frameStats.percentile75 << "," << frameStats.percentile95 << ","
+       << frameStats.percentile99 << "," << frameStats.percentile999 << "," << record.appMissed
+       << "," << record.avgMissedFramesApp << "," << record.appMaxConsecutiveMissed << ","
+       << record.warpMissed << "," << record.avgMissedFramesCompositor << ","
+       << record.warpMaxConsecutiveMissed << "," << record.avgEstimatedDriverLag << ","
+       << record.width << "," << record.height << "," << record.userNote << ","
+       << record.specs.motherboard << "," << record.specs.os << "," << record.specs.cpu << ","
+       << record.specs.ram << "," << record.specs.driverVersionBasic << ","
+       << record.specs.driverVersionDetail << "," << record.specs.gpuCount;
+
+  for (const auto& gpu : record.specs.gpus) {
+    line << "," << gpu.name << "," << gpu.coreClock << ","
+         << ((gpu.memoryClock > 0) ? std::to_string(gpu.memoryClock) : "-") << ","
+         << gpu.totalMemory;
+  }
+
+  line << std::endl;
+  return line.str();
+}
+
+bool SummaryStore::ExportCsv(const std::wstring& filePath, const std::vector<SummaryRecord>& records)
+{
+  std::ofstream file(NativePath(filePath), std::ofstream::trunc);
+  if (file.fail()) {
+    g_messageLog.LogError("SummaryStore", L"Can't create summary export " + filePath);
+    return false;
+  }
+
+  file << "\xef\xbb\xbf" << GetCsvHeader();
+  for (const auto& record : records) {
+    file << FormatCsvLine(record);
+  }
+  return !file.fail();
+}
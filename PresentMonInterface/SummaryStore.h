@@ -0,0 +1,126 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../PresentMon/PresentMon/SystemSpecs.hpp"
+
+// -1 marks values which could not be computed, e.g. for fewer than two frames.
+struct Statistics {
+  double minimum = -1.0;
+  double maximum = -1.0;
+  double mean = -1.0;
+  double stdDev = -1.0;
+  double median = -1.0;
+  double percentile01 = -1.0;
+  double percentile1 = -1.0;
+  double percentile5 = -1.0;
+  double percentile25 = -1.0;
+  double percentile75 = -1.0;
+  double percentile95 = -1.0;
+  double percentile99 = -1.0;
+  double percentile999 = -1.0;
+};
+
+// All values of one row of the performance summary.
+struct SummaryRecord {
+  // Seconds since epoch of the first present of the recording
+  int64_t timestamp = 0;
+  std::string file;
+  std::string application;
+  std::string compositor;
+  std::string startTime;
+  Statistics frameStats = {};
+  double avgFPS = 0;
+  double avgFrameTime = 0;
+  uint32_t appMissed = 0;
+  double avgMissedFramesApp = 0;
+  uint32_t appMaxConsecutiveMissed = 0;
+  uint32_t warpMissed = 0;
+  double avgMissedFramesCompositor = 0;
+  uint32_t warpMaxConsecutiveMissed = 0;
+  double avgEstimatedDriverLag = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::string userNote;
+  SystemSpecs specs;
+};
+
+// Empty strings match all records, application and GPU are compared case insensitive.
+struct SummaryQuery {
+  int64_t fromTimestamp = 0;
+  int64_t toTimestamp = std::numeric_limits<int64_t>::max();
+  std::string application;
+  std::string gpu;
+};
+
+// Append-only binary store of summary records.
+// perf_summary.bin holds the serialized records, perf_summary.idx a fixed size entry
+// per record with its timestamp, hashes of application and GPU name and the record
+// location. Queries only scan the index and read the matching records.
+// The index is loaded once per store and rebuilt from the record file if it is missing or
+// incomplete, appends only extend it.
+class SummaryStore {
+ public:
+  explicit SummaryStore(const std::wstring& directory);
+
+  bool Append(const SummaryRecord& record);
+  std::vector<SummaryRecord> Query(const SummaryQuery& query);
+  // Writes the records in the layout of perf_summary.csv
+  static bool ExportCsv(const std::wstring& filePath, const std::vector<SummaryRecord>& records);
+
+  static std::string GetCsvHeader();
+  static std::string FormatCsvLine(const SummaryRecord& record);
+
+ private:
+#pragma pack(push, 1)
+  struct IndexEntry {
+    int64_t timestamp;
+    uint64_t offset;
+    uint32_t size;
+    uint32_t applicationHash;
+    uint32_t gpuHash;
+    uint32_t reserved;
+  };
+#pragma pack(pop)
+
+  bool LoadIndex();
+  bool ReadRecord(const IndexEntry& entry, SummaryRecord& record);
+  static IndexEntry CreateIndexEntry(const SummaryRecord& record, uint64_t offset, uint32_t size);
+  static uint32_t Hash(const std::string& text);
+
+  static const uint32_t dataMagic_;
+  static const uint32_t indexMagic_;
+  static const uint32_t version_;
+
+  std::wstring dataFilePath_;
+  std::wstring indexFilePath_;
+  std::vector<IndexEntry> index_;
+  // false if the files have an unknown format, nothing is appended then
+  bool indexLoaded_ = false;
+};
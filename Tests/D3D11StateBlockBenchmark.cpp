@@ -0,0 +1,90 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+// CPU time of saving and restoring the immediate context around the overlay draw.
+// Windows only, runs on a WARP device.
+// Usage: D3D11StateBlockBenchmark [iterations]
+
+#include "d3d/d3d11_state_block.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using Microsoft::WRL::ComPtr;
+
+int main(int argc, char** argv)
+{
+  const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100000;
+
+  ComPtr<ID3D11Device> device;
+  ComPtr<ID3D11DeviceContext> context;
+  HRESULT hr = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0, nullptr, 0,
+                                 D3D11_SDK_VERSION, &device, nullptr, &context);
+  if (FAILED(hr)) {
+    std::printf("D3D11CreateDevice failed, HRESULT %08lx\n", hr);
+    return 1;
+  }
+
+  D3D11_TEXTURE2D_DESC desc = {};
+  desc.Width = 64;
+  desc.Height = 64;
+  desc.MipLevels = 1;
+  desc.ArraySize = 1;
+  desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+  desc.SampleDesc.Count = 1;
+  desc.Usage = D3D11_USAGE_DEFAULT;
+  desc.BindFlags = D3D11_BIND_RENDER_TARGET;
+  ComPtr<ID3D11Texture2D> textures[3];
+  ComPtr<ID3D11RenderTargetView> targets[3];
+  for (int i = 0; i < 3; ++i) {
+    hr = device->CreateTexture2D(&desc, nullptr, &textures[i]);
+    if (SUCCEEDED(hr)) {
+      hr = device->CreateRenderTargetView(textures[i].Get(), nullptr, &targets[i]);
+    }
+    if (FAILED(hr)) {
+      std::printf("Render target creation failed, HRESULT %08lx\n", hr);
+      return 1;
+    }
+  }
+
+  // application state: two render targets and a viewport, the overlay binds the third target
+  ID3D11RenderTargetView* applicationTargets[] = {targets[0].Get(), targets[1].Get()};
+  ID3D11RenderTargetView* overlayTarget = targets[2].Get();
+  const D3D11_VIEWPORT viewport = {0.0f, 0.0f, 64.0f, 64.0f, 0.0f, 1.0f};
+  context->OMSetRenderTargets(2, applicationTargets, nullptr);
+  context->RSSetViewports(1, &viewport);
+
+  GameOverlay::d3d11_state_block stateBlock;
+  const auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    stateBlock.Capture(context.Get());
+    context->OMSetRenderTargets(1, &overlayTarget, nullptr);
+    context->RSSetViewports(1, &viewport);
+    stateBlock.Restore(context.Get());
+  }
+  const auto end = std::chrono::high_resolution_clock::now();
+  const double microseconds = std::chrono::duration<double, std::micro>(end - start).count();
+  std::printf("Capture and Restore %10.3f us\n", microseconds / iterations);
+  return 0;
+}
@@ -0,0 +1,153 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+// Windows only, runs on a WARP device.
+
+#include "d3d/d3d11_state_block.hpp"
+
+#include <gtest/gtest.h>
+
+using Microsoft::WRL::ComPtr;
+
+namespace {
+
+class D3D11StateBlockTest : public ::testing::Test {
+ protected:
+  void SetUp() override
+  {
+    const HRESULT hr =
+        D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0, nullptr, 0,
+                          D3D11_SDK_VERSION, &device_, nullptr, &context_);
+    ASSERT_TRUE(SUCCEEDED(hr));
+  }
+
+  ComPtr<ID3D11Texture2D> CreateTexture(DXGI_FORMAT format, UINT bindFlags)
+  {
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = 16;
+    desc.Height = 16;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = format;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = bindFlags;
+    ComPtr<ID3D11Texture2D> texture;
+    EXPECT_TRUE(SUCCEEDED(device_->CreateTexture2D(&desc, nullptr, &texture)));
+    return texture;
+  }
+
+  ComPtr<ID3D11RenderTargetView> CreateRenderTarget()
+  {
+    const auto texture = CreateTexture(DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_RENDER_TARGET);
+    ComPtr<ID3D11RenderTargetView> view;
+    EXPECT_TRUE(SUCCEEDED(device_->CreateRenderTargetView(texture.Get(), nullptr, &view)));
+    return view;
+  }
+
+  ComPtr<ID3D11UnorderedAccessView> CreateUnorderedAccessView()
+  {
+    const auto texture = CreateTexture(DXGI_FORMAT_R32_UINT, D3D11_BIND_UNORDERED_ACCESS);
+    ComPtr<ID3D11UnorderedAccessView> view;
+    EXPECT_TRUE(SUCCEEDED(device_->CreateUnorderedAccessView(texture.Get(), nullptr, &view)));
+    return view;
+  }
+
+  // the output merger bindings the overlay draw changes
+  void BindOverlay(ID3D11RenderTargetView* overlayTarget)
+  {
+    context_->OMSetRenderTargets(1, &overlayTarget, nullptr);
+    const D3D11_VIEWPORT viewport = {0.0f, 0.0f, 16.0f, 16.0f, 0.0f, 1.0f};
+    context_->RSSetViewports(1, &viewport);
+  }
+
+  ComPtr<ID3D11Device> device_;
+  ComPtr<ID3D11DeviceContext> context_;
+};
+
+template <typename View, size_t count>
+void Release(View* (&views)[count])
+{
+  for (auto& view : views) {
+    if (view) {
+      view->Release();
+      view = nullptr;
+    }
+  }
+}
+
+}  // namespace
+
+TEST_F(D3D11StateBlockTest, KeepsUnorderedAccessViewsBehindTheRenderTargets)
+{
+  const auto target0 = CreateRenderTarget();
+  const auto target1 = CreateRenderTarget();
+  const auto unorderedAccessView = CreateUnorderedAccessView();
+  const auto overlayTarget = CreateRenderTarget();
+
+  ID3D11RenderTargetView* targets[] = {target0.Get(), target1.Get()};
+  ID3D11UnorderedAccessView* views[] = {unorderedAccessView.Get()};
+  context_->OMSetRenderTargetsAndUnorderedAccessViews(2, targets, nullptr, 2, 1, views, nullptr);
+
+  GameOverlay::d3d11_state_block stateBlock;
+  stateBlock.Capture(context_.Get());
+  BindOverlay(overlayTarget.Get());
+  stateBlock.Restore(context_.Get());
+
+  ID3D11RenderTargetView* restoredTargets[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT] = {};
+  ID3D11UnorderedAccessView* restoredViews[D3D11_PS_CS_UAV_REGISTER_COUNT] = {};
+  context_->OMGetRenderTargetsAndUnorderedAccessViews(
+      D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT, restoredTargets, nullptr, 0,
+      D3D11_PS_CS_UAV_REGISTER_COUNT, restoredViews);
+  EXPECT_EQ(target0.Get(), restoredTargets[0]);
+  EXPECT_EQ(target1.Get(), restoredTargets[1]);
+  EXPECT_EQ(nullptr, restoredTargets[2]);
+  EXPECT_EQ(unorderedAccessView.Get(), restoredViews[2]);
+  Release(restoredTargets);
+  Release(restoredViews);
+}
+
+TEST_F(D3D11StateBlockTest, RestoresEmptyOutputMergerAndViewports)
+{
+  const auto overlayTarget = CreateRenderTarget();
+  const D3D11_VIEWPORT viewports[] = {{0.0f, 0.0f, 8.0f, 8.0f, 0.0f, 1.0f},
+                                      {8.0f, 0.0f, 8.0f, 8.0f, 0.0f, 1.0f}};
+  context_->RSSetViewports(2, viewports);
+
+  GameOverlay::d3d11_state_block stateBlock;
+  stateBlock.Capture(context_.Get());
+  BindOverlay(overlayTarget.Get());
+  stateBlock.Restore(context_.Get());
+
+  ID3D11RenderTargetView* restoredTargets[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT] = {};
+  context_->OMGetRenderTargets(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT, restoredTargets, nullptr);
+  for (const auto target : restoredTargets) {
+    EXPECT_EQ(nullptr, target);
+  }
+  Release(restoredTargets);
+
+  UINT viewportCount = D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE;
+  D3D11_VIEWPORT restoredViewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+  context_->RSGetViewports(&viewportCount, restoredViewports);
+  ASSERT_EQ(2u, viewportCount);
+  EXPECT_EQ(8.0f, restoredViewports[1].TopLeftX);
+}
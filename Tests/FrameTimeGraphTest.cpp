@@ -0,0 +1,171 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "Rendering/FrameTimeGraph.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+struct ScreenPoint {
+  float x;
+  float frameTime;
+};
+
+// Points of all chunks from the newest to the oldest sample, without the duplicated points
+// at the chunk borders.
+std::vector<ScreenPoint> ScreenPoints(const FrameTimeGraph& graph)
+{
+  std::vector<ScreenPoint> points;
+  const auto& chunks = graph.GetChunks();
+  for (auto chunk = chunks.rbegin(); chunk != chunks.rend(); ++chunk) {
+    const size_t first = chunk + 1 != chunks.rend() ? 1 : 0;
+    for (size_t i = chunk->points.size(); i > first; --i) {
+      const auto& point = chunk->points[i - 1];
+      points.push_back({graph.GetOffset(*chunk) - point.x, point.y});
+    }
+  }
+  return points;
+}
+
+}  // namespace
+
+TEST(FrameTimeGraphTest, SpacesSamplesByTheOlderFrameTime)
+{
+  FrameTimeGraph graph(0.2f, 64);
+  graph.Add(10.0f);
+  graph.Add(20.0f);
+  graph.Add(30.0f);
+
+  const auto points = ScreenPoints(graph);
+  ASSERT_EQ(3u, points.size());
+  EXPECT_FLOAT_EQ(0.0f, points[0].x);
+  EXPECT_FLOAT_EQ(30.0f, points[0].frameTime);
+  EXPECT_FLOAT_EQ(4.0f, points[1].x);
+  EXPECT_FLOAT_EQ(6.0f, points[2].x);
+  EXPECT_FLOAT_EQ(10.0f, points[2].frameTime);
+}
+
+TEST(FrameTimeGraphTest, FullChunksDoNotChange)
+{
+  FrameTimeGraph graph(1.0f, 4);
+  for (int i = 1; i <= 4; ++i) {
+    graph.Add(static_cast<float>(i));
+  }
+  ASSERT_EQ(1u, graph.GetChunks().size());
+  const auto full = graph.GetChunks().front();
+
+  for (int i = 5; i <= 10; ++i) {
+    graph.Add(static_cast<float>(i));
+  }
+  const auto& chunks = graph.GetChunks();
+  ASSERT_EQ(3u, chunks.size());
+  ASSERT_EQ(full.points.size(), chunks[0].points.size());
+  EXPECT_EQ(full.id, chunks[0].id);
+  for (size_t i = 0; i < full.points.size(); ++i) {
+    EXPECT_EQ(full.points[i].x, chunks[0].points[i].x);
+    EXPECT_EQ(full.points[i].y, chunks[0].points[i].y);
+  }
+
+  // every chunk continues the line of the previous one
+  EXPECT_LT(chunks[0].id, chunks[1].id);
+  EXPECT_LT(chunks[1].id, chunks[2].id);
+  for (size_t i = 1; i < chunks.size(); ++i) {
+    const auto& last = chunks[i - 1].points.back();
+    const auto& first = chunks[i].points.front();
+    EXPECT_FLOAT_EQ(graph.GetOffset(chunks[i - 1]) - last.x, graph.GetOffset(chunks[i]) - first.x);
+    EXPECT_EQ(last.y, first.y);
+  }
+  EXPECT_EQ(10u, ScreenPoints(graph).size());
+}
+
+TEST(FrameTimeGraphTest, UnfilledSamplesRestartTheLine)
+{
+  FrameTimeGraph graph(0.2f, 4);
+  for (int i = 0; i < 10; ++i) {
+    graph.Add(16.0f);
+  }
+  graph.Add(0.0f);
+  EXPECT_TRUE(graph.GetChunks().empty());
+
+  graph.Add(8.0f);
+  const auto points = ScreenPoints(graph);
+  ASSERT_EQ(1u, points.size());
+  EXPECT_FLOAT_EQ(0.0f, points[0].x);
+}
+
+TEST(FrameTimeGraphTest, TrimKeepsTheLineUpToTheWidth)
+{
+  FrameTimeGraph graph(1.0f, 8);
+  for (int i = 0; i < 100; ++i) {
+    graph.Add(2.0f);
+  }
+  graph.Trim(31.0f);
+
+  const auto points = ScreenPoints(graph);
+  ASSERT_FALSE(points.empty());
+  // the line reaches the border, no chunk is entirely behind it
+  EXPECT_GT(points.back().x, 31.0f);
+  const auto& front = graph.GetChunks().front();
+  EXPECT_LE(graph.GetOffset(front) - front.points.back().x, 31.0f);
+}
+
+// The chunks draw the same polyline as the previous renderer, which walked the frame time
+// history from the newest sample until it passed the right border.
+TEST(FrameTimeGraphTest, MatchesFullRebuild)
+{
+  const float scale = 0.2f;
+  const float width = 300.0f;
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> distribution(1.0f, 40.0f);
+
+  FrameTimeGraph graph(scale, 64);
+  std::vector<float> history;
+  for (int frame = 0; frame < 2000; ++frame) {
+    history.push_back(distribution(random));
+    graph.Add(history.back());
+    if (frame % 7 == 0) {
+      graph.Trim(width);
+    }
+  }
+  graph.Trim(width);
+
+  std::vector<ScreenPoint> expected;
+  float x = 0.0f;
+  for (size_t i = history.size(); i > 0; --i) {
+    expected.push_back({x, history[i - 1]});
+    if (x > width) {
+      break;
+    }
+    x += history[i - 2] * scale;
+  }
+
+  const auto points = ScreenPoints(graph);
+  ASSERT_GE(points.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_NEAR(expected[i].x, points[i].x, 1e-3f) << i;
+    EXPECT_EQ(expected[i].frameTime, points[i].frameTime) << i;
+  }
+}
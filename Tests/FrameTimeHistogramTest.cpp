@@ -0,0 +1,222 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "Recording/FrameTimeHistogram.hpp"
+#include "Recording/PerformanceCounter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using GameOverlay::FrameTimeHistogram;
+using GameOverlay::PerformanceCounter;
+
+namespace {
+
+// A bucket center is within half the bucket width of 2^(1/32) of every frame time in it.
+const double bucketTolerance = 0.02;
+
+// Percentile of the frame times as defined by the histogram, the frame at rank
+// ceil(percentile * count).
+double SortedPercentile(std::vector<double> frameTimes, double percentile)
+{
+  std::sort(frameTimes.begin(), frameTimes.end());
+  const auto rank = static_cast<size_t>(std::ceil(percentile * frameTimes.size()));
+  return frameTimes[std::max<size_t>(rank, 1) - 1];
+}
+
+std::vector<double> RandomFrameTimes(size_t count, unsigned int seed)
+{
+  // mostly around 16 ms with a long tail of stutters
+  std::mt19937 random(seed);
+  std::lognormal_distribution<double> distribution(std::log(16.0), 0.35);
+  std::vector<double> frameTimes(count);
+  for (auto& frameTime : frameTimes) {
+    frameTime = distribution(random);
+  }
+  return frameTimes;
+}
+
+using Clock = std::chrono::high_resolution_clock;
+
+Clock::duration Milliseconds(double milliseconds)
+{
+  return std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double, std::milli>(milliseconds));
+}
+
+// Presents the frames after a first one right away, then one long enough to refresh the frame
+// info with every frame in the window.
+PerformanceCounter::FrameInfo Present(PerformanceCounter& counter, int frameCount,
+                                      double frameTime)
+{
+  auto time = Clock::now();
+  counter.NextFrame(time);
+  for (int i = 2; i < frameCount; ++i) {
+    time += Milliseconds(frameTime);
+    const auto& frameInfo = counter.NextFrame(time);
+    EXPECT_EQ(frameInfo.fps, 0) << "refreshed after " << i << " frames";
+  }
+  time += Milliseconds(1000.0);
+  return counter.NextFrame(time);
+}
+
+}  // namespace
+
+TEST(FrameTimeHistogramTest, EmptyHistogram)
+{
+  FrameTimeHistogram histogram;
+  EXPECT_EQ(histogram.GetCount(), 0u);
+  EXPECT_EQ(histogram.GetPercentile(0.99), 0.0);
+}
+
+TEST(FrameTimeHistogramTest, PercentilesMatchSortedFrameTimes)
+{
+  const auto frameTimes = RandomFrameTimes(10000, 1);
+  FrameTimeHistogram histogram;
+  for (double frameTime : frameTimes) {
+    histogram.Add(frameTime);
+  }
+  ASSERT_EQ(histogram.GetCount(), frameTimes.size());
+
+  for (double percentile : {0.0, 0.5, 0.99, 0.999, 1.0}) {
+    const double expected = SortedPercentile(frameTimes, percentile);
+    EXPECT_NEAR(histogram.GetPercentile(percentile), expected, expected * bucketTolerance)
+        << "percentile " << percentile;
+  }
+}
+
+TEST(FrameTimeHistogramTest, FrameTimesOutsideTheBucketsAreClamped)
+{
+  FrameTimeHistogram histogram;
+  histogram.Add(0.0);
+  histogram.Add(-1.0);
+  histogram.Add(60000.0);
+  EXPECT_EQ(histogram.GetCount(), 3u);
+  EXPECT_NEAR(histogram.GetPercentile(0.5), 0.05, 0.05 * bucketTolerance);
+  EXPECT_NEAR(histogram.GetPercentile(1.0), 3200.0, 3200.0 * bucketTolerance);
+}
+
+TEST(FrameTimeHistogramTest, WindowEvictsOldestFrame)
+{
+  FrameTimeHistogram histogram(4);
+  for (int i = 0; i < 4; ++i) {
+    histogram.Add(10.0);
+  }
+  EXPECT_EQ(histogram.GetCount(), 4u);
+
+  histogram.Add(40.0);
+  histogram.Add(40.0);
+  histogram.Add(40.0);
+  EXPECT_EQ(histogram.GetCount(), 4u);
+  EXPECT_NEAR(histogram.GetPercentile(0.25), 10.0, 10.0 * bucketTolerance);
+  EXPECT_NEAR(histogram.GetPercentile(0.5), 40.0, 40.0 * bucketTolerance);
+
+  histogram.Add(40.0);
+  EXPECT_NEAR(histogram.GetPercentile(0.0), 40.0, 40.0 * bucketTolerance);
+}
+
+TEST(FrameTimeHistogramTest, WindowPercentilesMatchRecentFrameTimes)
+{
+  const size_t windowSize = 1000;
+  auto frameTimes = RandomFrameTimes(2500, 2);
+  // a slower section which has to leave the window again
+  for (size_t i = 200; i < 1200; ++i) {
+    frameTimes[i] *= 3.0;
+  }
+
+  FrameTimeHistogram histogram(windowSize);
+  for (double frameTime : frameTimes) {
+    histogram.Add(frameTime);
+  }
+  ASSERT_EQ(histogram.GetCount(), windowSize);
+
+  const std::vector<double> recent(frameTimes.end() - windowSize, frameTimes.end());
+  for (double percentile : {0.99, 0.999}) {
+    const double expected = SortedPercentile(recent, percentile);
+    EXPECT_NEAR(histogram.GetPercentile(percentile), expected, expected * bucketTolerance)
+        << "percentile " << percentile;
+  }
+}
+
+TEST(FrameTimeHistogramTest, ClearDropsAllFrames)
+{
+  FrameTimeHistogram histogram(4);
+  for (int i = 0; i < 6; ++i) {
+    histogram.Add(10.0);
+  }
+  histogram.Clear();
+  EXPECT_EQ(histogram.GetCount(), 0u);
+  EXPECT_EQ(histogram.GetPercentile(0.5), 0.0);
+
+  // the window fills up again before frames are evicted
+  for (int i = 0; i < 4; ++i) {
+    histogram.Add(20.0);
+  }
+  EXPECT_EQ(histogram.GetCount(), 4u);
+  histogram.Add(80.0);
+  EXPECT_EQ(histogram.GetCount(), 4u);
+  EXPECT_NEAR(histogram.GetPercentile(0.75), 20.0, 20.0 * bucketTolerance);
+  EXPECT_NEAR(histogram.GetPercentile(1.0), 80.0, 80.0 * bucketTolerance);
+}
+
+TEST(FrameTimeHistogramTest, LowsNeedEnoughFrames)
+{
+  // no lows before the first refresh and with a single frame
+  PerformanceCounter single;
+  const auto firstFrame = single.NextFrame(Clock::now());
+  EXPECT_EQ(firstFrame.onePercentLowFPS, 0.0f);
+  EXPECT_EQ(firstFrame.pointOnePercentLowFPS, 0.0f);
+  const auto singleFrame = single.NextFrame(Clock::now() + Milliseconds(1000.0));
+  EXPECT_EQ(singleFrame.fps, 2);
+  EXPECT_EQ(singleFrame.onePercentLowFPS, 0.0f);
+  EXPECT_EQ(singleFrame.frameTimePercentile, 0.0f);
+  EXPECT_EQ(singleFrame.pointOnePercentLowFPS, 0.0f);
+
+  PerformanceCounter fewFrames;
+  const auto fewFramesInfo = Present(fewFrames, 99, 5.0);
+  EXPECT_EQ(fewFramesInfo.fps, 99);
+  EXPECT_EQ(fewFramesInfo.onePercentLowFPS, 0.0f);
+  EXPECT_EQ(fewFramesInfo.pointOnePercentLowFPS, 0.0f);
+
+  // the 99th of 100 frames is one of the 5 ms frames, the slowest is beyond it
+  PerformanceCounter onePercent;
+  const auto onePercentInfo = Present(onePercent, 100, 5.0);
+  EXPECT_EQ(onePercentInfo.fps, 100);
+  EXPECT_NEAR(onePercentInfo.frameTimePercentile, 5.0, 5.0 * bucketTolerance);
+  EXPECT_NEAR(onePercentInfo.onePercentLowFPS, 200.0, 200.0 * bucketTolerance);
+  EXPECT_EQ(onePercentInfo.pointOnePercentLowFPS, 0.0f);
+
+  PerformanceCounter belowPointOnePercent;
+  const auto belowInfo = Present(belowPointOnePercent, 999, 0.5);
+  EXPECT_GT(belowInfo.onePercentLowFPS, 0.0f);
+  EXPECT_EQ(belowInfo.pointOnePercentLowFPS, 0.0f);
+
+  PerformanceCounter pointOnePercent;
+  const auto pointOnePercentInfo = Present(pointOnePercent, 1000, 0.5);
+  EXPECT_NEAR(pointOnePercentInfo.onePercentLowFPS, 2000.0, 2000.0 * bucketTolerance);
+  EXPECT_NEAR(pointOnePercentInfo.pointOnePercentLowFPS, 2000.0, 2000.0 * bucketTolerance);
+}
@@ -0,0 +1,265 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "Rendering/GlyphAtlas.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+const float lineHeight = 10.0f;
+const int padding = 1;
+const int cellHeight = 10 + 2 * padding;
+
+// Coverage of every cell is a constant which tells the glyph and style apart.
+uint8_t GlyphCoverage(wchar_t character, GlyphAtlas::Style style)
+{
+  return static_cast<uint8_t>((character - L'a' + 1) * 10 +
+                              (style == GlyphAtlas::Style::Bold ? 100 : 0));
+}
+
+// Glyphs a to c with an advance of 4, 5 and 6 pixels.
+GlyphAtlas CreateAtlas(int size = 64)
+{
+  GlyphAtlas atlas(size, size, lineHeight, padding);
+  for (wchar_t character = L'a'; character <= L'c'; ++character) {
+    for (const auto style : {GlyphAtlas::Style::Regular, GlyphAtlas::Style::Bold}) {
+      const int advance = 4 + (character - L'a');
+      const int width = advance + 2 * padding;
+      std::vector<uint8_t> coverage(width * cellHeight, GlyphCoverage(character, style));
+      EXPECT_TRUE(atlas.AddGlyph(character, style, width, cellHeight,
+                                 static_cast<float>(advance), coverage.data(), width));
+    }
+  }
+  return atlas;
+}
+
+std::vector<GlyphAtlas::Quad> Layout(const GlyphAtlas& atlas, const std::wstring& text,
+                                     const GlyphAtlas::Rect& area,
+                                     const std::vector<GlyphAtlas::Range>& highlights = {},
+                                     GlyphAtlas::TextAlignment textAlignment =
+                                         GlyphAtlas::TextAlignment::Leading,
+                                     GlyphAtlas::ParagraphAlignment paragraphAlignment =
+                                         GlyphAtlas::ParagraphAlignment::Near)
+{
+  std::vector<GlyphAtlas::Quad> quads;
+  atlas.Layout(text, highlights, area, textAlignment, paragraphAlignment, 20.0f, quads);
+  return quads;
+}
+
+}  // namespace
+
+TEST(GlyphAtlasTest, PacksGlyphsIntoShelves)
+{
+  const auto atlas = CreateAtlas();
+  const auto a = atlas.FindGlyph(L'a', GlyphAtlas::Style::Regular);
+  const auto aBold = atlas.FindGlyph(L'a', GlyphAtlas::Style::Bold);
+  const auto b = atlas.FindGlyph(L'b', GlyphAtlas::Style::Regular);
+  ASSERT_TRUE(a && aBold && b);
+  EXPECT_EQ(0, a->x);
+  EXPECT_EQ(0, a->y);
+  // one pixel between the cells
+  EXPECT_EQ(a->width + 1, aBold->x);
+  EXPECT_EQ(aBold->x + aBold->width + 1, b->x);
+  EXPECT_EQ(nullptr, atlas.FindGlyph(L'd', GlyphAtlas::Style::Regular));
+
+  // 6 + 6 + 7 + 7 + 8 + 8 pixels and the gaps do not fit into one 32 pixel shelf
+  const auto small = CreateAtlas(32);
+  const auto c = small.FindGlyph(L'c', GlyphAtlas::Style::Regular);
+  ASSERT_TRUE(c);
+  EXPECT_EQ(0, c->x);
+  EXPECT_EQ(cellHeight + 1, c->y);
+}
+
+TEST(GlyphAtlasTest, AddGlyphFailsIfFull)
+{
+  GlyphAtlas atlas(8, 8, lineHeight, padding);
+  std::vector<uint8_t> coverage(8 * 8, 255);
+  EXPECT_FALSE(atlas.AddGlyph(L'a', GlyphAtlas::Style::Regular, 9, 4, 4.0f, coverage.data(), 9));
+  EXPECT_TRUE(atlas.AddGlyph(L'a', GlyphAtlas::Style::Regular, 8, 5, 4.0f, coverage.data(), 8));
+  EXPECT_FALSE(atlas.AddGlyph(L'b', GlyphAtlas::Style::Regular, 8, 5, 4.0f, coverage.data(), 8));
+  EXPECT_EQ(nullptr, atlas.FindGlyph(L'b', GlyphAtlas::Style::Regular));
+}
+
+TEST(GlyphAtlasTest, HasGlyphsIgnoresLineBreaksAndTabs)
+{
+  const auto atlas = CreateAtlas();
+  EXPECT_TRUE(atlas.HasGlyphs(L"abc\n\tcba"));
+  EXPECT_FALSE(atlas.HasGlyphs(L"abcd"));
+}
+
+TEST(GlyphAtlasTest, LayoutAdvancesAndBreaksLines)
+{
+  const auto atlas = CreateAtlas();
+  const auto quads = Layout(atlas, L"ab\n\tc", {10.0f, 20.0f, 110.0f, 120.0f});
+  ASSERT_EQ(3u, quads.size());
+  EXPECT_FLOAT_EQ(10.0f - padding, quads[0].dest.left);
+  EXPECT_FLOAT_EQ(20.0f - padding, quads[0].dest.top);
+  EXPECT_FLOAT_EQ(14.0f - padding, quads[1].dest.left);
+  // the tab advances to the first tab stop
+  EXPECT_FLOAT_EQ(30.0f - padding, quads[2].dest.left);
+  EXPECT_FLOAT_EQ(30.0f - padding, quads[2].dest.top);
+  for (const auto& quad : quads) {
+    EXPECT_FLOAT_EQ(quad.source.right - quad.source.left, quad.dest.right - quad.dest.left);
+    EXPECT_FLOAT_EQ(cellHeight, quad.dest.bottom - quad.dest.top);
+  }
+}
+
+TEST(GlyphAtlasTest, LayoutAlignsLinesAndParagraph)
+{
+  const auto atlas = CreateAtlas();
+  const GlyphAtlas::Rect area = {0.0f, 0.0f, 100.0f, 50.0f};
+  auto quads = Layout(atlas, L"ab", area, {}, GlyphAtlas::TextAlignment::Trailing,
+                      GlyphAtlas::ParagraphAlignment::Far);
+  ASSERT_EQ(2u, quads.size());
+  EXPECT_FLOAT_EQ(100.0f - 9.0f - padding, quads[0].dest.left);
+  EXPECT_FLOAT_EQ(40.0f - padding, quads[0].dest.top);
+
+  quads = Layout(atlas, L"ab", area, {}, GlyphAtlas::TextAlignment::Center,
+                 GlyphAtlas::ParagraphAlignment::Center);
+  ASSERT_EQ(2u, quads.size());
+  EXPECT_FLOAT_EQ(46.0f - padding, quads[0].dest.left);
+  EXPECT_FLOAT_EQ(20.0f - padding, quads[0].dest.top);
+}
+
+TEST(GlyphAtlasTest, LayoutUsesBoldGlyphsForHighlights)
+{
+  const auto atlas = CreateAtlas();
+  const auto quads = Layout(atlas, L"aaa", {0.0f, 0.0f, 100.0f, 100.0f}, {{1, 1}});
+  ASSERT_EQ(3u, quads.size());
+  EXPECT_FALSE(quads[0].highlight);
+  EXPECT_TRUE(quads[1].highlight);
+  EXPECT_FALSE(quads[2].highlight);
+  const auto bold = atlas.FindGlyph(L'a', GlyphAtlas::Style::Bold);
+  EXPECT_FLOAT_EQ(static_cast<float>(bold->x), quads[1].source.left);
+}
+
+TEST(GlyphAtlasTest, ComposeBlendsPremultipliedColors)
+{
+  const auto atlas = CreateAtlas();
+  const auto quads = Layout(atlas, L"ab", {1.0f, 1.0f, 100.0f, 100.0f}, {{1, 1}});
+  const int width = 16;
+  const int height = 16;
+  std::vector<uint32_t> image(width * height, 0);
+  atlas.Compose(quads, {0.0f, 0.0f, 100.0f, 100.0f}, 0xFFFFFFFF, 0xFF0000FF,
+                reinterpret_cast<uint8_t*>(image.data()), width * 4, width, height);
+
+  const uint32_t a = GlyphCoverage(L'a', GlyphAtlas::Style::Regular);
+  const uint32_t b = GlyphCoverage(L'b', GlyphAtlas::Style::Bold);
+  EXPECT_EQ((a << 24) | (a << 16) | (a << 8) | a, image[0]);
+  // the padding of b overlaps the last columns of a
+  const uint32_t blended = a * (255 - b) / 255;
+  EXPECT_EQ(((b + blended) << 24) | (blended << 16) | (blended << 8) | (b + blended),
+            image[width + 4]);
+  EXPECT_EQ((b << 24) | b, image[width + 6]);
+  EXPECT_EQ(0u, image[12 * width]);
+}
+
+TEST(GlyphAtlasTest, ComposeClipsToClipRectAndImage)
+{
+  const auto atlas = CreateAtlas();
+  const auto quads = Layout(atlas, L"cccccc", {-10.0f, -5.0f, 100.0f, 100.0f});
+  const int width = 20;
+  const int height = 20;
+  const GlyphAtlas::Rect clip = {2.0f, 3.0f, 12.5f, 40.0f};
+  std::vector<uint32_t> image(width * height, 0);
+  atlas.Compose(quads, clip, 0xFFFFFFFF, 0xFFFFFFFF, reinterpret_cast<uint8_t*>(image.data()),
+                width * 4, width, height);
+
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      // the text ends at y = 6, the clip at x = 12.5 excludes the pixel centered on it
+      const bool inside = x >= 2 && x < 12 && y >= 3 && y < 6;
+      EXPECT_EQ(inside, image[y * width + x] != 0) << x << ", " << y;
+    }
+  }
+}
+
+TEST(GlyphAtlasTest, ComposeRunsSplitsStylesAndLines)
+{
+  const auto atlas = CreateAtlas();
+  const GlyphAtlas::Rect area = {0.0f, 0.0f, 100.0f, 100.0f};
+  const auto quads = Layout(atlas, L"abcab\nc", area, {{3, 2}});
+  GlyphAtlas::RunMask mask;
+  atlas.ComposeRuns(quads, area, mask);
+
+  ASSERT_EQ(3u, mask.runs.size());
+  EXPECT_FALSE(mask.runs[0].highlight);
+  EXPECT_TRUE(mask.runs[1].highlight);
+  EXPECT_FALSE(mask.runs[2].highlight);
+  EXPECT_FLOAT_EQ(quads[3].dest.left, mask.runs[1].dest.left);
+  EXPECT_FLOAT_EQ(quads[4].dest.right, mask.runs[1].dest.right);
+  EXPECT_FLOAT_EQ(quads[5].dest.top, mask.runs[2].dest.top);
+  // the padding above the first line is clipped
+  EXPECT_EQ(3 * cellHeight - 2 * padding, mask.height);
+  EXPECT_EQ(static_cast<size_t>(mask.width) * mask.height, mask.pixels.size());
+
+  // every run matches its glyphs composed in white at its position
+  for (const auto& run : mask.runs) {
+    std::vector<GlyphAtlas::Quad> runQuads;
+    std::copy_if(quads.begin(), quads.end(), std::back_inserter(runQuads),
+                 [&](const GlyphAtlas::Quad& quad) {
+                   return quad.highlight == run.highlight &&
+                          std::max(quad.dest.top, area.top) == run.dest.top;
+                 });
+    std::vector<uint32_t> image(100 * 100, 0);
+    atlas.Compose(runQuads, area, 0xFFFFFFFF, 0xFFFFFFFF,
+                  reinterpret_cast<uint8_t*>(image.data()), 100 * 4, 100, 100);
+    EXPECT_FLOAT_EQ(run.source.right - run.source.left, run.dest.right - run.dest.left);
+    EXPECT_FLOAT_EQ(run.source.bottom - run.source.top, run.dest.bottom - run.dest.top);
+    for (int y = 0; y < run.source.bottom - run.source.top; ++y) {
+      for (int x = 0; x < run.source.right - run.source.left; ++x) {
+        const auto maskPixel =
+            mask.pixels[(static_cast<int>(run.source.top) + y) * mask.width + x];
+        const auto imagePixel = image[(static_cast<int>(run.dest.top) + y) * 100 +
+                                      static_cast<int>(run.dest.left) + x];
+        EXPECT_EQ(imagePixel, maskPixel) << x << ", " << y;
+      }
+    }
+  }
+}
+
+TEST(GlyphAtlasTest, ComposeRunsClipsToArea)
+{
+  const auto atlas = CreateAtlas();
+  const GlyphAtlas::Rect area = {5.0f, 5.0f, 20.0f, 12.0f};
+  const auto quads = Layout(atlas, L"ccccc\nccccc", area);
+  GlyphAtlas::RunMask mask;
+  atlas.ComposeRuns(quads, area, mask);
+
+  // the second line starts below the area
+  ASSERT_EQ(1u, mask.runs.size());
+  EXPECT_FLOAT_EQ(area.left, mask.runs[0].dest.left);
+  EXPECT_FLOAT_EQ(area.top, mask.runs[0].dest.top);
+  EXPECT_FLOAT_EQ(area.right, mask.runs[0].dest.right);
+  EXPECT_FLOAT_EQ(area.bottom, mask.runs[0].dest.bottom);
+  EXPECT_EQ(15, mask.width);
+  EXPECT_EQ(7, mask.height);
+
+  atlas.ComposeRuns(quads, {200.0f, 200.0f, 300.0f, 300.0f}, mask);
+  EXPECT_TRUE(mask.runs.empty());
+  EXPECT_TRUE(mask.pixels.empty());
+}
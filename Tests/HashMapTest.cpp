@@ -0,0 +1,219 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "HashMap.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+using Handle = std::uint64_t;
+
+class TestHashMap : public HashMap<Handle, std::uint64_t> {
+ public:
+  size_t GetCapacity() const { return table_.load()->capacity; }
+  size_t GetUsedSlots() const { return table_.load()->usedSlots; }
+  size_t GetRetiredTableCount()
+  {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    return retiredTables_.size() + gracePeriodTables_.size();
+  }
+};
+
+// non-dispatchable handles are aligned pointers on 64 bit platforms
+Handle MakeHandle(std::uint64_t index) { return (index + 1) * 16; }
+std::uint64_t MakeValue(Handle handle) { return handle * 3; }
+}  // namespace
+
+TEST(HashMap, AddGetRemove)
+{
+  TestHashMap map;
+  EXPECT_FALSE(map.Has(MakeHandle(0)));
+  EXPECT_EQ(map.Get(MakeHandle(0)), 0u);
+
+  for (std::uint64_t i = 0; i < 100; ++i) {
+    map.Add(MakeHandle(i), MakeValue(MakeHandle(i)));
+  }
+  // the first value is kept
+  map.Add(MakeHandle(0), 1);
+  EXPECT_EQ(map.GetSize(), 100u);
+
+  for (std::uint64_t i = 0; i < 100; i += 2) {
+    map.Remove(MakeHandle(i));
+  }
+  EXPECT_EQ(map.GetSize(), 50u);
+  for (std::uint64_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(map.Has(MakeHandle(i)), i % 2 == 1) << i;
+    EXPECT_EQ(map.Get(MakeHandle(i)), i % 2 == 1 ? MakeValue(MakeHandle(i)) : 0) << i;
+  }
+
+  EXPECT_EQ(map.FindKey_if([](const std::pair<Handle, std::uint64_t>& entry) {
+    return entry.second == MakeValue(MakeHandle(51));
+  }), MakeHandle(51));
+
+  map.RemoveKeys_if([](const std::pair<Handle, std::uint64_t>& entry) {
+    return entry.first < MakeHandle(50);
+  });
+  EXPECT_EQ(map.GetSize(), 25u);
+  EXPECT_FALSE(map.Has(MakeHandle(49)));
+  EXPECT_TRUE(map.Has(MakeHandle(51)));
+}
+
+TEST(HashMap, RemovedSlotsAreReused)
+{
+  TestHashMap map;
+  for (std::uint64_t i = 0; i < 4; ++i) {
+    map.Add(MakeHandle(i), MakeValue(MakeHandle(i)));
+  }
+  const size_t usedSlots = map.GetUsedSlots();
+
+  for (int round = 0; round < 1000; ++round) {
+    for (std::uint64_t i = 0; i < 4; ++i) {
+      map.Remove(MakeHandle(i));
+      map.Add(MakeHandle(i), MakeValue(MakeHandle(i)));
+    }
+  }
+  EXPECT_EQ(map.GetUsedSlots(), usedSlots);
+  EXPECT_EQ(map.GetSize(), 4u);
+}
+
+// Handles which are created and destroyed all the time must not grow the map.
+TEST(HashMap, ChurnKeepsMemoryBounded)
+{
+  TestHashMap map;
+  for (std::uint64_t i = 0; i < 100000; ++i) {
+    map.Add(MakeHandle(i), MakeValue(MakeHandle(i)));
+    if (i >= 4) {
+      map.Remove(MakeHandle(i - 4));
+    }
+    ASSERT_LE(map.GetCapacity(), 32u);
+    ASSERT_LE(map.GetRetiredTableCount(), 2u);
+  }
+  EXPECT_EQ(map.GetSize(), 4u);
+}
+
+TEST(HashMap, RetiredTablesAreDeletedWithoutReaders)
+{
+  TestHashMap map;
+  for (std::uint64_t i = 0; i < 1000; ++i) {
+    map.Add(MakeHandle(i), MakeValue(MakeHandle(i)));
+    EXPECT_LE(map.GetRetiredTableCount(), 1u);
+  }
+
+  map.Remove(MakeHandle(1000));
+  EXPECT_EQ(map.GetRetiredTableCount(), 0u);
+  for (std::uint64_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(map.Get(MakeHandle(i)), MakeValue(MakeHandle(i)));
+  }
+}
+
+// Readers look up handles while other threads create and destroy them, build the TSan variant to
+// check the table reclamation for races.
+TEST(HashMap, ConcurrentCreateDestroy)
+{
+  const std::uint64_t stableCount = 64;
+  const std::uint64_t handlesPerWriter = 256;
+  const int writerCount = 2;
+  const int readerCount = 4;
+  const int minRounds = 200;
+  // lookups which found a churned handle, the threads may not run in parallel
+  const int minChurnedLookups = 10000;
+
+  TestHashMap map;
+  for (std::uint64_t i = 0; i < stableCount; ++i) {
+    map.Add(MakeHandle(i), MakeValue(MakeHandle(i)));
+  }
+
+  std::atomic<bool> done{false};
+  std::atomic<int> errors{0};
+  std::atomic<int> readersStarted{0};
+  std::atomic<int> churnedLookups{0};
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < readerCount; ++r) {
+    readers.emplace_back([&, r]() {
+      std::uint64_t index = r;
+      readersStarted++;
+      while (!done.load()) {
+        const Handle stable = MakeHandle(index % stableCount);
+        if (map.Get(stable) != MakeValue(stable) || !map.Has(stable)) {
+          errors++;
+        }
+
+        // a churned handle may be destroyed while it is looked up, which Vulkan does not allow,
+        // and its slot reused by another one. The value still has to be one the map held.
+        const Handle churned =
+            MakeHandle(stableCount + index % (handlesPerWriter * writerCount));
+        const auto value = map.Get(churned);
+        if (value != 0) {
+          churnedLookups++;
+          const Handle owner = value / 3;
+          if (value != MakeValue(owner) || owner % 16 != 0 || owner < MakeHandle(stableCount) ||
+              owner >= MakeHandle(stableCount + handlesPerWriter * writerCount)) {
+            errors++;
+          }
+        }
+        index += 7;
+      }
+    });
+  }
+
+  std::vector<std::thread> writers;
+  for (int w = 0; w < writerCount; ++w) {
+    writers.emplace_back([&, w]() {
+      const std::uint64_t first = stableCount + w * handlesPerWriter;
+      while (readersStarted.load() != readerCount) {
+        std::this_thread::yield();
+      }
+      for (int round = 0; round < minRounds || churnedLookups.load() < minChurnedLookups;
+           ++round) {
+        for (std::uint64_t i = first; i < first + handlesPerWriter; ++i) {
+          map.Add(MakeHandle(i), MakeValue(MakeHandle(i)));
+        }
+        for (std::uint64_t i = first; i < first + handlesPerWriter; ++i) {
+          map.Remove(MakeHandle(i));
+        }
+      }
+    });
+  }
+
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(errors.load(), 0);
+  EXPECT_GE(churnedLookups.load(), minChurnedLookups);
+  EXPECT_EQ(map.GetSize(), stableCount);
+
+  // with the readers gone two writes delete every retired table
+  map.Remove(MakeHandle(~0ull >> 8));
+  map.Remove(MakeHandle(~0ull >> 8));
+  EXPECT_EQ(map.GetRetiredTableCount(), 0u);
+}
@@ -0,0 +1,162 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "LatencyHistogram.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+namespace {
+
+const uint32_t underflowBucket = 0;
+const uint32_t overflowBucket = LatencyHistogram::BUCKET_COUNT - 1;
+
+LatencyHistogram MakeHistogram(std::initializer_list<double> latencies)
+{
+  LatencyHistogram histogram;
+  for (double ms : latencies) {
+    histogram.Add(ms);
+  }
+  return histogram;
+}
+
+}  // namespace
+
+TEST(LatencyHistogramTest, BucketsAreContiguous)
+{
+  EXPECT_EQ(LatencyHistogram::GetBucketLowerBound(underflowBucket), 0.0);
+  EXPECT_EQ(LatencyHistogram::GetBucketUpperBound(underflowBucket), LatencyHistogram::MIN_MS);
+  EXPECT_EQ(LatencyHistogram::GetBucketLowerBound(overflowBucket), LatencyHistogram::MAX_MS);
+  EXPECT_EQ(LatencyHistogram::GetBucketUpperBound(overflowBucket), HUGE_VAL);
+
+  for (uint32_t bucket = 0; bucket < overflowBucket; ++bucket) {
+    const double lower = LatencyHistogram::GetBucketLowerBound(bucket);
+    const double upper = LatencyHistogram::GetBucketUpperBound(bucket);
+    ASSERT_LT(lower, upper) << "bucket " << bucket;
+    EXPECT_EQ(upper, LatencyHistogram::GetBucketLowerBound(bucket + 1)) << "bucket " << bucket;
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex((lower + upper) / 2.0), bucket)
+        << "bucket " << bucket;
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(std::nextafter(upper, 0.0)), bucket)
+        << "bucket " << bucket;
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(upper), bucket + 1) << "bucket " << bucket;
+  }
+}
+
+TEST(LatencyHistogramTest, OctavesStartNewBuckets)
+{
+  // powers of two are exact, so a value on an octave boundary belongs to the upper bucket
+  for (uint32_t octave = 0; octave < LatencyHistogram::OCTAVE_COUNT; ++octave) {
+    const uint32_t bucket = 1 + octave * LatencyHistogram::BUCKETS_PER_OCTAVE;
+    const double boundary = LatencyHistogram::MIN_MS * (1 << octave);
+    EXPECT_EQ(LatencyHistogram::GetBucketLowerBound(bucket), boundary);
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(boundary), bucket) << "octave " << octave;
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(std::nextafter(boundary, 0.0)), bucket - 1)
+        << "octave " << octave;
+  }
+}
+
+TEST(LatencyHistogramTest, UnderflowAndOverflowBuckets)
+{
+  EXPECT_EQ(LatencyHistogram::GetBucketIndex(0.0), underflowBucket);
+  EXPECT_EQ(LatencyHistogram::GetBucketIndex(LatencyHistogram::MIN_MS / 2.0), underflowBucket);
+  EXPECT_EQ(LatencyHistogram::GetBucketIndex(NAN), underflowBucket);
+  EXPECT_EQ(LatencyHistogram::GetBucketIndex(LatencyHistogram::MAX_MS), overflowBucket);
+  EXPECT_EQ(LatencyHistogram::GetBucketIndex(1e9), overflowBucket);
+  EXPECT_EQ(LatencyHistogram::GetBucketIndex(HUGE_VAL), overflowBucket);
+  EXPECT_EQ(LatencyHistogram::GetBucketIndex(std::nextafter(LatencyHistogram::MAX_MS, 0.0)),
+            overflowBucket - 1);
+
+  auto histogram = MakeHistogram({0.001, 10000.0, -1.0});
+  EXPECT_EQ(histogram.mTotalCount, 2u);
+  EXPECT_EQ(histogram.mCounts[underflowBucket], 1u);
+  EXPECT_EQ(histogram.mCounts[overflowBucket], 1u);
+  EXPECT_EQ(histogram.mMinMs, 0.001);
+  EXPECT_EQ(histogram.mMaxMs, 10000.0);
+  // the open buckets are bounded by the extremes
+  EXPECT_EQ(histogram.GetPercentile(0.0), 0.001);
+  EXPECT_EQ(histogram.GetPercentile(100.0), 10000.0);
+}
+
+TEST(LatencyHistogramTest, MergeAddsCountsAndExtremes)
+{
+  auto histogram = MakeHistogram({2.0, 3.0});
+  const auto other = MakeHistogram({1.0, 8.0, 8.0});
+  histogram.Merge(other);
+  histogram.Merge(LatencyHistogram());
+
+  const auto expected = MakeHistogram({2.0, 3.0, 1.0, 8.0, 8.0});
+  EXPECT_EQ(histogram.mTotalCount, 5u);
+  EXPECT_EQ(histogram.mSumMs, 22.0);
+  EXPECT_EQ(histogram.mMinMs, 1.0);
+  EXPECT_EQ(histogram.mMaxMs, 8.0);
+  for (uint32_t bucket = 0; bucket < LatencyHistogram::BUCKET_COUNT; ++bucket) {
+    EXPECT_EQ(histogram.mCounts[bucket], expected.mCounts[bucket]) << "bucket " << bucket;
+  }
+
+  // merging into an empty histogram takes over the extremes instead of starting at 0
+  LatencyHistogram empty;
+  empty.Merge(other);
+  EXPECT_EQ(empty.mMinMs, 1.0);
+  EXPECT_EQ(empty.mMaxMs, 8.0);
+  EXPECT_EQ(empty.GetMean(), 17.0 / 3.0);
+}
+
+TEST(LatencyHistogramTest, PercentileInterpolatesWithinBucket)
+{
+  EXPECT_EQ(LatencyHistogram().GetPercentile(50.0), 0.0);
+
+  // four values spread over the bucket [4, 4 * 2^(1/8))
+  const uint32_t bucket = LatencyHistogram::GetBucketIndex(4.0);
+  const double lower = LatencyHistogram::GetBucketLowerBound(bucket);
+  const double upper = LatencyHistogram::GetBucketUpperBound(bucket);
+  ASSERT_EQ(lower, 4.0);
+  LatencyHistogram histogram;
+  for (int i = 0; i < 4; ++i) {
+    histogram.Add(lower + (upper - lower) * (i + 0.5) / 4.0);
+  }
+  histogram.Add(lower);
+  histogram.Add(std::nextafter(upper, 0.0));
+  ASSERT_EQ(histogram.mCounts[bucket], 6u);
+
+  EXPECT_DOUBLE_EQ(histogram.GetPercentile(50.0), lower + (upper - lower) / 2.0);
+  EXPECT_DOUBLE_EQ(histogram.GetPercentile(25.0), lower + (upper - lower) / 4.0);
+}
+
+TEST(LatencyHistogramTest, PercentileIsClampedToExtremes)
+{
+  // both values fall into one bucket, interpolation stays between them
+  auto histogram = MakeHistogram({4.1, 4.2});
+  ASSERT_EQ(LatencyHistogram::GetBucketIndex(4.1), LatencyHistogram::GetBucketIndex(4.2));
+  EXPECT_EQ(histogram.GetPercentile(0.0), 4.1);
+  EXPECT_EQ(histogram.GetPercentile(100.0), 4.2);
+  EXPECT_DOUBLE_EQ(histogram.GetPercentile(50.0), 4.15);
+  EXPECT_EQ(histogram.GetPercentile(-10.0), 4.1);
+  EXPECT_EQ(histogram.GetPercentile(150.0), 4.2);
+
+  // the percentile in the last bucket ends at the maximum, not the bucket bound
+  histogram.Add(100.0);
+  EXPECT_EQ(histogram.GetPercentile(100.0), 100.0);
+  EXPECT_GE(histogram.GetPercentile(90.0), LatencyHistogram::GetBucketLowerBound(
+                                               LatencyHistogram::GetBucketIndex(100.0)));
+  EXPECT_LE(histogram.GetPercentile(90.0), 100.0);
+}
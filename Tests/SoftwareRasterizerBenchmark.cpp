@@ -0,0 +1,91 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+// Time of the software rasterizer primitives for overlay sized areas, built with the SSE2 spans
+// and as SoftwareRasterizerBenchmarkScalar with the scalar spans.
+// Usage: SoftwareRasterizerBenchmark [iterations]
+
+#include "Rendering/SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+template <typename Function>
+void Measure(const char* name, int iterations, Function function)
+{
+  const auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    function();
+  }
+  const auto end = std::chrono::high_resolution_clock::now();
+  const double microseconds = std::chrono::duration<double, std::micro>(end - start).count();
+  std::printf("%-12s %10.2f us\n", name, microseconds / iterations);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1000;
+
+  const int width = 512;
+  const int height = 256;
+  std::vector<uint32_t> pixels(width * height, 0x80202020);
+  SoftwareRasterizer rasterizer;
+  rasterizer.SetTarget(reinterpret_cast<uint8_t*>(pixels.data()), width * 4, width, height);
+
+  // 20 pixel glyphs with partial coverage, a line of 40 of them
+  const int glyphSize = 20;
+  GlyphAtlas atlas(64, 64, 20.0f, 0);
+  std::vector<uint8_t> coverage(glyphSize * glyphSize);
+  for (size_t i = 0; i < coverage.size(); ++i) {
+    coverage[i] = static_cast<uint8_t>(i % 5 == 0 ? 0 : (i * 29) % 256);
+  }
+  atlas.AddGlyph(L'a', GlyphAtlas::Style::Regular, glyphSize, glyphSize, 12.0f, coverage.data(),
+                 glyphSize);
+  std::vector<GlyphAtlas::Quad> quads;
+  for (int i = 0; i < 40; ++i) {
+    const float left = 10.0f + i * 12.0f;
+    quads.push_back({{0.0f, 0.0f, glyphSize, glyphSize}, {left, 10.0f, left + glyphSize, 30.0f},
+                     i % 4 == 0});
+  }
+
+  // frame time graph of 400 samples
+  std::vector<SoftwareRasterizer::Point> graph;
+  for (int i = 0; i < 400; ++i) {
+    graph.push_back({static_cast<float>(i), 200.0f - (i * 37 % 100)});
+  }
+
+  Measure("Clear", iterations, [&] { rasterizer.Clear(0x80000000); });
+  Measure("FillRect", iterations,
+          [&] { rasterizer.FillRect({0.0f, 0.0f, 500.0f, 250.0f}, 0x80402010); });
+  Measure("DrawGlyphs", iterations,
+          [&] { rasterizer.DrawGlyphs(atlas, quads, 0xFFFFFFFF, 0xFFFF8000); });
+  Measure("DrawPolyline", iterations,
+          [&] { rasterizer.DrawPolyline(graph.data(), graph.size(), 0xFFFFFFFF); });
+  return 0;
+}
@@ -0,0 +1,266 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+// Built twice, with the SSE2 spans and with SOFTWARE_RASTERIZER_SCALAR. Both builds have to
+// match the per pixel reference blend exactly.
+
+#include "Rendering/SoftwareRasterizer.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+uint32_t MulDiv255(uint32_t a, uint32_t b)
+{
+  return (a * b + 127) / 255;
+}
+
+// premultiplied source scaled by coverage over destination
+uint32_t ReferenceBlend(uint32_t destination, uint32_t color, uint32_t coverage)
+{
+  uint32_t source = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    source |= MulDiv255((color >> shift) & 0xFF, coverage) << shift;
+  }
+  const uint32_t inverseAlpha = 255 - (source >> 24);
+  uint32_t result = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    const uint32_t channel =
+        ((source >> shift) & 0xFF) + MulDiv255((destination >> shift) & 0xFF, inverseAlpha);
+    result |= std::min(channel, 255u) << shift;
+  }
+  return result;
+}
+
+class Target {
+ public:
+  Target(int width, int height, uint32_t value = 0)
+      : pixels_(static_cast<size_t>(width) * height, value), width_(width), height_(height)
+  {
+    rasterizer_.SetTarget(reinterpret_cast<uint8_t*>(pixels_.data()), width * 4, width, height);
+  }
+
+  SoftwareRasterizer& Rasterizer() { return rasterizer_; }
+  std::vector<uint32_t>& Pixels() { return pixels_; }
+
+  // One character per pixel, '#' for the color and '.' for zero.
+  std::string ToString(uint32_t color) const
+  {
+    std::string result;
+    for (int y = 0; y < height_; ++y) {
+      for (int x = 0; x < width_; ++x) {
+        const auto pixel = pixels_[y * width_ + x];
+        result += pixel == color ? '#' : pixel == 0 ? '.' : '?';
+      }
+      result += '\n';
+    }
+    return result;
+  }
+
+ private:
+  std::vector<uint32_t> pixels_;
+  int width_;
+  int height_;
+  SoftwareRasterizer rasterizer_;
+};
+
+const uint32_t white = 0xFFFFFFFF;
+
+std::string Golden(std::initializer_list<const char*> rows)
+{
+  std::string result;
+  for (const auto row : rows) {
+    result += row;
+    result += '\n';
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(SoftwareRasterizerTest, ToPixelPremultiplies)
+{
+  EXPECT_EQ(0xFFFF8000u, SoftwareRasterizer::ToPixel(1.0f, 0.5f, 0.0f, 1.0f));
+  EXPECT_EQ(0x80804000u, SoftwareRasterizer::ToPixel(1.0f, 0.5f, 0.0f, 0.5f));
+  EXPECT_EQ(0x00000000u, SoftwareRasterizer::ToPixel(1.0f, 1.0f, 1.0f, 0.0f));
+}
+
+// FillRect blends whole spans, every span length covers the vector loop and its tail.
+TEST(SoftwareRasterizerTest, FillRectMatchesReferenceBlend)
+{
+  std::mt19937 random(3);
+  for (const uint32_t alpha : {0u, 1u, 77u, 128u, 254u, 255u}) {
+    for (int width = 1; width <= 19; ++width) {
+      Target target(width, 1);
+      for (auto& pixel : target.Pixels()) {
+        pixel = random();
+        const uint32_t destinationAlpha = pixel >> 24;
+        // premultiplied destination, no channel above its alpha
+        for (int shift = 0; shift < 24; shift += 8) {
+          const uint32_t channel = std::min((pixel >> shift) & 0xFF, destinationAlpha);
+          pixel = (pixel & ~(0xFFu << shift)) | (channel << shift);
+        }
+      }
+      const auto destination = target.Pixels();
+      const uint32_t color = (alpha << 24) | (MulDiv255(alpha, 200) << 16) |
+                             (MulDiv255(alpha, 100) << 8) | MulDiv255(alpha, 30);
+
+      target.Rasterizer().FillRect({0.0f, 0.0f, static_cast<float>(width), 1.0f}, color);
+      for (int x = 0; x < width; ++x) {
+        EXPECT_EQ(ReferenceBlend(destination[x], color, 255), target.Pixels()[x])
+            << "alpha " << alpha << ", width " << width << ", x " << x;
+      }
+    }
+  }
+}
+
+// Glyphs blend their coverage mask, including fully transparent groups of four pixels.
+TEST(SoftwareRasterizerTest, DrawGlyphsMatchesReferenceBlend)
+{
+  const int size = 23;
+  GlyphAtlas atlas(32, 32, 20.0f, 0);
+  std::mt19937 random(5);
+  std::vector<uint8_t> coverage(size * size);
+  for (size_t i = 0; i < coverage.size(); ++i) {
+    coverage[i] = (i / 4) % 3 == 0 ? 0 : static_cast<uint8_t>(random());
+  }
+  ASSERT_TRUE(atlas.AddGlyph(L'a', GlyphAtlas::Style::Regular, size, size, size,
+                             coverage.data(), size));
+  const std::vector<GlyphAtlas::Quad> quads = {
+      {{0.0f, 0.0f, size, size}, {1.0f, 2.0f, size + 1.0f, size + 2.0f}, false},
+      {{0.0f, 0.0f, size, size}, {3.0f, 1.0f, size + 3.0f, size + 1.0f}, true}};
+
+  for (const uint32_t color : {0xFFFFFFFFu, 0x80402010u, 0x0F0F0F0Fu}) {
+    const int width = size + 4;
+    const int height = size + 3;
+    Target target(width, height, 0x40102030);
+    std::vector<uint32_t> expected = target.Pixels();
+    for (const auto& quad : quads) {
+      const uint32_t quadColor = quad.highlight ? 0xFF00FF00 : color;
+      for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+          auto& pixel = expected[(y + static_cast<int>(quad.dest.top)) * width + x +
+                                 static_cast<int>(quad.dest.left)];
+          if (coverage[y * size + x] != 0) {
+            pixel = ReferenceBlend(pixel, quadColor, coverage[y * size + x]);
+          }
+        }
+      }
+    }
+
+    target.Rasterizer().DrawGlyphs(atlas, quads, color, 0xFF00FF00);
+    EXPECT_EQ(expected, target.Pixels()) << std::hex << color;
+  }
+}
+
+TEST(SoftwareRasterizerTest, FillRectCoversPixelCentersInsideTheClip)
+{
+  Target target(8, 6);
+  auto& rasterizer = target.Rasterizer();
+  rasterizer.FillRect({0.4f, 0.6f, 5.5f, 3.0f}, white);
+  rasterizer.PushClip({2.0f, 3.0f, 6.5f, 100.0f});
+  rasterizer.FillRect({-10.0f, 3.6f, 100.0f, 4.6f}, white);
+  rasterizer.PopClip();
+  rasterizer.FillRect({7.0f, 5.0f, 20.0f, 20.0f}, white);
+  EXPECT_EQ(Golden({"........",
+                    "#####...",
+                    "#####...",
+                    "........",
+                    "..####..",
+                    ".......#"}),
+            target.ToString(white));
+}
+
+TEST(SoftwareRasterizerTest, ClearOnlyFillsTheClip)
+{
+  Target target(6, 4);
+  auto& rasterizer = target.Rasterizer();
+  rasterizer.PushClip({1.0f, 1.0f, 3.0f, 10.0f});
+  rasterizer.Clear(white);
+  rasterizer.PopClip();
+  EXPECT_EQ(Golden({"......",
+                    ".##...",
+                    ".##...",
+                    ".##..."}),
+            target.ToString(white));
+}
+
+TEST(SoftwareRasterizerTest, DrawLineSetsOnePixelPerMajorStep)
+{
+  Target target(8, 8);
+  auto& rasterizer = target.Rasterizer();
+  rasterizer.DrawLine({0.0f, 0.0f}, {8.0f, 8.0f}, white);
+  rasterizer.DrawLine({1.0f, 7.5f}, {6.0f, 7.5f}, white);
+  rasterizer.DrawLine({7.5f, 0.0f}, {7.2f, 4.0f}, white);
+  EXPECT_EQ(Golden({"#......#",
+                    ".#.....#",
+                    "..#....#",
+                    "...#...#",
+                    "....#...",
+                    ".....#..",
+                    "......#.",
+                    ".#####.#"}),
+            target.ToString(white));
+}
+
+TEST(SoftwareRasterizerTest, DrawLineIsClipped)
+{
+  Target target(8, 6);
+  auto& rasterizer = target.Rasterizer();
+  // partly outside of the target
+  rasterizer.DrawLine({-5.0f, 0.5f}, {20.0f, 0.5f}, white);
+  rasterizer.DrawLine({3.5f, -10.0f}, {3.5f, 2.0f}, white);
+  rasterizer.PushClip({2.0f, 2.0f, 6.0f, 5.0f});
+  rasterizer.DrawLine({0.0f, 3.5f}, {8.0f, 3.5f}, white);
+  rasterizer.DrawLine({0.0f, 0.0f}, {8.0f, 8.0f}, white);
+  rasterizer.PopClip();
+  // completely outside
+  rasterizer.DrawLine({-5.0f, 7.0f}, {20.0f, 9.0f}, white);
+  EXPECT_EQ(Golden({"########",
+                    "...#....",
+                    "..#.....",
+                    "..####..",
+                    "....#...",
+                    "........"}),
+            target.ToString(white));
+}
+
+// Connected lines exclude their end point, the joints are not blended twice.
+TEST(SoftwareRasterizerTest, PolylineBlendsJointsOnce)
+{
+  Target target(6, 6);
+  const uint32_t color = 0x80808080;
+  const SoftwareRasterizer::Point points[] = {{0.5f, 0.5f}, {4.5f, 0.5f}, {4.5f, 4.5f},
+                                              {0.5f, 4.5f}};
+  target.Rasterizer().DrawPolyline(points, 4, color);
+  EXPECT_EQ(Golden({"#####.",
+                    "....#.",
+                    "....#.",
+                    "....#.",
+                    ".####.",
+                    "......"}),
+            target.ToString(color));
+}
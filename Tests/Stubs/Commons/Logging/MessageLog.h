@@ -0,0 +1,40 @@
+// Stand-in for the message log of Commons, errors and warnings are written to stderr.
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+class MessageLog {
+ public:
+  void LogError(const std::string& category, const std::string& message,
+                unsigned long errorCode = 0)
+  {
+    Print("ERROR", category, message, errorCode);
+  }
+  void LogError(const std::string& category, const std::wstring& message,
+                unsigned long errorCode = 0)
+  {
+    Print("ERROR", category, std::string(message.begin(), message.end()), errorCode);
+  }
+  void LogWarning(const std::string& category, const std::string& message,
+                  unsigned long errorCode = 0)
+  {
+    Print("WARNING", category, message, errorCode);
+  }
+  void LogWarning(const std::string& category, const std::wstring& message,
+                  unsigned long errorCode = 0)
+  {
+    Print("WARNING", category, std::string(message.begin(), message.end()), errorCode);
+  }
+  void LogInfo(const std::string&, const std::string&, unsigned long = 0) {}
+  void LogVerbose(const std::string&, const std::string&, unsigned long = 0) {}
+
+ private:
+  static void Print(const char* level, const std::string& category, const std::string& message,
+                    unsigned long errorCode)
+  {
+    std::fprintf(stderr, "%s %s: %s %lu\n", level, category.c_str(), message.c_str(), errorCode);
+  }
+};
+
+extern MessageLog g_messageLog;
@@ -0,0 +1,9 @@
+// Stand-in for the capturing setup of Commons, the benchmarks neither log to a file nor capture.
+#pragma once
+
+#include <string>
+
+namespace GameOverlay {
+inline void InitLogging(const std::string&) {}
+inline void InitCapturing() {}
+}
@@ -0,0 +1,17 @@
+// Stand-in for the recording state of Commons with the settings read by the Vulkan layer.
+#pragma once
+
+class RecordingState {
+ public:
+  static RecordingState& GetInstance()
+  {
+    static RecordingState instance;
+    return instance;
+  }
+
+  void SetOverlayGpuTimestamps(bool enabled) { overlayGpuTimestamps_ = enabled; }
+  bool IsOverlayGpuTimestampsEnabled() { return overlayGpuTimestamps_; }
+
+ private:
+  bool overlayGpuTimestamps_ = false;
+};
@@ -0,0 +1,76 @@
+// Stand-in for the overlay bitmap of Commons, which rasterizes with Direct2D. It has the
+// interface used by the Vulkan layer, the benchmark that includes it defines the members.
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../Recording/RecordingState.h"
+#include "OverlayCostBudget.h"
+
+typedef unsigned int UINT;
+typedef uint64_t UINT64;
+
+struct WICRect {
+  int X;
+  int Y;
+  int Width;
+  int Height;
+};
+
+class OverlayBitmap final {
+ public:
+  OverlayBitmap(const OverlayBitmap&) = delete;
+  OverlayBitmap& operator=(const OverlayBitmap&) = delete;
+
+  struct RawData {
+    unsigned char* dataPtr = nullptr;
+    UINT size = 0;
+    UINT stride = 0;
+  };
+
+  struct Position {
+    int x;
+    int y;
+  };
+
+  enum class API {
+    DX11,
+    DX12,
+    Vulkan
+  };
+
+  OverlayBitmap();
+
+  bool Init(int screenWidth, int screenHeight, API api);
+  void Resize(int screenWidth, int screenHeight);
+  void DrawOverlay();
+
+  RawData GetBitmapDataRead();
+  void UnlockBitmapData();
+
+  int GetFullWidth() const;
+  int GetFullHeight() const;
+  Position GetScreenPos() const;
+  void GetDirtyRects(UINT64 drawCount, std::vector<WICRect>& rects) const;
+  UINT64 GetDrawCount() const;
+  VkFormat GetVKFormat() const;
+
+  bool GetLagIndicatorVisibility();
+
+  bool HideOverlay();
+
+  OverlayCostBudget& GetCostBudget();
+
+ private:
+  static const int dirtyHistorySize_ = 4;
+
+  std::vector<unsigned char> data_;
+  int width_ = 0;
+  int height_ = 0;
+  UINT64 drawCount_ = 0;
+  std::vector<WICRect> dirtyHistory_[dirtyHistorySize_];
+  OverlayCostBudget costBudget_;
+};
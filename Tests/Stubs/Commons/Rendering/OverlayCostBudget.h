@@ -0,0 +1,19 @@
+// Stand-in for the overlay cost budget of Commons, the benchmarks measure the present path
+// themselves.
+#pragma once
+
+class OverlayCostBudget final {
+ public:
+  OverlayCostBudget() {}
+  OverlayCostBudget(const OverlayCostBudget&) = delete;
+  OverlayCostBudget& operator=(const OverlayCostBudget&) = delete;
+
+  void AddGpuCost(float) {}
+};
+
+class OverlayCostScope final {
+ public:
+  explicit OverlayCostScope(OverlayCostBudget&) {}
+  OverlayCostScope(const OverlayCostScope&) = delete;
+  OverlayCostScope& operator=(const OverlayCostScope&) = delete;
+};
@@ -0,0 +1,4 @@
+// Stand-in for the Vulkan SDK header, the layer code under test needs nothing from it.
+#pragma once
+
+#include "vulkan.h"
@@ -0,0 +1,13 @@
+// Stand-in for the Vulkan SDK header with the types used by the layer code under test.
+#pragma once
+
+#include <cstdint>
+
+typedef void (*PFN_vkVoidFunction)(void);
+
+typedef struct VkQueue_T* VkQueue;
+typedef struct VkCommandBuffer_T* VkCommandBuffer;
+typedef struct VkCommandPool_T* VkCommandPool;
+typedef struct VkSemaphore_T* VkSemaphore;
+
+#define VK_NULL_HANDLE nullptr
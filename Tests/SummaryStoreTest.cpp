@@ -0,0 +1,276 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "../PresentMonInterface/SummaryStore.h"
+#include "Logging/MessageLog.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+MessageLog g_messageLog;
+
+namespace {
+
+// Files of a store in the temporary directory, removed before each test.
+class SummaryStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override
+  {
+    const std::string name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    prefix_ = ::testing::TempDir() + "SummaryStoreTest_" + name + "_";
+    directory_.assign(prefix_.begin(), prefix_.end());
+    std::remove(GetDataPath().c_str());
+    std::remove(GetIndexPath().c_str());
+  }
+
+  std::string GetDataPath() const { return prefix_ + "perf_summary.bin"; }
+  std::string GetIndexPath() const { return prefix_ + "perf_summary.idx"; }
+
+  static long long GetFileSize(const std::string& path)
+  {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file.is_open() ? static_cast<long long>(file.tellg()) : -1;
+  }
+
+  std::string prefix_;
+  std::wstring directory_;
+};
+
+SummaryRecord MakeRecord(int64_t timestamp, const std::string& application,
+                         const std::string& gpu)
+{
+  SummaryRecord record;
+  record.timestamp = timestamp;
+  record.file = "OCAT-" + application + ".csv";
+  record.application = application;
+  record.compositor = "DWM";
+  record.startTime = "2023-05-04T12:34:56";
+  record.frameStats.minimum = 4.5;
+  record.frameStats.maximum = 33.25;
+  record.frameStats.mean = 16.5;
+  record.frameStats.percentile99 = 30.0;
+  record.frameStats.percentile999 = -1.0;
+  record.avgFPS = 60.5;
+  record.avgFrameTime = 16.53;
+  record.appMissed = 3;
+  record.avgMissedFramesApp = 0.25;
+  record.appMaxConsecutiveMissed = 2;
+  record.warpMissed = 1;
+  record.avgMissedFramesCompositor = 0.5;
+  record.warpMaxConsecutiveMissed = 1;
+  record.avgEstimatedDriverLag = 1.75;
+  record.width = 2560;
+  record.height = 1440;
+  record.userNote = "note, with comma";
+  record.specs.motherboard = "Board";
+  record.specs.os = "Windows 10";
+  record.specs.cpu = "CPU";
+  record.specs.ram = "32 GB";
+  record.specs.driverVersionBasic = "23.5.1";
+  record.specs.driverVersionDetail = "31.0.21001";
+  if (!gpu.empty()) {
+    record.specs.gpus.push_back({gpu, 2500, 1250, 16384});
+    record.specs.gpus.push_back({"Integrated", 2200, -1, 512});
+  }
+  record.specs.gpuCount = static_cast<int>(record.specs.gpus.size());
+  return record;
+}
+
+std::vector<int64_t> Timestamps(const std::vector<SummaryRecord>& records)
+{
+  std::vector<int64_t> timestamps;
+  for (const auto& record : records) {
+    timestamps.push_back(record.timestamp);
+  }
+  return timestamps;
+}
+
+}  // namespace
+
+TEST_F(SummaryStoreTest, RecordsReadBackAsWritten)
+{
+  const SummaryRecord written = MakeRecord(1683200000, "Game.exe", "Radeon RX 7900 XTX");
+  {
+    SummaryStore store(directory_);
+    ASSERT_TRUE(store.Append(written));
+    ASSERT_TRUE(store.Append(MakeRecord(1683200100, "Other.exe", "")));
+  }
+
+  SummaryStore store(directory_);
+  const auto records = store.Query(SummaryQuery());
+  ASSERT_EQ(records.size(), 2u);
+  const SummaryRecord& read = records[0];
+  EXPECT_EQ(SummaryStore::FormatCsvLine(read), SummaryStore::FormatCsvLine(written));
+  EXPECT_EQ(read.timestamp, written.timestamp);
+  EXPECT_EQ(read.frameStats.mean, written.frameStats.mean);
+  EXPECT_EQ(read.frameStats.percentile999, -1.0);
+  EXPECT_EQ(read.specs.gpuCount, 2);
+  ASSERT_EQ(read.specs.gpus.size(), 2u);
+  EXPECT_EQ(read.specs.gpus[1].memoryClock, -1);
+
+  EXPECT_TRUE(records[1].specs.gpus.empty());
+  EXPECT_EQ(records[1].application, "Other.exe");
+}
+
+TEST_F(SummaryStoreTest, AppendsExtendTheLoadedIndex)
+{
+  SummaryStore store(directory_);
+  for (int64_t i = 0; i < 5; ++i) {
+    ASSERT_TRUE(store.Append(MakeRecord(100 + i, "Game.exe", "GPU")));
+  }
+  EXPECT_EQ(Timestamps(store.Query(SummaryQuery())),
+            (std::vector<int64_t>{100, 101, 102, 103, 104}));
+
+  // the index is written along with the records, a new store does not need to rebuild it
+  const long long indexSize = GetFileSize(GetIndexPath());
+  EXPECT_GT(indexSize, 0);
+  SummaryStore reopened(directory_);
+  EXPECT_EQ(reopened.Query(SummaryQuery()).size(), 5u);
+  EXPECT_EQ(GetFileSize(GetIndexPath()), indexSize);
+}
+
+TEST_F(SummaryStoreTest, RebuildsMissingAndStaleIndex)
+{
+  {
+    SummaryStore store(directory_);
+    for (int64_t i = 0; i < 3; ++i) {
+      ASSERT_TRUE(store.Append(MakeRecord(100 + i, "Game.exe", "GPU")));
+    }
+  }
+  const long long indexSize = GetFileSize(GetIndexPath());
+
+  // records appended while the index could not be updated
+  std::remove(GetIndexPath().c_str());
+  {
+    SummaryStore store(directory_);
+    EXPECT_EQ(Timestamps(store.Query(SummaryQuery())), (std::vector<int64_t>{100, 101, 102}));
+  }
+  EXPECT_EQ(GetFileSize(GetIndexPath()), indexSize);
+
+  // an index of an older state of the record file misses the last record
+  std::string index;
+  {
+    std::ifstream file(GetIndexPath(), std::ios::binary);
+    index.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  const size_t entrySize = (index.size() - 8) / 3;
+  {
+    std::ofstream file(GetIndexPath(), std::ios::binary | std::ios::trunc);
+    file.write(index.data(), index.size() - entrySize);
+  }
+  {
+    SummaryStore store(directory_);
+    ASSERT_TRUE(store.Append(MakeRecord(103, "Game.exe", "GPU")));
+    EXPECT_EQ(Timestamps(store.Query(SummaryQuery())),
+              (std::vector<int64_t>{100, 101, 102, 103}));
+  }
+
+  // an entry which does not match the record file drops it and all following ones
+  {
+    std::ifstream file(GetIndexPath(), std::ios::binary);
+    index.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  ASSERT_EQ(index.size(), 8 + 4 * entrySize);
+  // offset of the second entry
+  index[8 + entrySize + 8] ^= 0x40;
+  {
+    std::ofstream file(GetIndexPath(), std::ios::binary | std::ios::trunc);
+    file.write(index.data(), index.size());
+  }
+  SummaryStore store(directory_);
+  EXPECT_EQ(Timestamps(store.Query(SummaryQuery())), (std::vector<int64_t>{100, 101, 102, 103}));
+}
+
+TEST_F(SummaryStoreTest, IncompleteRecordIsNotIndexed)
+{
+  {
+    SummaryStore store(directory_);
+    ASSERT_TRUE(store.Append(MakeRecord(100, "Game.exe", "GPU")));
+  }
+  std::remove(GetIndexPath().c_str());
+  {
+    // size of a record which was not written completely
+    std::ofstream file(GetDataPath(), std::ios::binary | std::ios::app);
+    const uint32_t size = 1000;
+    file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    file.write("abc", 3);
+  }
+
+  SummaryStore store(directory_);
+  EXPECT_EQ(Timestamps(store.Query(SummaryQuery())), (std::vector<int64_t>{100}));
+}
+
+TEST_F(SummaryStoreTest, UnknownFormatIsNotAppendedTo)
+{
+  {
+    std::ofstream file(GetDataPath(), std::ios::binary);
+    file << "not a summary store";
+  }
+  const long long dataSize = GetFileSize(GetDataPath());
+
+  SummaryStore store(directory_);
+  EXPECT_FALSE(store.Append(MakeRecord(100, "Game.exe", "GPU")));
+  EXPECT_TRUE(store.Query(SummaryQuery()).empty());
+  EXPECT_EQ(GetFileSize(GetDataPath()), dataSize);
+}
+
+TEST_F(SummaryStoreTest, QueryFiltersByTimeApplicationAndGpu)
+{
+  SummaryStore store(directory_);
+  ASSERT_TRUE(store.Append(MakeRecord(100, "Game.exe", "Radeon")));
+  ASSERT_TRUE(store.Append(MakeRecord(200, "Other.exe", "Radeon")));
+  ASSERT_TRUE(store.Append(MakeRecord(300, "game.EXE", "GeForce")));
+  ASSERT_TRUE(store.Append(MakeRecord(400, "Game.exe", "")));
+
+  SummaryQuery query;
+  EXPECT_EQ(Timestamps(store.Query(query)), (std::vector<int64_t>{100, 200, 300, 400}));
+
+  // the time range includes both ends
+  query.fromTimestamp = 200;
+  query.toTimestamp = 300;
+  EXPECT_EQ(Timestamps(store.Query(query)), (std::vector<int64_t>{200, 300}));
+
+  // names are compared case insensitive
+  query = SummaryQuery();
+  query.application = "GAME.exe";
+  EXPECT_EQ(Timestamps(store.Query(query)), (std::vector<int64_t>{100, 300, 400}));
+
+  // the first GPU of a record is compared
+  query.gpu = "radeon";
+  EXPECT_EQ(Timestamps(store.Query(query)), (std::vector<int64_t>{100}));
+  query.application.clear();
+  EXPECT_EQ(Timestamps(store.Query(query)), (std::vector<int64_t>{100, 200}));
+  query.gpu = "Integrated";
+  EXPECT_TRUE(store.Query(query).empty());
+
+  query = SummaryQuery();
+  query.application = "Game";
+  EXPECT_TRUE(store.Query(query).empty());
+  query.application = "Game.exe";
+  query.fromTimestamp = 500;
+  EXPECT_TRUE(store.Query(query).empty());
+}
@@ -0,0 +1,113 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+// CPU time of finding the command state of a swapchain image on present, by swapchain image
+// count. Compares the queue family and image index lookup with the search by queue handle and
+// image index it replaced. The Vulkan calls of a present are not included.
+// Usage: SwapchainMappingBenchmark [iterations]
+
+#include "SwapchainQueueMapping.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// The queue mapping before the lookup was indexed, keyed by queue family but searched by queue.
+struct SearchedQueueMapping {
+  VkQueue queue;
+  std::vector<SwapchainImageMapping> imageMappings;
+};
+
+SwapchainImageMapping* Search(std::unordered_map<uint32_t, SearchedQueueMapping>& queueMappings,
+                              VkQueue queue, uint32_t imageIndex)
+{
+  for (auto& qm : queueMappings) {
+    if (qm.second.queue == queue) {
+      for (auto& im : qm.second.imageMappings) {
+        if (im.imageIndex == imageIndex) {
+          return &im;
+        }
+      }
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+template <typename Function>
+double Measure(int iterations, uint32_t imageCount, Function function)
+{
+  const auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    function(static_cast<uint32_t>(i) % imageCount);
+  }
+  const auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 10000000;
+
+  // the application presents from the last of three queue families
+  const uint32_t queueFamilyCount = 3;
+  const uint32_t presentFamily = queueFamilyCount - 1;
+  std::vector<VkQueue> queues;
+  for (uintptr_t i = 0; i < queueFamilyCount; ++i) {
+    queues.push_back(reinterpret_cast<VkQueue>((i + 1) * 64));
+  }
+
+  std::printf("%-8s %12s %12s\n", "images", "search ns", "indexed ns");
+  for (uint32_t imageCount : {2u, 3u, 4u, 8u}) {
+    std::unordered_map<uint32_t, SearchedQueueMapping> searched;
+    std::vector<SwapchainQueueMapping> indexed;
+    for (uint32_t family = 0; family < queueFamilyCount; ++family) {
+      SearchedQueueMapping& qm = searched[family];
+      qm.queue = queues[family];
+      for (uint32_t image = 0; image < imageCount; ++image) {
+        SwapchainImageMapping im;
+        im.imageIndex = image;
+        qm.imageMappings.push_back(im);
+        GetQueueMapping(indexed, family).GetImageMapping(image).imageIndex = image;
+      }
+    }
+
+    // keeps the lookups from being optimized out
+    volatile uint32_t sink = 0;
+    const double searchTime = Measure(iterations, imageCount, [&](uint32_t image) {
+      sink = Search(searched, queues[presentFamily], image)->imageIndex;
+    });
+    const double indexedTime = Measure(iterations, imageCount, [&](uint32_t image) {
+      sink = GetQueueMapping(indexed, presentFamily).GetImageMapping(image).imageIndex;
+    });
+    std::printf("%-8u %12.2f %12.2f\n", imageCount, searchTime, indexedTime);
+  }
+  return 0;
+}
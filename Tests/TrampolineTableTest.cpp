@@ -0,0 +1,198 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "trampoline_table.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+using address = trampoline_table::address;
+
+// function addresses are aligned
+address MakeReplacement(std::uintptr_t index)
+{
+  return reinterpret_cast<address>((index + 1) * 16);
+}
+address MakeTrampoline(address replacement, std::uintptr_t generation)
+{
+  return reinterpret_cast<address>(reinterpret_cast<std::uintptr_t>(replacement) * 1000 +
+                                   generation + 1);
+}
+std::uintptr_t GetGeneration(address replacement, address trampoline)
+{
+  return reinterpret_cast<std::uintptr_t>(trampoline) -
+         reinterpret_cast<std::uintptr_t>(replacement) * 1000 - 1;
+}
+}  // namespace
+
+TEST(TrampolineTable, LookupOfPublishedTrampolines)
+{
+  auto table = std::unique_ptr<trampoline_table>(new trampoline_table());
+  address trampoline = nullptr;
+  EXPECT_FALSE(table->lookup(MakeReplacement(0), trampoline));
+
+  for (std::uintptr_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(table->publish(MakeReplacement(i), MakeTrampoline(MakeReplacement(i), 0)));
+  }
+  for (std::uintptr_t i = 0; i < 100; ++i) {
+    ASSERT_TRUE(table->lookup(MakeReplacement(i), trampoline));
+    EXPECT_EQ(trampoline, MakeTrampoline(MakeReplacement(i), 0));
+  }
+  EXPECT_FALSE(table->lookup(MakeReplacement(100), trampoline));
+}
+
+// A replaced hook is appended to the list of hooks, the lookup keeps finding the first one.
+TEST(TrampolineTable, FirstTrampolineWinsUntilCleared)
+{
+  auto table = std::unique_ptr<trampoline_table>(new trampoline_table());
+  const address replacement = MakeReplacement(7);
+  address trampoline = nullptr;
+
+  table->publish(replacement, MakeTrampoline(replacement, 0));
+  table->publish(replacement, MakeTrampoline(replacement, 1));
+  ASSERT_TRUE(table->lookup(replacement, trampoline));
+  EXPECT_EQ(trampoline, MakeTrampoline(replacement, 0));
+
+  table->clear(replacement);
+  ASSERT_TRUE(table->lookup(replacement, trampoline));
+  EXPECT_EQ(trampoline, nullptr);
+
+  table->publish(replacement, MakeTrampoline(replacement, 2));
+  ASSERT_TRUE(table->lookup(replacement, trampoline));
+  EXPECT_EQ(trampoline, MakeTrampoline(replacement, 2));
+
+  // clearing a replacement which was never published does not add it
+  table->clear(MakeReplacement(8));
+  EXPECT_FALSE(table->lookup(MakeReplacement(8), trampoline));
+}
+
+TEST(TrampolineTable, PublishFailsWhenFull)
+{
+  auto table = std::unique_ptr<trampoline_table>(new trampoline_table());
+  for (std::uintptr_t i = 0; i < trampoline_table::size; ++i) {
+    ASSERT_TRUE(table->publish(MakeReplacement(i), MakeTrampoline(MakeReplacement(i), 0)));
+  }
+  EXPECT_FALSE(table->publish(MakeReplacement(trampoline_table::size), MakeReplacement(0)));
+
+  // already published replacements are still found
+  address trampoline = nullptr;
+  EXPECT_TRUE(table->publish(MakeReplacement(3), MakeTrampoline(MakeReplacement(3), 1)));
+  ASSERT_TRUE(table->lookup(MakeReplacement(3), trampoline));
+  EXPECT_EQ(trampoline, MakeTrampoline(MakeReplacement(3), 0));
+  EXPECT_FALSE(table->lookup(MakeReplacement(trampoline_table::size), trampoline));
+}
+
+// Hooked calls look up trampolines while hooks are installed and uninstalled, build the TSan
+// variant to check the publication for races.
+TEST(TrampolineTable, LookupDuringInstallUninstall)
+{
+  const std::uintptr_t hookCount = 256;
+  const int readerCount = 4;
+  const std::uintptr_t minGenerations = 300;
+  // lookups which found an installed trampoline, the threads may not run in parallel
+  const int minFoundLookups = 10000;
+
+  auto table = std::unique_ptr<trampoline_table>(new trampoline_table());
+  std::mutex writeMutex;
+  std::atomic<bool> done{false};
+  std::atomic<int> errors{0};
+  std::atomic<int> readersStarted{0};
+  std::atomic<int> foundLookups{0};
+  // generation the writer started and finished, odd generations install every hook
+  std::atomic<std::uintptr_t> startedGeneration{0};
+  std::atomic<std::uintptr_t> finishedGeneration{0};
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < readerCount; ++r) {
+    readers.emplace_back([&, r]() {
+      std::uintptr_t index = r;
+      std::vector<std::uintptr_t> lastGenerations(hookCount, 0);
+      readersStarted++;
+      while (!done.load()) {
+        const std::uintptr_t hook = index % hookCount;
+        const address replacement = MakeReplacement(hook);
+        const std::uintptr_t finished = finishedGeneration.load();
+        address trampoline = nullptr;
+        const bool found = table->lookup(replacement, trampoline) && trampoline != nullptr;
+        // without a write during the lookup it has to see the finished generation
+        const bool stable = startedGeneration.load() == finished;
+
+        if (found) {
+          foundLookups++;
+          const auto foundGeneration = GetGeneration(replacement, trampoline);
+          if ((foundGeneration & 1) != 1 || foundGeneration < lastGenerations[hook] ||
+              (stable && foundGeneration != finished)) {
+            errors++;
+          }
+          lastGenerations[hook] = foundGeneration;
+        }
+        else if (stable && (finished & 1) == 1) {
+          errors++;
+        }
+        index += 5;
+      }
+    });
+  }
+
+  std::thread writer([&]() {
+    while (readersStarted.load() != readerCount) {
+      std::this_thread::yield();
+    }
+    // ends after an uninstall
+    for (std::uintptr_t g = 1;
+         g <= minGenerations || foundLookups.load() < minFoundLookups || g % 2 == 0; ++g) {
+      {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        startedGeneration.store(g);
+        if (g % 2 == 1) {
+          // install every hook, reinstalling one keeps the first trampoline
+          for (std::uintptr_t i = 0; i < hookCount; ++i) {
+            table->publish(MakeReplacement(i), MakeTrampoline(MakeReplacement(i), g));
+            table->publish(MakeReplacement(i), MakeTrampoline(MakeReplacement(i), g + 1));
+          }
+        }
+        else {
+          for (std::uintptr_t i = 0; i < hookCount; ++i) {
+            table->clear(MakeReplacement(i));
+          }
+        }
+      }
+      finishedGeneration.store(g);
+    }
+  });
+
+  writer.join();
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(errors.load(), 0);
+  EXPECT_GE(foundLookups.load(), minFoundLookups);
+}
@@ -0,0 +1,641 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+// CPU time of the Vulkan layer's present path on a software Vulkan driver such as lavapipe, so
+// it can be measured without a GPU. The swapchain images are plain images in the present layout
+// and a present is emulated by a submission waiting for the semaphore the layer returns. Every
+// Vulkan call of the layer goes through a dispatch table that charges its time to a phase, the
+// rest of the present is charged to the layer itself. The overlay bitmap is a stand-in changing
+// the same regions per present as the real one, its time is reported but not part of the layer.
+// Usage: VulkanLayerBenchmark [presents] [timestamps]
+
+#include "AppResMapping.h"
+#include "Rendering.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+MessageLog g_messageLog;
+
+namespace {
+
+enum Phase {
+  Layer,
+  Bitmap,
+  Upload,
+  Record,
+  Submit,
+  Sync,
+  OtherVulkan,
+  PhaseCount
+};
+
+const char* const phaseNames[PhaseCount] = {
+    "layer",          "overlay bitmap stand-in", "bitmap upload",     "command recording",
+    "queue submit",   "fences and queries",      "other Vulkan calls"};
+
+// Time of each phase without the phases nested in it, nothing is charged outside of a phase.
+class PhaseClock {
+ public:
+  void Enter(Phase phase)
+  {
+    Charge();
+    stack_.push_back(phase);
+  }
+  void Leave()
+  {
+    Charge();
+    stack_.pop_back();
+  }
+  void Reset() { std::fill(std::begin(totals_), std::end(totals_), 0.0); }
+  double GetTotal(Phase phase) const { return totals_[phase]; }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  void Charge()
+  {
+    const auto now = Clock::now();
+    if (!stack_.empty()) {
+      totals_[stack_.back()] += std::chrono::duration<double, std::nano>(now - last_).count();
+    }
+    last_ = now;
+  }
+
+  std::vector<Phase> stack_;
+  Clock::time_point last_;
+  double totals_[PhaseCount] = {};
+};
+
+PhaseClock g_clock;
+
+struct PhaseScope {
+  explicit PhaseScope(Phase phase) { g_clock.Enter(phase); }
+  ~PhaseScope() { g_clock.Leave(); }
+};
+
+// Entry points of the driver, the layer calls them through the timed table.
+VkDevDispatchTable g_driver = {};
+
+template <typename Function>
+struct Timed;
+
+template <typename Result, typename... Args>
+struct Timed<Result(VKAPI_PTR*)(Args...)> {
+  using Function = Result(VKAPI_PTR*)(Args...);
+
+  template <Function VkDevDispatchTable::*driver, Phase phase>
+  static Result VKAPI_PTR Call(Args... args)
+  {
+    PhaseScope scope(phase);
+    return (g_driver.*driver)(args...);
+  }
+};
+
+#define LOAD_TIMED(name, phase)                                                         \
+  g_driver.name =                                                                       \
+      reinterpret_cast<decltype(g_driver.name)>(vkGetDeviceProcAddr(device, "vk" #name)); \
+  if (g_driver.name == nullptr) {                                                       \
+    std::fprintf(stderr, "vk" #name " not found\n");                                    \
+    return false;                                                                       \
+  }                                                                                     \
+  table.name = &Timed<decltype(g_driver.name)>::Call<&VkDevDispatchTable::name, phase>
+
+// The device functions the layer registers in its dispatch table.
+bool LoadDeviceTable(VkDevice device, VkDevDispatchTable& table)
+{
+  LOAD_TIMED(BeginCommandBuffer, Record);
+  LOAD_TIMED(EndCommandBuffer, Record);
+  LOAD_TIMED(ResetCommandBuffer, Record);
+  LOAD_TIMED(CmdBeginRenderPass, Record);
+  LOAD_TIMED(CmdBindPipeline, Record);
+  LOAD_TIMED(CmdBindDescriptorSets, Record);
+  LOAD_TIMED(CmdSetViewport, Record);
+  LOAD_TIMED(CmdDraw, Record);
+  LOAD_TIMED(CmdEndRenderPass, Record);
+  LOAD_TIMED(CmdPipelineBarrier, Record);
+  LOAD_TIMED(CmdDispatch, Record);
+  LOAD_TIMED(CmdCopyBuffer, Record);
+  LOAD_TIMED(CmdResetQueryPool, Record);
+  LOAD_TIMED(CmdWriteTimestamp, Record);
+
+  LOAD_TIMED(QueueSubmit, Submit);
+
+  LOAD_TIMED(WaitForFences, Sync);
+  LOAD_TIMED(GetFenceStatus, Sync);
+  LOAD_TIMED(ResetFences, Sync);
+  LOAD_TIMED(GetQueryPoolResults, Sync);
+
+  LOAD_TIMED(CreateBuffer, OtherVulkan);
+  LOAD_TIMED(DestroyBufferView, OtherVulkan);
+  LOAD_TIMED(DestroyBuffer, OtherVulkan);
+  LOAD_TIMED(FreeMemory, OtherVulkan);
+  LOAD_TIMED(DestroySemaphore, OtherVulkan);
+  LOAD_TIMED(DestroyFence, OtherVulkan);
+  LOAD_TIMED(DestroyRenderPass, OtherVulkan);
+  LOAD_TIMED(DestroyPipelineLayout, OtherVulkan);
+  LOAD_TIMED(DestroyPipeline, OtherVulkan);
+  LOAD_TIMED(DestroyCommandPool, OtherVulkan);
+  LOAD_TIMED(GetBufferMemoryRequirements, OtherVulkan);
+  LOAD_TIMED(AllocateMemory, OtherVulkan);
+  LOAD_TIMED(BindBufferMemory, OtherVulkan);
+  LOAD_TIMED(CreateBufferView, OtherVulkan);
+  LOAD_TIMED(CreateSemaphore, OtherVulkan);
+  LOAD_TIMED(CreateFence, OtherVulkan);
+  LOAD_TIMED(CreateRenderPass, OtherVulkan);
+  LOAD_TIMED(CreateImageView, OtherVulkan);
+  LOAD_TIMED(CreateFramebuffer, OtherVulkan);
+  LOAD_TIMED(CreateDescriptorPool, OtherVulkan);
+  LOAD_TIMED(CreateDescriptorSetLayout, OtherVulkan);
+  LOAD_TIMED(CreatePipelineLayout, OtherVulkan);
+  LOAD_TIMED(DestroyDescriptorSetLayout, OtherVulkan);
+  LOAD_TIMED(AllocateDescriptorSets, OtherVulkan);
+  LOAD_TIMED(UpdateDescriptorSets, OtherVulkan);
+  LOAD_TIMED(CreateComputePipelines, OtherVulkan);
+  LOAD_TIMED(DestroyShaderModule, OtherVulkan);
+  LOAD_TIMED(CreateGraphicsPipelines, OtherVulkan);
+  LOAD_TIMED(CreateCommandPool, OtherVulkan);
+  LOAD_TIMED(MapMemory, OtherVulkan);
+  LOAD_TIMED(UnmapMemory, OtherVulkan);
+  LOAD_TIMED(FlushMappedMemoryRanges, OtherVulkan);
+  LOAD_TIMED(FreeCommandBuffers, OtherVulkan);
+  LOAD_TIMED(AllocateCommandBuffers, OtherVulkan);
+  LOAD_TIMED(CreateShaderModule, OtherVulkan);
+  LOAD_TIMED(CreateQueryPool, OtherVulkan);
+  LOAD_TIMED(DestroyQueryPool, OtherVulkan);
+  LOAD_TIMED(DestroyImageView, OtherVulkan);
+  LOAD_TIMED(DestroyFramebuffer, OtherVulkan);
+  LOAD_TIMED(DestroyDescriptorPool, OtherVulkan);
+  return true;
+}
+
+#undef LOAD_TIMED
+
+// What the loader does for objects a layer creates without going through it.
+VkResult VKAPI_CALL SetDeviceLoaderData(VkDevice device, void* object)
+{
+  *static_cast<void**>(object) = *reinterpret_cast<void**>(device);
+  return VK_SUCCESS;
+}
+
+uint32_t FindMemoryType(const VkPhysicalDeviceMemoryProperties& properties, uint32_t typeBits)
+{
+  for (uint32_t i = 0; i < properties.memoryTypeCount; ++i) {
+    if ((typeBits & (1u << i)) &&
+        (properties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+      return i;
+    }
+  }
+  for (uint32_t i = 0; i < properties.memoryTypeCount; ++i) {
+    if (typeBits & (1u << i)) {
+      return i;
+    }
+  }
+  return UINT32_MAX;
+}
+
+struct Context {
+  VkInstance instance = VK_NULL_HANDLE;
+  VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+  VkPhysicalDeviceProperties properties = {};
+  VkDevice device = VK_NULL_HANDLE;
+  uint32_t queueFamilyIndex = 0;
+  VkQueue queue = VK_NULL_HANDLE;
+  std::vector<VkImage> images;
+  std::vector<VkDeviceMemory> imageMemory;
+  VkImageUsageFlags imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+};
+
+// Goes through the layer's instance and device hooks on the way, a CPU device is preferred.
+bool CreateDevice(Context& context, AppResMapping& appResources)
+{
+  VkApplicationInfo applicationInfo = {VK_STRUCTURE_TYPE_APPLICATION_INFO};
+  applicationInfo.pApplicationName = "VulkanLayerBenchmark";
+  applicationInfo.apiVersion = VK_API_VERSION_1_0;
+  VkInstanceCreateInfo instanceCreateInfo = {VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+  instanceCreateInfo.pApplicationInfo = &applicationInfo;
+  if (vkCreateInstance(&instanceCreateInfo, nullptr, &context.instance) != VK_SUCCESS) {
+    std::fprintf(stderr, "No Vulkan driver, install lavapipe or point VK_ICD_FILENAMES to one\n");
+    return false;
+  }
+  appResources.CreateInstance(context.instance, &instanceCreateInfo);
+
+  uint32_t physicalDeviceCount = 0;
+  vkEnumeratePhysicalDevices(context.instance, &physicalDeviceCount, nullptr);
+  std::vector<VkPhysicalDevice> physicalDevices(physicalDeviceCount);
+  vkEnumeratePhysicalDevices(context.instance, &physicalDeviceCount, physicalDevices.data());
+  if (physicalDeviceCount == 0) {
+    std::fprintf(stderr, "No Vulkan device\n");
+    return false;
+  }
+  VkInstDispatchTable instanceTable = {};
+  instanceTable.GetPhysicalDeviceMemoryProperties = vkGetPhysicalDeviceMemoryProperties;
+  instanceTable.GetPhysicalDeviceProperties = vkGetPhysicalDeviceProperties;
+  appResources.EnumeratePhysicalDevices(context.instance, &instanceTable, &physicalDeviceCount,
+                                        physicalDevices.data());
+
+  context.physicalDevice = physicalDevices[0];
+  for (auto physicalDevice : physicalDevices) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    if (properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU) {
+      context.physicalDevice = physicalDevice;
+      break;
+    }
+  }
+  vkGetPhysicalDeviceProperties(context.physicalDevice, &context.properties);
+
+  uint32_t queueFamilyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &queueFamilyCount, nullptr);
+  std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &queueFamilyCount,
+                                           queueFamilies.data());
+  appResources.GetPhysicalDeviceMapping(context.physicalDevice)
+      ->queueProperties.assign(queueFamilies.begin(), queueFamilies.end());
+  const auto graphicsFamily =
+      std::find_if(queueFamilies.begin(), queueFamilies.end(),
+                   [](const VkQueueFamilyProperties& family) {
+                     return (family.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+                   });
+  if (graphicsFamily == queueFamilies.end()) {
+    std::fprintf(stderr, "No graphics queue on %s\n", context.properties.deviceName);
+    return false;
+  }
+  context.queueFamilyIndex = static_cast<uint32_t>(graphicsFamily - queueFamilies.begin());
+
+  // the render pass of the layer uses the present layout
+  uint32_t extensionCount = 0;
+  vkEnumerateDeviceExtensionProperties(context.physicalDevice, nullptr, &extensionCount, nullptr);
+  std::vector<VkExtensionProperties> extensions(extensionCount);
+  vkEnumerateDeviceExtensionProperties(context.physicalDevice, nullptr, &extensionCount,
+                                       extensions.data());
+  if (std::none_of(extensions.begin(), extensions.end(), [](const VkExtensionProperties& e) {
+        return std::strcmp(e.extensionName, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0;
+      })) {
+    std::fprintf(stderr, "%s has no " VK_KHR_SWAPCHAIN_EXTENSION_NAME "\n",
+                 context.properties.deviceName);
+    return false;
+  }
+  const char* const extensionName = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+
+  const float queuePriority = 1.0f;
+  VkDeviceQueueCreateInfo queueCreateInfo = {VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
+  queueCreateInfo.queueFamilyIndex = context.queueFamilyIndex;
+  queueCreateInfo.queueCount = 1;
+  queueCreateInfo.pQueuePriorities = &queuePriority;
+  VkDeviceCreateInfo deviceCreateInfo = {VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+  deviceCreateInfo.queueCreateInfoCount = 1;
+  deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
+  deviceCreateInfo.enabledExtensionCount = 1;
+  deviceCreateInfo.ppEnabledExtensionNames = &extensionName;
+  if (vkCreateDevice(context.physicalDevice, &deviceCreateInfo, nullptr, &context.device) !=
+      VK_SUCCESS) {
+    std::fprintf(stderr, "Failed to create a device on %s\n", context.properties.deviceName);
+    return false;
+  }
+  appResources.CreateDevice(context.device, context.physicalDevice, &deviceCreateInfo);
+
+  vkGetDeviceQueue(context.device, context.queueFamilyIndex, 0, &context.queue);
+  appResources.GetDeviceQueue(context.queue, context.device, context.queueFamilyIndex, 0);
+  return true;
+}
+
+// Images in place of the swapchain's, in the present layout the layer expects. The storage
+// usage enables the compute path of the layer like its swapchain hook does.
+bool CreateSwapchainImages(Context& context, uint32_t imageCount, const VkExtent2D& extent,
+                           VkFormat format)
+{
+  VkFormatProperties formatProperties;
+  vkGetPhysicalDeviceFormatProperties(context.physicalDevice, format, &formatProperties);
+  if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) {
+    context.imageUsage |= VK_IMAGE_USAGE_STORAGE_BIT;
+  }
+
+  VkPhysicalDeviceMemoryProperties memoryProperties;
+  vkGetPhysicalDeviceMemoryProperties(context.physicalDevice, &memoryProperties);
+
+  VkImageCreateInfo imageCreateInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+  imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+  imageCreateInfo.format = format;
+  imageCreateInfo.extent = {extent.width, extent.height, 1};
+  imageCreateInfo.mipLevels = 1;
+  imageCreateInfo.arrayLayers = 1;
+  imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+  imageCreateInfo.usage = context.imageUsage;
+  imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  for (uint32_t i = 0; i < imageCount; ++i) {
+    VkImage image;
+    if (vkCreateImage(context.device, &imageCreateInfo, nullptr, &image) != VK_SUCCESS) {
+      return false;
+    }
+    context.images.push_back(image);
+
+    VkMemoryRequirements memoryRequirements;
+    vkGetImageMemoryRequirements(context.device, image, &memoryRequirements);
+    VkMemoryAllocateInfo allocateInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    allocateInfo.allocationSize = memoryRequirements.size;
+    allocateInfo.memoryTypeIndex =
+        FindMemoryType(memoryProperties, memoryRequirements.memoryTypeBits);
+    VkDeviceMemory memory;
+    if (vkAllocateMemory(context.device, &allocateInfo, nullptr, &memory) != VK_SUCCESS) {
+      return false;
+    }
+    context.imageMemory.push_back(memory);
+    if (vkBindImageMemory(context.device, image, memory, 0) != VK_SUCCESS) {
+      return false;
+    }
+  }
+
+  VkCommandPoolCreateInfo poolCreateInfo = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+  poolCreateInfo.queueFamilyIndex = context.queueFamilyIndex;
+  VkCommandPool commandPool;
+  if (vkCreateCommandPool(context.device, &poolCreateInfo, nullptr, &commandPool) != VK_SUCCESS) {
+    return false;
+  }
+  VkCommandBufferAllocateInfo allocateInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+  allocateInfo.commandPool = commandPool;
+  allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  allocateInfo.commandBufferCount = 1;
+  VkCommandBuffer commandBuffer;
+  vkAllocateCommandBuffers(context.device, &allocateInfo, &commandBuffer);
+
+  VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(commandBuffer, &beginInfo);
+  std::vector<VkImageMemoryBarrier> barriers;
+  for (auto image : context.images) {
+    VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    barriers.push_back(barrier);
+  }
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr,
+                       static_cast<uint32_t>(barriers.size()), barriers.data());
+  vkEndCommandBuffer(commandBuffer);
+
+  VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &commandBuffer;
+  const bool submitted = vkQueueSubmit(context.queue, 1, &submitInfo, VK_NULL_HANDLE) ==
+                         VK_SUCCESS && vkQueueWaitIdle(context.queue) == VK_SUCCESS;
+  vkDestroyCommandPool(context.device, commandPool, nullptr);
+  return submitted;
+}
+
+// What the layer's vkQueuePresentKHR does before it passes the present down the chain.
+VkSemaphore PresentThroughLayer(Rendering& rendering, const AppResMapping& appResources,
+                                VkDevDispatchTable* pTable, VkQueue queue,
+                                VkSwapchainKHR swapchain, uint32_t imageIndex,
+                                VkSemaphore waitSemaphore)
+{
+  if (rendering.HideOverlay()) {
+    return VK_NULL_HANDLE;
+  }
+
+  const auto* queueMapping = appResources.GetQueueMapping(queue);
+  const auto physicalDevice = appResources.GetDeviceMapping(queueMapping->device)->physicalDevice;
+  const auto& queueProperties = appResources.GetPhysicalDeviceMapping(physicalDevice)
+                                    ->queueProperties[queueMapping->queueFamilyIndex];
+
+  return rendering.OnPresent(pTable, SetDeviceLoaderData, queue, queueMapping->queueFamilyIndex,
+                             queueProperties.queueFlags, 1, &swapchain, &imageIndex, 1,
+                             &waitSemaphore, queueProperties.timestampValidBits);
+}
+
+}  // namespace
+
+// The overlay bitmap stand-in. Like the real bitmap it has the bar, the frame rate line and the
+// graph change on every present and keeps the dirty regions of the last few draws.
+OverlayBitmap::OverlayBitmap() {}
+
+bool OverlayBitmap::Init(int screenWidth, int screenHeight, API)
+{
+  Resize(screenWidth, screenHeight);
+  return true;
+}
+
+void OverlayBitmap::Resize(int, int screenHeight)
+{
+  width_ = 512;
+  height_ = screenHeight;
+  data_.assign(static_cast<size_t>(width_) * height_ * 4, 0);
+  drawCount_ = 0;
+}
+
+void OverlayBitmap::DrawOverlay()
+{
+  PhaseScope scope(Bitmap);
+  ++drawCount_;
+  auto& dirtyRects = dirtyHistory_[drawCount_ % dirtyHistorySize_];
+  dirtyRects = {{0, 0, 24, height_}, {24, 45, 256, 45}, {44, 90, 236, 135}};
+  for (auto& rect : dirtyRects) {
+    rect.Height = std::max(0, std::min(rect.Height, height_ - rect.Y));
+    for (int y = rect.Y; y < rect.Y + rect.Height; ++y) {
+      std::memset(&data_[(static_cast<size_t>(y) * width_ + rect.X) * 4],
+                  static_cast<int>(drawCount_ & 0xff), static_cast<size_t>(rect.Width) * 4);
+    }
+  }
+}
+
+OverlayBitmap::RawData OverlayBitmap::GetBitmapDataRead()
+{
+  // the layer copies from the bitmap until it is unlocked
+  g_clock.Enter(Upload);
+  RawData rawData;
+  rawData.dataPtr = data_.data();
+  rawData.size = static_cast<UINT>(data_.size());
+  rawData.stride = static_cast<UINT>(width_ * 4);
+  return rawData;
+}
+
+void OverlayBitmap::UnlockBitmapData() { g_clock.Leave(); }
+
+int OverlayBitmap::GetFullWidth() const { return width_; }
+
+int OverlayBitmap::GetFullHeight() const { return height_; }
+
+OverlayBitmap::Position OverlayBitmap::GetScreenPos() const { return {0, 0}; }
+
+void OverlayBitmap::GetDirtyRects(UINT64 drawCount, std::vector<WICRect>& rects) const
+{
+  PhaseScope scope(Bitmap);
+  rects.clear();
+  if (drawCount == drawCount_) {
+    return;
+  }
+
+  if (drawCount == 0 || drawCount > drawCount_ || drawCount_ - drawCount > dirtyHistorySize_) {
+    rects.push_back({0, 0, 280, height_});
+    return;
+  }
+
+  for (UINT64 i = drawCount + 1; i <= drawCount_; ++i) {
+    const auto& dirtyRects = dirtyHistory_[i % dirtyHistorySize_];
+    rects.insert(rects.end(), dirtyRects.begin(), dirtyRects.end());
+  }
+}
+
+UINT64 OverlayBitmap::GetDrawCount() const { return drawCount_; }
+
+VkFormat OverlayBitmap::GetVKFormat() const { return VK_FORMAT_B8G8R8A8_UNORM; }
+
+bool OverlayBitmap::GetLagIndicatorVisibility() { return false; }
+
+bool OverlayBitmap::HideOverlay() { return false; }
+
+OverlayCostBudget& OverlayBitmap::GetCostBudget() { return costBudget_; }
+
+int main(int argc, char** argv)
+{
+  const int presents = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1000;
+  const bool timestamps = argc > 2 && std::strcmp(argv[2], "timestamps") == 0;
+  RecordingState::GetInstance().SetOverlayGpuTimestamps(timestamps);
+
+  // every image is presented a few times before measuring, the layer creates its resources
+  // for an image on its first present
+  const uint32_t imageCount = 3;
+  const int warmUpPresents = 4 * imageCount;
+  const VkExtent2D extent = {1920, 1080};
+  const VkFormat format = VK_FORMAT_B8G8R8A8_UNORM;
+
+  Context context;
+  AppResMapping appResources;
+  VkDevDispatchTable table = {};
+  if (!CreateDevice(context, appResources) || !LoadDeviceTable(context.device, table) ||
+      !CreateSwapchainImages(context, imageCount, extent, format)) {
+    return 1;
+  }
+
+  // only a key of the layer's mappings
+  const VkSwapchainKHR swapchain = (VkSwapchainKHR)1;
+  const auto* physicalDeviceMapping = appResources.GetPhysicalDeviceMapping(context.physicalDevice);
+  std::unique_ptr<Rendering> rendering(new Rendering(L"" OCAT_VULKAN_SHADER_DIR));
+  rendering->OnCreateSwapchain(context.device, &table, physicalDeviceMapping->memoryProperties,
+                               swapchain, format, extent, context.imageUsage,
+                               physicalDeviceMapping->timestampPeriod);
+  rendering->OnGetSwapchainImages(&table, swapchain, imageCount, context.images.data());
+  if (!rendering->Initialized()) {
+    std::fprintf(stderr, "The layer failed to initialize, are the shaders in %s?\n",
+                 OCAT_VULKAN_SHADER_DIR);
+    return 1;
+  }
+
+  // per image the fence of its last present and the semaphore of the application's frame
+  std::vector<VkFence> presentFences(imageCount);
+  std::vector<VkSemaphore> frameSemaphores(imageCount);
+  for (uint32_t i = 0; i < imageCount; ++i) {
+    VkFenceCreateInfo fenceCreateInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+    fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    vkCreateFence(context.device, &fenceCreateInfo, nullptr, &presentFences[i]);
+    VkSemaphoreCreateInfo semaphoreCreateInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+    vkCreateSemaphore(context.device, &semaphoreCreateInfo, nullptr, &frameSemaphores[i]);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (int present = 0; present < warmUpPresents + presents; ++present) {
+    if (present == warmUpPresents) {
+      g_clock.Reset();
+      start = std::chrono::steady_clock::now();
+    }
+    const uint32_t imageIndex = static_cast<uint32_t>(present) % imageCount;
+
+    // acquire, the image is available again once its last present executed
+    vkWaitForFences(context.device, 1, &presentFences[imageIndex], VK_TRUE, UINT64_MAX);
+    vkResetFences(context.device, 1, &presentFences[imageIndex]);
+
+    VkSubmitInfo frameSubmitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    frameSubmitInfo.signalSemaphoreCount = 1;
+    frameSubmitInfo.pSignalSemaphores = &frameSemaphores[imageIndex];
+    vkQueueSubmit(context.queue, 1, &frameSubmitInfo, VK_NULL_HANDLE);
+
+    VkSemaphore overlaySemaphore;
+    {
+      PhaseScope scope(Layer);
+      overlaySemaphore = PresentThroughLayer(*rendering, appResources, &table, context.queue,
+                                             swapchain, imageIndex, frameSemaphores[imageIndex]);
+    }
+    if (overlaySemaphore == VK_NULL_HANDLE) {
+      std::fprintf(stderr, "The layer did not render the overlay of present %d\n", present);
+      return 1;
+    }
+
+    // the present waits for the overlay
+    const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    VkSubmitInfo presentSubmitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    presentSubmitInfo.waitSemaphoreCount = 1;
+    presentSubmitInfo.pWaitSemaphores = &overlaySemaphore;
+    presentSubmitInfo.pWaitDstStageMask = &waitStage;
+    vkQueueSubmit(context.queue, 1, &presentSubmitInfo, presentFences[imageIndex]);
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  std::printf("%s, %u images of %ux%u, %d presents%s\n", context.properties.deviceName,
+              imageCount, extent.width, extent.height, presents,
+              timestamps ? " with GPU timestamps" : "");
+  std::printf("%-28s %12s\n", "phase", "ns/present");
+  double layerTotal = 0.0;
+  for (int phase = 0; phase < PhaseCount; ++phase) {
+    if (phase == Bitmap) {
+      continue;
+    }
+    const double nsPerPresent = g_clock.GetTotal(static_cast<Phase>(phase)) / presents;
+    layerTotal += nsPerPresent;
+    std::printf("%-28s %12.0f\n", phaseNames[phase], nsPerPresent);
+  }
+  std::printf("%-28s %12.0f\n", "layer total", layerTotal);
+  std::printf("%-28s %12.0f\n", phaseNames[Bitmap], g_clock.GetTotal(Bitmap) / presents);
+  std::printf("%-28s %12.0f\n", "present loop",
+              std::chrono::duration<double, std::nano>(end - start).count() / presents);
+
+  vkDeviceWaitIdle(context.device);
+  rendering->OnDestroySwapchain(context.device, &table, swapchain);
+  rendering.reset();
+  for (uint32_t i = 0; i < imageCount; ++i) {
+    vkDestroyFence(context.device, presentFences[i], nullptr);
+    vkDestroySemaphore(context.device, frameSemaphores[i], nullptr);
+  }
+  for (auto image : context.images) {
+    vkDestroyImage(context.device, image, nullptr);
+  }
+  for (auto memory : context.imageMemory) {
+    vkFreeMemory(context.device, memory, nullptr);
+  }
+  appResources.DestroyDevice(context.device);
+  vkDestroyDevice(context.device, nullptr);
+  appResources.DestroyInstance(context.instance);
+  vkDestroyInstance(context.instance, nullptr);
+  return 0;
+}
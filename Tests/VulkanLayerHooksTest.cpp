@@ -0,0 +1,188 @@
+//
+// Copyright(c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Entry points of the layer referenced by the generated table, only their addresses are compared.
+#define LAYER_ENTRY_POINT(name) \
+  int name##Calls = 0;          \
+  void name() { ++name##Calls; }
+
+LAYER_ENTRY_POINT(vkGetInstanceProcAddr)
+LAYER_ENTRY_POINT(vkCreateInstance)
+LAYER_ENTRY_POINT(vkDestroyInstance)
+LAYER_ENTRY_POINT(vkEnumeratePhysicalDevices)
+LAYER_ENTRY_POINT(vkCreateDevice)
+LAYER_ENTRY_POINT(vkEnumerateDeviceLayerProperties)
+LAYER_ENTRY_POINT(vkEnumerateDeviceExtensionProperties)
+LAYER_ENTRY_POINT(vkGetPhysicalDeviceQueueFamilyProperties)
+LAYER_ENTRY_POINT(vkGetPhysicalDeviceQueueFamilyProperties2)
+LAYER_ENTRY_POINT(vkGetPhysicalDeviceQueueFamilyProperties2KHR)
+LAYER_ENTRY_POINT(vkGetDeviceProcAddr)
+LAYER_ENTRY_POINT(vkDestroyDevice)
+LAYER_ENTRY_POINT(vkGetDeviceQueue)
+LAYER_ENTRY_POINT(vkCreateSwapchainKHR)
+LAYER_ENTRY_POINT(vkDestroySwapchainKHR)
+LAYER_ENTRY_POINT(vkGetSwapchainImagesKHR)
+LAYER_ENTRY_POINT(vkQueuePresentKHR)
+
+#include "vk_layer_hooks.h"
+
+namespace {
+struct VulkanFunction {
+  const char* name;
+  PFN_vkVoidFunction ptr;
+};
+
+#define VULKAN_FUNCTION(name) {#name, reinterpret_cast<PFN_vkVoidFunction>(name)}
+
+// The tables vkGetInstanceProcAddr and vkGetDeviceProcAddr searched with strcmp before the
+// lookup was generated.
+const VulkanFunction hookedInstanceFunctions[] = {
+    VULKAN_FUNCTION(vkGetInstanceProcAddr),
+    VULKAN_FUNCTION(vkCreateInstance),
+    VULKAN_FUNCTION(vkDestroyInstance),
+    VULKAN_FUNCTION(vkEnumeratePhysicalDevices),
+    VULKAN_FUNCTION(vkCreateDevice),
+    VULKAN_FUNCTION(vkEnumerateDeviceLayerProperties),
+    VULKAN_FUNCTION(vkEnumerateDeviceExtensionProperties),
+    VULKAN_FUNCTION(vkGetPhysicalDeviceQueueFamilyProperties),
+    VULKAN_FUNCTION(vkGetPhysicalDeviceQueueFamilyProperties2),
+    VULKAN_FUNCTION(vkGetPhysicalDeviceQueueFamilyProperties2KHR)};
+
+const VulkanFunction hookedDeviceFunctions[] = {VULKAN_FUNCTION(vkGetDeviceProcAddr),
+                                                VULKAN_FUNCTION(vkDestroyDevice),
+                                                VULKAN_FUNCTION(vkGetDeviceQueue)};
+
+const VulkanFunction hookedKHRExtFunctions[] = {
+    VULKAN_FUNCTION(vkCreateSwapchainKHR), VULKAN_FUNCTION(vkDestroySwapchainKHR),
+    VULKAN_FUNCTION(vkGetSwapchainImagesKHR), VULKAN_FUNCTION(vkQueuePresentKHR)};
+
+template <size_t size>
+PFN_vkVoidFunction Find(const VulkanFunction (&functions)[size], const char* name)
+{
+  for (const auto& hf : functions) {
+    if (strcmp(name, hf.name) == 0) {
+      return hf.ptr;
+    }
+  }
+  return nullptr;
+}
+
+// vkGetDeviceProcAddr did not search the instance functions.
+PFN_vkVoidFunction FindInTables(const char* name, bool device)
+{
+  PFN_vkVoidFunction function = device ? nullptr : Find(hookedInstanceFunctions, name);
+  if (!function) {
+    function = Find(hookedDeviceFunctions, name);
+  }
+  if (!function) {
+    function = Find(hookedKHRExtFunctions, name);
+  }
+  return function;
+}
+
+// Every command and alias of the registry the table was generated from.
+std::vector<std::string> LoadRegistryCommands()
+{
+  std::vector<std::string> names;
+  std::ifstream file(VK_COMMAND_LIST);
+  std::string name;
+  while (std::getline(file, name)) {
+    if (!name.empty()) {
+      names.push_back(name);
+    }
+  }
+  return names;
+}
+
+void ExpectLikeTables(const std::string& name)
+{
+  EXPECT_EQ(FindInTables(name.c_str(), false), GetLayerHookFunction(name.c_str(), false))
+      << "vkGetInstanceProcAddr(" << name << ")";
+  EXPECT_EQ(FindInTables(name.c_str(), true), GetLayerHookFunction(name.c_str(), true))
+      << "vkGetDeviceProcAddr(" << name << ")";
+}
+}  // namespace
+
+TEST(VulkanLayerHooks, RegistryCommandsResolveLikeTheTables)
+{
+  const auto names = LoadRegistryCommands();
+  ASSERT_FALSE(names.empty()) << VK_COMMAND_LIST;
+
+  for (const auto& name : names) {
+    ExpectLikeTables(name);
+  }
+}
+
+TEST(VulkanLayerHooks, HookedCommandsAreInTheRegistry)
+{
+  const auto names = LoadRegistryCommands();
+  auto expectInRegistry = [&names](const VulkanFunction& hf) {
+    EXPECT_NE(std::find(names.begin(), names.end(), hf.name), names.end()) << hf.name;
+    EXPECT_NE(FindLayerHook(hf.name), nullptr) << hf.name;
+  };
+  for (const auto& hf : hookedInstanceFunctions) expectInRegistry(hf);
+  for (const auto& hf : hookedDeviceFunctions) expectInRegistry(hf);
+  for (const auto& hf : hookedKHRExtFunctions) expectInRegistry(hf);
+}
+
+TEST(VulkanLayerHooks, DeviceQueriesOnlyReturnDeviceCommands)
+{
+  for (const auto& hf : hookedInstanceFunctions) {
+    EXPECT_EQ(GetLayerHookFunction(hf.name, false), hf.ptr) << hf.name;
+    EXPECT_EQ(GetLayerHookFunction(hf.name, true), nullptr) << hf.name;
+  }
+  for (const auto& hf : hookedDeviceFunctions) {
+    EXPECT_EQ(GetLayerHookFunction(hf.name, false), hf.ptr) << hf.name;
+    EXPECT_EQ(GetLayerHookFunction(hf.name, true), hf.ptr) << hf.name;
+  }
+  for (const auto& hf : hookedKHRExtFunctions) {
+    EXPECT_EQ(GetLayerHookFunction(hf.name, false), hf.ptr) << hf.name;
+    EXPECT_EQ(GetLayerHookFunction(hf.name, true), hf.ptr) << hf.name;
+  }
+}
+
+// Names which share a slot with a hooked command must still be passed down the chain.
+TEST(VulkanLayerHooks, SimilarNamesAreNotIntercepted)
+{
+  std::vector<std::string> names = {"", "vk", "vkCreate", "VKCREATEINSTANCE", "vkcreateinstance"};
+  for (const auto& name : LoadRegistryCommands()) {
+    names.push_back(name.substr(0, name.size() - 1));
+    names.push_back(name + "X");
+    names.push_back(name + "KHR");
+    names.push_back(" " + name);
+    std::string changed = name;
+    changed[2] ^= 0x20;
+    names.push_back(changed);
+  }
+
+  for (const auto& name : names) {
+    ExpectLikeTables(name);
+  }
+}
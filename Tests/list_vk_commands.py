@@ -0,0 +1,19 @@
+#!/usr/bin/env python3
+
+# Writes the name of every command and command alias of a Vulkan registry, one per line.
+# $ ./list_vk_commands.py vk.xml commands.txt
+
+import sys
+import xml.etree.ElementTree as ET
+
+registry = ET.parse(sys.argv[1]).getroot()
+
+names = []
+for cmd in registry.findall('commands/command'):
+    if 'alias' in cmd.attrib:
+        names.append(cmd.attrib['name'])
+    else:
+        names.append(cmd.find('proto/name').text)
+
+with open(sys.argv[2], mode='w') as f:
+    f.write('\n'.join(names) + '\n')
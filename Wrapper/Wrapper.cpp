@@ -72,6 +72,54 @@ void Wrapper::PresentMonWrapper::UpdateUserNote(String ^ userNote)
   presentMonInterface_->UpdateUserNote(msclr::interop::marshal_as<std::wstring>(userNote));
 }
 
+// The summary store keeps names as UTF-8, marshal_as would convert to the ANSI code page.
+static std::string ConvertToUTF8(String ^ text)
+{
+  if (String::IsNullOrEmpty(text)) {
+    return std::string();
+  }
+  array<Byte> ^ bytes = Text::Encoding::UTF8->GetBytes(text);
+  pin_ptr<Byte> data = &bytes[0];
+  return std::string(reinterpret_cast<const char*>(data), bytes->Length);
+}
+
+static SummaryQuery CreateSummaryQuery(String ^ application, String ^ gpu, Int64 fromTimestamp,
+                                       Int64 toTimestamp)
+{
+  SummaryQuery query;
+  query.application = ConvertToUTF8(application);
+  query.gpu = ConvertToUTF8(gpu);
+  query.fromTimestamp = fromTimestamp;
+  query.toTimestamp = toTimestamp;
+  return query;
+}
+
+array<String ^> ^ Wrapper::PresentMonWrapper::QuerySummaries(String ^ application, String ^ gpu,
+                                                              Int64 fromTimestamp, Int64 toTimestamp)
+{
+  std::vector<SummaryRecord> records = presentMonInterface_->QuerySummaries(
+      CreateSummaryQuery(application, gpu, fromTimestamp, toTimestamp));
+  array<String ^> ^ lines = gcnew array<String ^>(static_cast<int>(records.size()));
+  for (int i = 0; i < lines->Length; i++) {
+    std::string line = SummaryStore::FormatCsvLine(records[i]);
+    lines[i] = gcnew String(line.c_str(), 0, static_cast<int>(line.size()),
+                            Text::Encoding::UTF8);
+  }
+  return lines;
+}
+
+bool Wrapper::PresentMonWrapper::ExportSummaries(String ^ filePath, String ^ application,
+                                                 String ^ gpu, Int64 fromTimestamp,
+                                                 Int64 toTimestamp)
+{
+  if (String::IsNullOrEmpty(filePath)) {
+    return false;
+  }
+  return presentMonInterface_->ExportSummaries(
+      msclr::interop::marshal_as<std::wstring>(filePath),
+      CreateSummaryQuery(application, gpu, fromTimestamp, toTimestamp));
+}
+
 Wrapper::OverlayWrapper::OverlayWrapper()
 {
   overlayInterface_ = new OverlayInterface();
@@ -47,6 +47,12 @@ ref class PresentMonWrapper {
   int GetPresentMonRecordingStopMessage();
   void UpdateOutputFolder(String ^ outputFolder);
   void UpdateUserNote(String ^ userNote);
+  // Summary rows in the layout of perf_summary.csv, empty filters match all recordings.
+  // Timestamps are seconds since epoch.
+  array<String ^> ^ QuerySummaries(String ^ application, String ^ gpu, Int64 fromTimestamp,
+                                   Int64 toTimestamp);
+  bool ExportSummaries(String ^ filePath, String ^ application, String ^ gpu, Int64 fromTimestamp,
+                       Int64 toTimestamp);
 };
 
 public